@@ -4,12 +4,16 @@
 
 #include "Video/VideoEncoder.h"
 #include "Video/Encoders/Configs/VideoEncoderConfigAMF.h"
+#include "Utils/PacketBufferPool.h"
+#include "Utils/PacketRing.h"
 
-#include "Containers/Queue.h"
 #include "HAL/Platform.h"
 
 #include "AMF.h"
 
+// Surface property carrying the caller's user data, AMF copies input surface properties onto the output buffer
+#define AMF_VIDEO_ENCODER_UE_USER_DATA L"UEUserData"
+
 template <typename TResource>
 class TVideoEncoderAMF : public TVideoEncoder<TResource, FVideoEncoderConfigAMF>
 {
@@ -19,7 +23,7 @@ private:
 
 	uint64 FrameCount = 0;
 
-	TQueue<FVideoPacket> Packets;
+	UE::AVCodecCore::TPacketRing<FVideoPacket> Packets;
 
 public:
 	amf::AMFContextPtr Context = nullptr;
@@ -37,10 +41,11 @@ public:
 
 	//int GetCapability(GUID EncodeGUID, NV_ENC_CAPS CapsToQuery) const;
 	
-	virtual FAVResult SendFrame(TSharedPtr<TResource> const& Resource, uint32 Timestamp, bool bForceKeyframe = false) override;
+	virtual FAVResult SendFrame(TSharedPtr<TResource> const& Resource, uint64 Timestamp, bool bForceKeyframe = false, uint64 UserData = 0) override;
 	FAVResult SendFrame(amf::AMFSurfacePtr Input, bool bShouldApplyConfig = true);
 
 	virtual FAVResult ReceivePacket(FVideoPacket& OutPacket) override;
+	virtual FAVResult WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime) override;
 };
 
 // TODO (Andrew) Hack until I get back to AMF
@@ -155,7 +155,7 @@ int TVideoEncoderAMF<TResource>::GetCapability(GUID EncodeGUID, NV_ENC_CAPS Caps
 }*/
 
 template <typename TResource>
-FAVResult TVideoEncoderAMF<TResource>::SendFrame(TSharedPtr<TResource> const& Resource, uint32 Timestamp, bool bForceKeyframe)
+FAVResult TVideoEncoderAMF<TResource>::SendFrame(TSharedPtr<TResource> const& Resource, uint64 Timestamp, bool bForceKeyframe, uint64 UserData)
 {
 	if (IsOpen())
 	{
@@ -178,6 +178,7 @@ FAVResult TVideoEncoderAMF<TResource>::SendFrame(TSharedPtr<TResource> const& Re
 			}
 
 			ResourceMapping->GetPtr()->SetPts(Timestamp);
+			ResourceMapping->GetPtr()->SetProperty(AMF_VIDEO_ENCODER_UE_USER_DATA, static_cast<amf_int64>(UserData));
 
 #if PLATFORM_WINDOWS
 			ResourceMapping->GetPtr()->SetProperty(AMF_VIDEO_ENCODER_STATISTICS_FEEDBACK, true);
@@ -253,7 +254,7 @@ FAVResult TVideoEncoderAMF<TResource>::SendFrame(amf::AMFSurfacePtr Input, bool
 
 				amf::AMFBufferPtr const PacketBuffer(PacketData);
 
-				TSharedPtr<uint8> const CopiedData = MakeShareable(new uint8[PacketBuffer->GetSize()]);
+				TSharedPtr<uint8> const CopiedData = UE::AVCodecCore::FPacketBufferPool::Get().Allocate(PacketBuffer->GetSize());
 				FMemory::BigBlockMemcpy(CopiedData.Get(), PacketBuffer->GetNative(), PacketBuffer->GetSize());
 
 				int32 PacketQP = 0;
@@ -264,14 +265,18 @@ FAVResult TVideoEncoderAMF<TResource>::SendFrame(amf::AMFSurfacePtr Input, bool
 
 				PacketData->GetProperty(AMF_VIDEO_ENCODER_OUTPUT_DATA_TYPE, &PacketType);
 
-				Packets.Enqueue(
+				amf_int64 PacketUserData = 0;
+				PacketData->GetProperty(AMF_VIDEO_ENCODER_UE_USER_DATA, &PacketUserData);
+
+				Packets.Push(
 					FVideoPacket(
 						CopiedData,
 						PacketBuffer->GetSize(),
 						PacketBuffer->GetPts(),
 						++FrameCount,
 						PacketQP,
-						PacketType == AMF_VIDEO_ENCODER_OUTPUT_DATA_TYPE_IDR));
+						PacketType == AMF_VIDEO_ENCODER_OUTPUT_DATA_TYPE_IDR,
+						static_cast<uint64>(PacketUserData)));
 			}
 		}
 		else
@@ -290,7 +295,23 @@ FAVResult TVideoEncoderAMF<TResource>::ReceivePacket(FVideoPacket& OutPacket)
 {
 	if (IsOpen())
 	{
-		if (Packets.Dequeue(OutPacket))
+		if (Packets.Pop(OutPacket))
+		{
+			return EAVResult::Success;
+		}
+
+		return EAVResult::PendingInput;
+	}
+
+	return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"), TEXT("AMF"));
+}
+
+template <typename TResource>
+FAVResult TVideoEncoderAMF<TResource>::WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime)
+{
+	if (IsOpen())
+	{
+		if (Packets.WaitPop(OutPacket, WaitTime))
 		{
 			return EAVResult::Success;
 		}
@@ -42,6 +42,9 @@ public class AVCodecsCore : ModuleRules
 		{
 			PublicIncludePathModuleNames.Add("Vulkan");
 			AddEngineThirdPartyPrivateStaticDependencies(Target, "Vulkan");
+
+			// Software encoder backend
+			AddEngineThirdPartyPrivateStaticDependencies(Target, "LibVpx");
 		}
 
 		if (Target.IsInPlatformGroup(UnrealPlatformGroup.Windows))
@@ -5,6 +5,7 @@
 #include "Modules/ModuleManager.h"
 
 #include "Video/Resources/VideoResourceCPU.h"
+#include "Video/Encoders/VideoEncoderVPX.h"
 
 class FAVCodecCoreModule : public IModuleInterface
 {
@@ -13,6 +14,16 @@ public:
 	{
 		FAVDevice::GetSoftwareDevice()->SetContext<FVideoContextCPU>(
 			MakeShared<FVideoContextCPU>());
+
+		/* Register the libvpx software pathway, for hosts without a hardware encoder. */
+		FVideoEncoder
+			::RegisterPermutationsOf<FVideoEncoderVPX>
+			::With<FVideoResourceCPU>
+			::And<FVideoEncoderConfigVPX>(
+				[](TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance)
+				{
+					return NewDevice->HasContext<FVideoContextCPU>();
+				});
 	}
 };
 
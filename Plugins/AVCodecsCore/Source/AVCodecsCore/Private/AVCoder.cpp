@@ -2,4 +2,13 @@
 
 #include "AVCoder.h"
 
-TMap<FTypeID, TMap<FTypeID, TMap<FTypeID, TSharedPtr<void>>>> IAVCoder::Factories = TMap<FTypeID, TMap<FTypeID, TMap<FTypeID, TSharedPtr<void>>>>();
+#include <atomic>
+
+TMap<FAVCoderFactoryKey, TSharedPtr<void>> IAVCoder::Factories = TMap<FAVCoderFactoryKey, TSharedPtr<void>>();
+
+uint64 IAVCoder::NewFactoryID()
+{
+	static std::atomic<uint64> NextID = 1;
+
+	return NextID++;
+}
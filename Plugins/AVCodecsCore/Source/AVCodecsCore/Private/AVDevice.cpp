@@ -2,6 +2,8 @@
 
 #include "AVDevice.h"
 
+#include "Misc/ScopeLock.h"
+
 TSharedRef<FAVDevice>& FAVDevice::GetHardwareDevice(int32 Index)
 {
 	static TArray<TSharedRef<FAVDevice>> Devices;
@@ -19,3 +21,30 @@ TSharedRef<FAVDevice>& FAVDevice::GetSoftwareDevice()
 	static TSharedRef<FAVDevice> Device = MakeShared<FAVDevice>();
 	return Device;
 }
+
+bool FAVDevice::IsCompatible(uint64 FactoryID, TFunctionRef<bool()> IsCompatible) const
+{
+	{
+		FScopeLock const Lock(&CompatibilityGuard);
+
+		if (bool const* const Cached = Compatibility.Find(FactoryID))
+		{
+			return *Cached;
+		}
+	}
+
+	// Worked out without holding the lock, the check is free to look at this device. Racing callers simply agree on the same answer.
+	bool const bCompatible = IsCompatible();
+
+	FScopeLock const Lock(&CompatibilityGuard);
+	Compatibility.Add(FactoryID, bCompatible);
+
+	return bCompatible;
+}
+
+void FAVDevice::ResetCompatibility()
+{
+	FScopeLock const Lock(&CompatibilityGuard);
+
+	Compatibility.Reset();
+}
@@ -0,0 +1,161 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Utils/AsyncWorker.h"
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+namespace UE::AVCodecCore
+{
+	FAsyncWorker::FAsyncWorker(FString const& Name, int32 InMaxQueued, EAsyncWorkerOverflow InOverflow)
+		: MaxQueued(FMath::Max(InMaxQueued, 1))
+		, Overflow(InOverflow)
+		, TasksPending(FPlatformProcess::GetSynchEventFromPool(false))
+		, TaskDone(FPlatformProcess::GetSynchEventFromPool(false))
+	{
+		if (FPlatformProcess::SupportsMultithreading())
+		{
+			Thread = FRunnableThread::Create(this, *Name);
+		}
+	}
+
+	FAsyncWorker::~FAsyncWorker()
+	{
+		if (Thread != nullptr)
+		{
+			// Kill stops the runnable and waits for it, which drains whatever is still queued
+			Thread->Kill(true);
+
+			delete Thread;
+			Thread = nullptr;
+		}
+
+		FPlatformProcess::ReturnSynchEventToPool(TasksPending);
+		TasksPending = nullptr;
+
+		FPlatformProcess::ReturnSynchEventToPool(TaskDone);
+		TaskDone = nullptr;
+	}
+
+	bool FAsyncWorker::Enqueue(FTask&& Task)
+	{
+		if (!IsRunning())
+		{
+			return false;
+		}
+
+		while (true)
+		{
+			// Anything dropped is destroyed once the lock is released, in case it holds on to something expensive to free
+			FTask DroppedTask;
+
+			{
+				FScopeLock const Lock(&Guard);
+
+				if (Queued >= MaxQueued && Overflow == EAsyncWorkerOverflow::DropOldest && Tasks.Dequeue(DroppedTask))
+				{
+					Queued--;
+					Dropped++;
+				}
+
+				if (Queued < MaxQueued)
+				{
+					Tasks.Enqueue(MoveTemp(Task));
+					Queued++;
+
+					break;
+				}
+			}
+
+			TaskDone->Wait();
+		}
+
+		TasksPending->Trigger();
+
+		return true;
+	}
+
+	void FAsyncWorker::Flush()
+	{
+		if (!IsRunning())
+		{
+			return;
+		}
+
+		while (true)
+		{
+			{
+				FScopeLock const Lock(&Guard);
+
+				if (Queued == 0 && !bBusy)
+				{
+					break;
+				}
+			}
+
+			TaskDone->Wait();
+		}
+	}
+
+	int32 FAsyncWorker::NumQueued() const
+	{
+		FScopeLock const Lock(&Guard);
+
+		return Queued;
+	}
+
+	uint32 FAsyncWorker::Run()
+	{
+		while (true)
+		{
+			FTask Task;
+			bool bDequeued = false;
+
+			{
+				FScopeLock const Lock(&Guard);
+
+				bDequeued = Tasks.Dequeue(Task);
+				if (bDequeued)
+				{
+					Queued--;
+					bBusy = true;
+				}
+			}
+
+			if (bDequeued)
+			{
+				if (Task)
+				{
+					Task();
+				}
+
+				{
+					FScopeLock const Lock(&Guard);
+
+					bBusy = false;
+				}
+
+				TaskDone->Trigger();
+
+				continue;
+			}
+
+			if (bStopping)
+			{
+				break;
+			}
+
+			TasksPending->Wait();
+			Wakeups++;
+		}
+
+		return 0;
+	}
+
+	void FAsyncWorker::Stop()
+	{
+		bStopping = true;
+		TasksPending->Trigger();
+	}
+} // namespace UE::AVCodecCore
@@ -0,0 +1,152 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Utils/PacketBufferPool.h"
+
+#include "Misc/ScopeLock.h"
+
+namespace UE::AVCodecCore
+{
+	namespace PacketBufferPoolPrivate
+	{
+		constexpr uint32 MinBucketLog2 = 12;
+		constexpr uint32 NumBuckets = 26 - MinBucketLog2 + 1;
+
+		static_assert(FPacketBufferPool::MinBucketSize == 1ull << MinBucketLog2);
+		static_assert(FPacketBufferPool::MaxBucketSize == 1ull << (MinBucketLog2 + NumBuckets - 1));
+
+		int32 GetBucketIndex(uint64 Size)
+		{
+			return FMath::Max<int32>(FMath::CeilLogTwo64(Size), MinBucketLog2) - MinBucketLog2;
+		}
+	} // namespace PacketBufferPoolPrivate
+
+	struct FPacketBufferPool::FBuckets
+	{
+		int32 const MaxBuffersPerBucket;
+
+		mutable FCriticalSection Guard;
+		TArray<uint8*> Free[PacketBufferPoolPrivate::NumBuckets];
+
+		FBuckets(int32 InMaxBuffersPerBucket)
+			: MaxBuffersPerBucket(InMaxBuffersPerBucket)
+		{
+		}
+
+		~FBuckets()
+		{
+			Trim();
+		}
+
+		uint8* Pop(int32 BucketIndex)
+		{
+			FScopeLock const Lock(&Guard);
+
+			return Free[BucketIndex].Num() > 0 ? Free[BucketIndex].Pop(false) : nullptr;
+		}
+
+		void Push(int32 BucketIndex, uint8* Buffer)
+		{
+			{
+				FScopeLock const Lock(&Guard);
+
+				if (Free[BucketIndex].Num() < MaxBuffersPerBucket)
+				{
+					Free[BucketIndex].Push(Buffer);
+
+					return;
+				}
+			}
+
+			FMemory::Free(Buffer);
+		}
+
+		void Trim()
+		{
+			FScopeLock const Lock(&Guard);
+
+			for (TArray<uint8*>& Bucket : Free)
+			{
+				for (uint8* Buffer : Bucket)
+				{
+					FMemory::Free(Buffer);
+				}
+
+				Bucket.Empty();
+			}
+		}
+	};
+
+	FPacketBufferPool& FPacketBufferPool::Get()
+	{
+		static FPacketBufferPool Pool;
+
+		return Pool;
+	}
+
+	FPacketBufferPool::FPacketBufferPool(int32 InMaxBuffersPerBucket)
+		: Buckets(MakeShared<FBuckets>(InMaxBuffersPerBucket))
+	{
+	}
+
+	FPacketBufferPool::~FPacketBufferPool() = default;
+
+	TSharedPtr<uint8> FPacketBufferPool::Allocate(uint64 Size)
+	{
+		if (Size == 0)
+		{
+			return nullptr;
+		}
+
+		if (Size > MaxBucketSize)
+		{
+			return MakeShareable(static_cast<uint8*>(FMemory::Malloc(Size)), [](uint8* Unpooled) {
+				FMemory::Free(Unpooled);
+			});
+		}
+
+		int32 const BucketIndex = PacketBufferPoolPrivate::GetBucketIndex(Size);
+
+		uint8* Buffer = Buckets->Pop(BucketIndex);
+		if (Buffer == nullptr)
+		{
+			Buffer = static_cast<uint8*>(FMemory::Malloc(GetBucketSize(Size)));
+		}
+
+		return MakeShareable(Buffer, [PoolBuckets = Buckets, BucketIndex](uint8* Released) {
+			PoolBuckets->Push(BucketIndex, Released);
+		});
+	}
+
+	void FPacketBufferPool::Trim()
+	{
+		Buckets->Trim();
+	}
+
+	int32 FPacketBufferPool::NumFree() const
+	{
+		FScopeLock const Lock(&Buckets->Guard);
+
+		int32 Count = 0;
+		for (TArray<uint8*> const& Bucket : Buckets->Free)
+		{
+			Count += Bucket.Num();
+		}
+
+		return Count;
+	}
+
+	TWeakPtr<void> FPacketBufferPool::GetBucketsForTesting() const
+	{
+		return TSharedRef<void>(Buckets);
+	}
+
+	uint64 FPacketBufferPool::GetBucketSize(uint64 Size)
+	{
+		if (Size > MaxBucketSize)
+		{
+			return Size;
+		}
+
+		return MinBucketSize << PacketBufferPoolPrivate::GetBucketIndex(Size);
+	}
+} // namespace UE::AVCodecCore
@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Utils/StartCodeScanner.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#elif PLATFORM_ENABLE_VECTORINTRINSICS
+#include <emmintrin.h>
+#if PLATFORM_ALWAYS_HAS_AVX_2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace UE::AVCodecCore
+{
+	int64 FindStartCodeScalar(uint8 const* Data, int64 DataSize, int64 Offset)
+	{
+		// Skip over stream in intervals of 3 until Data[i + 2] is either 0 or 1
+		for (int64 i = Offset; i < DataSize - 2;)
+		{
+			if (Data[i + 2] > 1)
+			{
+				i += 3;
+			}
+			else if (Data[i + 2] == 1)
+			{
+				if (Data[i + 1] == 0 && Data[i] == 0)
+				{
+					return i;
+				}
+
+				i += 3;
+			}
+			else
+			{
+				++i;
+			}
+		}
+
+		return INDEX_NONE;
+	}
+
+	int64 FindStartCode(uint8 const* Data, int64 DataSize, int64 Offset)
+	{
+		int64 i = Offset;
+
+		// Each lane compares Data[i + n], Data[i + n + 1] and Data[i + n + 2] against 0x00 0x00 0x01, so we need two bytes of lookahead past the vector
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+		uint8x16_t const Zero = vdupq_n_u8(0);
+		uint8x16_t const One = vdupq_n_u8(1);
+
+		for (; i + 16 + 2 <= DataSize; i += 16)
+		{
+			uint8x16_t const B0 = vceqq_u8(vld1q_u8(Data + i), Zero);
+			uint8x16_t const B1 = vceqq_u8(vld1q_u8(Data + i + 1), Zero);
+			uint8x16_t const B2 = vceqq_u8(vld1q_u8(Data + i + 2), One);
+			uint8x16_t const Match = vandq_u8(vandq_u8(B0, B1), B2);
+
+			if (vmaxvq_u8(Match) != 0)
+			{
+				// NEON has no movemask, so narrow each lane to a nibble and count those instead
+				uint64 const Mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(Match), 4)), 0);
+
+				return i + (FMath::CountTrailingZeros64(Mask) >> 2);
+			}
+		}
+#elif PLATFORM_ENABLE_VECTORINTRINSICS
+#if PLATFORM_ALWAYS_HAS_AVX_2
+		__m256i const Zero32 = _mm256_setzero_si256();
+		__m256i const One32 = _mm256_set1_epi8(1);
+
+		for (; i + 32 + 2 <= DataSize; i += 32)
+		{
+			__m256i const B0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i const*)(Data + i)), Zero32);
+			__m256i const B1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i const*)(Data + i + 1)), Zero32);
+			__m256i const B2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i const*)(Data + i + 2)), One32);
+
+			uint32 const Mask = (uint32)_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(B0, B1), B2));
+			if (Mask != 0)
+			{
+				return i + FMath::CountTrailingZeros(Mask);
+			}
+		}
+#endif
+		__m128i const Zero = _mm_setzero_si128();
+		__m128i const One = _mm_set1_epi8(1);
+
+		for (; i + 16 + 2 <= DataSize; i += 16)
+		{
+			__m128i const B0 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const*)(Data + i)), Zero);
+			__m128i const B1 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const*)(Data + i + 1)), Zero);
+			__m128i const B2 = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const*)(Data + i + 2)), One);
+
+			uint32 const Mask = (uint32)_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(B0, B1), B2));
+			if (Mask != 0)
+			{
+				return i + FMath::CountTrailingZeros(Mask);
+			}
+		}
+#endif
+
+		// Finish off whatever is left that doesn't fill a full vector
+		return FindStartCodeScalar(Data, DataSize, i);
+	}
+} // namespace UE::AVCodecCore
@@ -4,6 +4,9 @@
 
 #include "Containers/Array.h"
 #include "AVResult.h"
+#include "Utils/BitstreamWriter.h"
+#include "Utils/PacketBufferPool.h"
+#include "Utils/StartCodeScanner.h"
 #include "Video/CodecUtils/CodecUtilsH265.h"
 
 FH264ProfileDefinition GH264ProfileDefinitions[static_cast<uint8>(EH264Profile::MAX)] = {
@@ -44,48 +47,31 @@ namespace UE::AVCodecCore::H264
 
 		TArrayView64<uint8> const Data = InPacket.GetData();
 		
-		// Skip over stream in intervals of 3 until Data[i + 2] is either 0 or 1
-		for (int64 i = 0; i < Data.Num() - 2;)
+		for (int64 i = FindStartCode(Data.GetData(), Data.Num()); i != INDEX_NONE && i + 3 < Data.Num(); i = FindStartCode(Data.GetData(), Data.Num(), i + 3))
 		{
-			if (Data[i + 2] > 1)
+			// Found start sequence of NalU but we don't know if it has a 3 or 4 byte start code so we check.
+			FNaluInfo NalInfo = { (uint64)i, 0, 3, 0, ENaluType::Unspecified, nullptr };
+			if (NalInfo.Start > 0 && Data[NalInfo.Start - 1] == 0)
 			{
-				i += 3;
+				++NalInfo.StartCodeSize;
+				--NalInfo.Start;
 			}
-			else if (Data[i + 2] == 1)
-			{
-				if (Data[i + 1] == 0 && Data[i] == 0)
-				{
-					// Found start sequence of NalU but we don't know if it has a 3 or 4 byte start code so we check.
-					FNaluInfo NalInfo = { (uint64)i, 0, 3, 0, ENaluType::Unspecified, nullptr };
-					if (NalInfo.Start > 0 && Data[NalInfo.Start - 1] == 0)
-					{
-						++NalInfo.StartCodeSize;
-						--NalInfo.Start;
-					}
-
-					FBitstreamReader Bitstream(&Data[NalInfo.Start + NalInfo.StartCodeSize], 1);
-					verifyf(Bitstream.ReadBits(1) == 0, TEXT("Forbidden Zero bit not Zero in NAL Header"));
-
-					NalInfo.RefIdc = Bitstream.ReadBits(2);
-					NalInfo.Type = (ENaluType)Bitstream.ReadBits(5);
 
-					NalInfo.Data = &Data[NalInfo.Start + NalInfo.StartCodeSize + 1];
+			FBitstreamReader Bitstream(&Data[NalInfo.Start + NalInfo.StartCodeSize], 1);
+			verifyf(Bitstream.ReadBits(1) == 0, TEXT("Forbidden Zero bit not Zero in NAL Header"));
 
-					// Update length of previous entry.
-					if (FoundNalus.Num() > 0)
-					{
-						FoundNalus.Last().Size = NalInfo.Start - (FoundNalus.Last().Start + FoundNalus.Last().StartCodeSize);
-					}
+			NalInfo.RefIdc = Bitstream.ReadBits(2);
+			NalInfo.Type = (ENaluType)Bitstream.ReadBits(5);
 
-					FoundNalus.Add(NalInfo);
-				}
+			NalInfo.Data = &Data[NalInfo.Start + NalInfo.StartCodeSize + 1];
 
-				i += 3;
-			}
-			else
+			// Update length of previous entry.
+			if (FoundNalus.Num() > 0)
 			{
-				++i;
+				FoundNalus.Last().Size = NalInfo.Start - (FoundNalus.Last().Start + FoundNalus.Last().StartCodeSize);
 			}
+
+			FoundNalus.Add(NalInfo);
 		}
 
 		if (FoundNalus.Num() == 0)
@@ -96,24 +82,50 @@ namespace UE::AVCodecCore::H264
 		// Last Nal size is the remaining size of the bitstream minus a trailing zero byte
 		FoundNalus.Last().Size = Data.Num() - (FoundNalus.Last().Start + FoundNalus.Last().StartCodeSize + 1);
 
-	#if !IS_PROGRAM
-
-		FAVResult::Log(EAVResult::Success, FString::Printf(TEXT("FAVExtension::TransformConfig found %d NALUs in bitdatastream"), FoundNalus.Num()));
-
-		for (const FNaluInfo& NalUInfo : FoundNalus)
+		// This runs for every packet, so only pay for formatting when someone is actually listening
+		if (UE_LOG_ACTIVE(LogAVCodecs, VeryVerbose))
 		{
-			FAVResult::Log(EAVResult::Success, FString::Printf(TEXT("Found NALU at %llu size %llu with type %u"), NalUInfo.Start, NalUInfo.Size, (uint8)NalUInfo.Type));
-		}
+			UE_LOG(LogAVCodecs, VeryVerbose, TEXT("FindNALUs found %d NALUs in bitdatastream"), FoundNalus.Num());
 
-	#endif //!IS_PROGRAM
+			for (const FNaluInfo& NalUInfo : FoundNalus)
+			{
+				UE_LOG(LogAVCodecs, VeryVerbose, TEXT("Found NALU at %llu size %llu with type %u"), NalUInfo.Start, NalUInfo.Size, (uint8)NalUInfo.Type);
+			}
+		}
 
 		return EAVResult::Success;
 	}
 
 	FAVResult ParseSEI(FBitstreamReader& Bitstream, FNaluInfo const& InNaluInfo, SEI_t& OutSEI)
 	{
-		//unimplemented();
-		return FAVResult(EAVResult::Success, TEXT("SEI Unimplemented"));
+		return SEI::ParseMessages(Bitstream, OutSEI.Messages);
+	}
+
+	FAVResult InsertSEI(FVideoPacket& InOutPacket, SEI::EPayloadType PayloadType, TConstArrayView<uint8> Payload)
+	{
+		TArray<FNaluInfo> FoundNalus;
+
+		FAVResult const Result = FindNALUs(InOutPacket, FoundNalus);
+		if (Result.IsNotSuccess())
+		{
+			return Result;
+		}
+
+		for (FNaluInfo const& NaluInfo : FoundNalus)
+		{
+			if (NaluInfo.Type >= ENaluType::SliceOfNonIdrPicture && NaluInfo.Type <= ENaluType::SliceIdrPicture)
+			{
+				uint8 const NalHeader[] = { (uint8)ENaluType::SupplementalEnhancementInformation };
+
+				TArray<uint8> Nalu;
+				SEI::MakeNalu(NalHeader, PayloadType, Payload, Nalu);
+				SEI::InsertNalu(InOutPacket, NaluInfo.Start, Nalu);
+
+				return EAVResult::Success;
+			}
+		}
+
+		return FAVResult(EAVResult::Warning, TEXT("No slice to attach SEI to"), TEXT("H264"));
 	}
 
 	void ParseScalingList(FBitstreamReader& Bitstream, const uint8& chroma_format_idc,  FNalu::U<1> scaling_list_present_flag[12], uint8 ScalingList4x4[6][16], uint8 ScalingList8x8[6][64])
@@ -182,23 +194,22 @@ namespace UE::AVCodecCore::H264
 		// Be sure to maintain parity with SPS struct values, or we may miss bits
 		FNalu::U<8, EH264ProfileIDC> temp_profile_idc;
 		FNalu::U<8, EH264ConstraintFlag> temp_constraint_flags;
+		FNalu::U<8> temp_level_idc;
+		FNalu::UE seq_parameter_set_id;
 
 		Bitstream.Read(
 			temp_profile_idc,
-			temp_constraint_flags);
-		
-		FNalu::SE seq_parameter_set_id;
-		Bitstream.Read(seq_parameter_set_id);
+			temp_constraint_flags,
+			temp_level_idc,
+			seq_parameter_set_id);
 
 		// Find SPS at current ID or set it to the map
 		SPS_t& OutSPS = OutMapSPS.FindOrAdd(seq_parameter_set_id);
 
 		OutSPS.profile_idc = temp_profile_idc;
 		OutSPS.constraint_flags = temp_constraint_flags;
-		
-		Bitstream.Read(
-			OutSPS.level_idc,
-			OutSPS.seq_parameter_set_id);
+		OutSPS.level_idc = temp_level_idc;
+		OutSPS.seq_parameter_set_id = seq_parameter_set_id;
 
 		if (OutSPS.profile_idc == EH264ProfileIDC::High ||
 			OutSPS.profile_idc == EH264ProfileIDC::High10 ||
@@ -274,6 +285,8 @@ namespace UE::AVCodecCore::H264
 				OutSPS.frame_crop_bottom_offset);
 		}
 
+		OutSPS.VUIBitOffset = Bitstream.NumBitsRead();
+
 		Bitstream.Read(OutSPS.vui_parameters_present_flag);
 		if (OutSPS.vui_parameters_present_flag)
 		{
@@ -385,6 +398,255 @@ namespace UE::AVCodecCore::H264
 		return EAVResult::Success;
 	}
 
+	FAVResult RewriteSPS(FNaluInfo const& InNaluInfo, FVUIRewrite const& Rewrite, TArray<uint8>& OutNalu)
+	{
+		// Size includes the NAL header but Data starts after it
+		uint64 const PayloadSize = InNaluInfo.Size - 1;
+
+		TMap<uint32, SPS_t> ParsedSPS;
+		FBitstreamReader SPSBitstream = FBitstreamReader::FromEBSP(InNaluInfo.Data, PayloadSize);
+
+		FAVResult const Result = ParseSPS(SPSBitstream, InNaluInfo, ParsedSPS);
+		if (Result.IsNotSuccess() || ParsedSPS.Num() != 1)
+		{
+			return FAVResult(EAVResult::Error, TEXT("Failed to parse SPS for rewriting"), TEXT("H264"));
+		}
+
+		SPS_t const& SPS = ParsedSPS.CreateConstIterator().Value();
+
+		// Start code and header are copied as is
+		for (uint8 i = 1; i < InNaluInfo.StartCodeSize; ++i)
+		{
+			OutNalu.Add(0x00);
+		}
+
+		OutNalu.Add(0x01);
+		OutNalu.Add(InNaluInfo.Data[-1]);
+
+		FBitstreamReader Bitstream = FBitstreamReader::FromEBSP(InNaluInfo.Data, PayloadSize);
+		FBitstreamWriter Writer = FBitstreamWriter::ToEBSP(OutNalu);
+
+		auto Copy = [&Bitstream, &Writer](uint64 NumBits) -> uint32
+		{
+			for (; NumBits > 32; NumBits -= 32)
+			{
+				Writer.WriteBits(Bitstream.ReadBits(32), 32);
+			}
+
+			uint32 const Value = Bitstream.ReadBits(NumBits);
+			Writer.WriteBits(Value, NumBits);
+
+			return Value;
+		};
+
+		auto CopyUE = [&Bitstream, &Writer]() -> uint32
+		{
+			FNalu::UE Value;
+			Bitstream.Read(Value);
+			Writer.Write(Value);
+
+			return Value;
+		};
+
+		// Everything up to the VUI is left untouched
+		Copy(SPS.VUIBitOffset);
+
+		Bitstream.SkipBits(1);
+		Writer.WriteBits(1u, 1);
+
+		if (SPS.vui_parameters_present_flag)
+		{
+			if (Copy(1)) // aspect_ratio_info_present_flag
+			{
+				if (Copy(8) == (uint32)EH264AspectRatioIDC::Extended_SAR)
+				{
+					Copy(32); // sar_width, sar_height
+				}
+			}
+
+			if (Copy(1)) // overscan_info_present_flag
+			{
+				Copy(1);
+			}
+
+			if (Copy(1)) // video_signal_type_present_flag
+			{
+				Copy(4);
+				if (Copy(1)) // colour_description_present_flag
+				{
+					Copy(24);
+				}
+			}
+
+			if (Copy(1)) // chroma_loc_info_present_flag
+			{
+				CopyUE();
+				CopyUE();
+			}
+
+			if (Rewrite.TimeScale.IsSet())
+			{
+				Bitstream.SkipBits(SPS.timing_info_present_flag ? 66 : 1);
+			}
+			else if (Copy(1)) // timing_info_present_flag
+			{
+				Copy(65);
+			}
+		}
+		else
+		{
+			// No aspect ratio, overscan, video signal type or chroma location info
+			Writer.WriteBits(0u, 4);
+
+			if (!Rewrite.TimeScale.IsSet())
+			{
+				Writer.WriteBits(0u, 1);
+			}
+		}
+
+		if (Rewrite.TimeScale.IsSet())
+		{
+			Writer.WriteBits(1u, 1);
+			Writer.WriteBits(Rewrite.NumUnitsInTick, 32);
+			Writer.WriteBits(Rewrite.TimeScale.GetValue(), 32);
+			Writer.WriteBits(Rewrite.bFixedFrameRate ? 1u : 0u, 1);
+		}
+
+		if (SPS.vui_parameters_present_flag)
+		{
+			auto hrd_parameters = [&Copy, &CopyUE]() -> void
+			{
+				uint32 const cpb_cnt_minus1 = CopyUE();
+				Copy(8); // bit_rate_scale, cpb_size_scale
+
+				for (uint32 SchedSelIdx = 0; SchedSelIdx <= cpb_cnt_minus1; SchedSelIdx++)
+				{
+					CopyUE();
+					CopyUE();
+					Copy(1);
+				}
+
+				Copy(20); // initial_cpb_removal_delay_length_minus1, cpb_removal_delay_length_minus1, dpb_output_delay_length_minus1, time_offset_length
+			};
+
+			uint32 const nal_hrd_parameters_present_flag = Copy(1);
+			if (nal_hrd_parameters_present_flag)
+			{
+				hrd_parameters();
+			}
+
+			uint32 const vcl_hrd_parameters_present_flag = Copy(1);
+			if (vcl_hrd_parameters_present_flag)
+			{
+				hrd_parameters();
+			}
+
+			if (nal_hrd_parameters_present_flag || vcl_hrd_parameters_present_flag)
+			{
+				Copy(1); // low_delay_hrd_flag
+			}
+
+			Copy(1); // pic_struct_present_flag
+
+			if (Rewrite.bRestrictFrameBuffering)
+			{
+				// Bitstream restriction is the last thing in the VUI, so there is nothing left to copy
+			}
+			else if (Copy(1)) // bitstream_restriction_flag
+			{
+				Copy(1);
+				for (int32 i = 0; i < 6; ++i)
+				{
+					CopyUE();
+				}
+			}
+		}
+		else
+		{
+			// No HRD parameters or picture structure info
+			Writer.WriteBits(0u, 3);
+
+			if (!Rewrite.bRestrictFrameBuffering)
+			{
+				Writer.WriteBits(0u, 1);
+			}
+		}
+
+		if (Rewrite.bRestrictFrameBuffering)
+		{
+			bool const bHadRestriction = SPS.vui_parameters_present_flag && SPS.bitstream_restriction_flag;
+
+			// Keep whatever limits the encoder already signalled, or the values that mean "unrestricted" if there were none
+			Writer.WriteBits(1u, 1);
+			Writer.Write(
+				bHadRestriction ? SPS.motion_vectors_over_pic_boundaries_flag : FNalu::U<1>(1),
+				bHadRestriction ? SPS.max_bytes_per_pic_denom : FNalu::UE(2),
+				bHadRestriction ? SPS.max_bits_per_mb_denom : FNalu::UE(1),
+				bHadRestriction ? SPS.log2_max_mv_length_horizontal : FNalu::UE(16),
+				bHadRestriction ? SPS.log2_max_mv_length_vertical : FNalu::UE(16),
+				FNalu::UE(0),
+				FNalu::UE(FMath::Max<uint32>(SPS.max_num_ref_frames, 1)));
+		}
+
+		Writer.WriteTrailingBits();
+
+		return EAVResult::Success;
+	}
+
+	FAVResult RewriteSPS(FVideoPacket& InOutPacket, FVUIRewrite const& Rewrite)
+	{
+		TArray<FNaluInfo> FoundNalus;
+
+		FAVResult Result = FindNALUs(InOutPacket, FoundNalus);
+		if (Result.IsNotSuccess())
+		{
+			return Result;
+		}
+
+		uint8 const* const Data = InOutPacket.DataPtr.Get();
+
+		TArray<uint8> Rewritten;
+		uint64 CopiedSize = 0;
+
+		for (int32 i = 0; i < FoundNalus.Num(); ++i)
+		{
+			FNaluInfo const& NaluInfo = FoundNalus[i];
+			if (NaluInfo.Type != ENaluType::SequenceParameterSet)
+			{
+				continue;
+			}
+
+			if (Rewritten.Num() == 0)
+			{
+				Rewritten.Reserve(InOutPacket.DataSize + 16);
+			}
+
+			Rewritten.Append(Data + CopiedSize, NaluInfo.Start - CopiedSize);
+
+			Result = RewriteSPS(NaluInfo, Rewrite, Rewritten);
+			if (Result.IsNotSuccess())
+			{
+				return Result;
+			}
+
+			// Skip to the next start code rather than trusting the size, which loses a byte for the last NALU in the packet
+			CopiedSize = i + 1 < FoundNalus.Num() ? FoundNalus[i + 1].Start : InOutPacket.DataSize;
+		}
+
+		if (Rewritten.Num() > 0)
+		{
+			Rewritten.Append(Data + CopiedSize, InOutPacket.DataSize - CopiedSize);
+
+			TSharedPtr<uint8> const RewrittenData = FPacketBufferPool::Get().Allocate(Rewritten.Num());
+			FMemory::Memcpy(RewrittenData.Get(), Rewritten.GetData(), Rewritten.Num());
+
+			InOutPacket.DataPtr = RewrittenData;
+			InOutPacket.DataSize = Rewritten.Num();
+		}
+
+		return EAVResult::Success;
+	}
+
 	FAVResult ParsePPS(FBitstreamReader& Bitstream, FNaluInfo const& InNaluInfo, TMap<uint32, SPS_t> const& InMapSPS, TMap<uint32, PPS_t>& OutMapPPS)
 	{	
 		FNalu::UE pic_parameter_set_id;
@@ -473,7 +735,13 @@ namespace UE::AVCodecCore::H264
 			Bitstream.Read(OutPPS.pic_scaling_matrix_present_flag);
 			if (OutPPS.pic_scaling_matrix_present_flag)
 			{
-				ParseScalingList(Bitstream, InMapSPS[OutPPS.seq_parameter_set_id].chroma_format_idc, OutPPS.pic_scaling_list_present_flag, OutPPS.ScalingList4x4, OutPPS.ScalingList8x8);
+				const SPS_t* const FoundSPS = InMapSPS.Find(OutPPS.seq_parameter_set_id);
+				if (FoundSPS == nullptr)
+				{
+					return FAVResult(EAVResult::Error, TEXT("PPS refers to an SPS that has not been received"), TEXT("H264"));
+				}
+
+				ParseScalingList(Bitstream, FoundSPS->chroma_format_idc, OutPPS.pic_scaling_list_present_flag, OutPPS.ScalingList4x4, OutPPS.ScalingList8x8);
 			}
 
 			Bitstream.Read(OutPPS.second_chroma_qp_index_offset);
@@ -482,15 +750,22 @@ namespace UE::AVCodecCore::H264
 		return EAVResult::Success;
 	}
 
-	FAVResult ParseSliceHeader(FBitstreamReader& Bitstream, FNaluInfo const& InNaluInfo, TMap<uint32, SPS_t> InMapSPS, TMap<uint32, PPS_t> const& InMapPPS, Slice_t& OutSlice)
+	FAVResult ParseSliceHeader(FBitstreamReader& Bitstream, FNaluInfo const& InNaluInfo, TMap<uint32, SPS_t> const& InMapSPS, TMap<uint32, PPS_t> const& InMapPPS, Slice_t& OutSlice)
 	{
 		Bitstream.Read(
 			OutSlice.first_mb_in_slice,
 			OutSlice.slice_type,
 			OutSlice.pic_parameter_set_id);
 
-		const PPS_t& CurrentPPS = InMapPPS[OutSlice.pic_parameter_set_id];
-		const SPS_t& CurrentSPS = InMapSPS[CurrentPPS.seq_parameter_set_id];
+		const PPS_t* const FoundPPS = InMapPPS.Find(OutSlice.pic_parameter_set_id);
+		const SPS_t* const FoundSPS = FoundPPS != nullptr ? InMapSPS.Find(FoundPPS->seq_parameter_set_id) : nullptr;
+		if (FoundSPS == nullptr)
+		{
+			return FAVResult(EAVResult::Error, TEXT("Slice refers to a parameter set that has not been received"), TEXT("H264"));
+		}
+
+		const PPS_t& CurrentPPS = *FoundPPS;
+		const SPS_t& CurrentSPS = *FoundSPS;
 
 		if (CurrentSPS.separate_colour_plane_flag)
 		{
@@ -677,128 +952,79 @@ namespace UE::AVCodecCore::H264
 		return EAVResult::Success;
 	}
 
-} // namespace UE::AVCodecCore::H264
+	FAVResult FParserState::ParsePacket(FVideoPacket const& InPacket, TArray<Slice_t>& OutSlices, TArray<SEI_t>& OutSEI)
+	{
+		TArray<FNaluInfo> FoundNalus;
+
+		FAVResult Result;
+		Result = FindNALUs(InPacket, FoundNalus);
+
+		if (Result.IsNotSuccess())
+		{
+			return Result;
+		}
 
-// template <>
-// DLLEXPORT FAVResult FAVExtension::TransformPacket(FVideoPacketH264& OutPacket, FVideoPacket const& InPacket)
-// {
-// 	using namespace UE::AVCodecCore::H264;
+		for (FNaluInfo const& NaluInfo : FoundNalus)
+		{
+			Result = ParseNalu(NaluInfo, OutSlices, OutSEI);
 
-// 	TArray<FNaluInfo> FoundNalus;
+			if (Result.IsNotSuccess())
+			{
+				return Result;
+			}
+		}
 
-// 	FAVResult Result;
-// 	Result = FindNALUs(InPacket, FoundNalus);
+		return Result;
+	}
 
-// 	if (Result.IsNotSuccess())
-// 	{
-// 		return Result;
-// 	}
+	FAVResult FParserState::ParseNalu(FNaluInfo const& InNaluInfo, TArray<Slice_t>& OutSlices, TArray<SEI_t>& OutSEI)
+	{
+		// NALUs are is usually an EBSP so read them with a reader that skips the emulation prevention 3 byte as it goes
+		FBitstreamReader Bitstream = FBitstreamReader::FromEBSP(InNaluInfo.Data, InNaluInfo.Size);
 
-// 	for (auto& NaluInfo : FoundNalus)
-// 	{		
-// 		Result = EAVResult::Success;
-		
-// 		// NALUs are is usually an EBSP so we need to strip out the emulation prevention 3 byte making them RBSP
-// 		TArray64<uint8> RBSP;
-// 		RBSP.AddUninitialized(NaluInfo.Size);
-
-// 		int32 RBSPsize = EBSPtoRBSP(RBSP.GetData(), NaluInfo.Data, NaluInfo.Size);
-// 		FBitDataStream Bitstream(RBSP.GetData(), RBSPsize);
-
-// 		switch (NaluInfo.Type)
-// 		{
-// 			case ENaluType::Unspecified:
-// 			default:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Unspecified"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::SliceOfNonIdrPicture:
-// 				OutPacket.Slices.AddUninitialized();
-// 				Result = ParseSliceHeader(Bitstream, NaluInfo, OutPacket.SPS, OutPacket.PPS, OutPacket.Slices.Last());
-// 				break;
-// 			case ENaluType::SliceDataPartitionA:
-// 				break;
-// 			case ENaluType::SliceDataPartitionB:
-// 				break;
-// 			case ENaluType::SliceDataPartitionC:
-// 				break;
-// 			case ENaluType::SliceIdrPicture:
-// 				break;
-// 			case ENaluType::SupplementalEnhancementInformation:
-// 				OutPacket.SEI.AddUninitialized();
-// 				Result = ParseSEI(Bitstream, NaluInfo, OutPacket.SEI.Last());
-// 				break;
-// 			case ENaluType::SequenceParameterSet:
-// 				Result = ParseSPS(Bitstream, NaluInfo, OutPacket.SPS);
-// 				break;
-// 			case ENaluType::PictureParameterSet:
-// 				Result = ParsePPS(Bitstream, NaluInfo, OutPacket.SPS, OutPacket.PPS);
-// 				break;
-// 			case ENaluType::AccessUnitDelimiter:
-// 				break;
-// 			case ENaluType::EndOfSequence:
-// 				break;
-// 			case ENaluType::EndOfStream:
-// 				break;
-// 			case ENaluType::FillerData:
-// 				break;
-// 			case ENaluType::SequenceParameterSetExtension:
-// 				break;
-// 			case ENaluType::PrefixNalUnit:
-// 				break;
-// 			case ENaluType::SubsetSequenceParameterSet:
-// 				break;
-// 			case ENaluType::Reserved16:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Reserved16"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Reserved17:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Reserved17"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Reserved18:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Reserved18"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::SliceOfAnAuxiliaryCoded:
-// 				break;
-// 			case ENaluType::SliceExtension:
-// 				break;
-// 			case ENaluType::SliceExtensionForDepthView:
-// 				break;
-// 			case ENaluType::Reserved22:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Reserved22"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Reserved23:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Reserved23"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Unspecified24:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Unspecified24"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Unspecified25:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Unspecified25"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Unspecified26:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Unspecified26"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Unspecified27:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Unspecified27"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Unspecified28:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Unspecified28"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Unspecified29:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Unspecified29"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Unspecified30:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Unspecified30"), TEXT("BitstreamParserH264"));
-// 				break;
-// 			case ENaluType::Unspecified31:
-// 				Result = FAVResult(EAVResult::Error, TEXT("Recieved ENaluType::Unspecified31"), TEXT("BitstreamParserH264"));
-// 				break;
-// 		}
-
-// 		if (Result.IsNotSuccess())
-// 		{
-// 			return Result;
-// 		}
-// 	}
-
-// 	return Result;
-// }
+		switch (InNaluInfo.Type)
+		{
+			case ENaluType::SliceOfNonIdrPicture:
+			case ENaluType::SliceDataPartitionA:
+			case ENaluType::SliceIdrPicture:
+				return ParseSliceHeader(Bitstream, InNaluInfo, SPS, PPS, OutSlices.AddDefaulted_GetRef());
+			case ENaluType::SliceDataPartitionB:
+			case ENaluType::SliceDataPartitionC:
+				// Partitions B and C only carry a slice_id referring back to partition A, there is no header to parse
+				return EAVResult::Success;
+			case ENaluType::SupplementalEnhancementInformation:
+				return ParseSEI(Bitstream, InNaluInfo, OutSEI.AddDefaulted_GetRef());
+			case ENaluType::SequenceParameterSet:
+				return ParseSPS(Bitstream, InNaluInfo, SPS);
+			case ENaluType::PictureParameterSet:
+				return ParsePPS(Bitstream, InNaluInfo, SPS, PPS);
+			case ENaluType::AccessUnitDelimiter:
+			case ENaluType::EndOfSequence:
+			case ENaluType::EndOfStream:
+			case ENaluType::FillerData:
+			case ENaluType::SequenceParameterSetExtension:
+			case ENaluType::PrefixNalUnit:
+			case ENaluType::SubsetSequenceParameterSet:
+			case ENaluType::SliceOfAnAuxiliaryCoded:
+			case ENaluType::SliceExtension:
+			case ENaluType::SliceExtensionForDepthView:
+				return EAVResult::Success;
+			case ENaluType::Unspecified:
+			default:
+				return FAVResult(EAVResult::Error, FString::Printf(TEXT("Unexpected NALU type %u"), (uint8)InNaluInfo.Type), TEXT("H264"));
+		}
+	}
+
+	SPS_t const* FParserState::FindSPS(Slice_t const& Slice) const
+	{
+		PPS_t const* const FoundPPS = FindPPS(Slice);
+
+		return FoundPPS != nullptr ? SPS.Find(FoundPPS->seq_parameter_set_id) : nullptr;
+	}
+
+	void FParserState::Reset()
+	{
+		SPS.Reset();
+		PPS.Reset();
+	}
+} // namespace UE::AVCodecCore::H264
@@ -2,6 +2,7 @@
 
 #include "Video/CodecUtils/CodecUtilsH265.h"
 
+#include "Utils/StartCodeScanner.h"
 #include "Video/VideoPacket.h"
 #include "Video/Decoders/Configs/VideoDecoderConfigH265.h"
 
@@ -46,54 +47,37 @@ namespace UE::AVCodecCore::H265
 			FoundNalus.Add(Nalu);
 		}
 		
-		// Skip over stream in intervals of 3 until Data[i + 2] is either 0 or 1
-		for (int64 i = 0; i < Data.Num() - 2;)
+		for (int64 i = FindStartCode(Data.GetData(), Data.Num()); i != INDEX_NONE && i + 4 < Data.Num(); i = FindStartCode(Data.GetData(), Data.Num(), i + 3))
 		{
-			if (Data[i + 2] > 1)
+			// Found start sequence of NalU but we don't know if it has a 3 or 4 byte start code so we check.
+			FNaluH265 Nalu;
+			Nalu.StartIdx = i;
+
+			if (Nalu.StartIdx > 0 && Data[Nalu.StartIdx - 1] == 0)
 			{
-				i += 3;
+				++Nalu.StartCodeSize;
+				--Nalu.StartIdx;
 			}
-			else if (Data[i + 2] == 1)
-			{
-				if (Data[i + 1] == 0 && Data[i] == 0)
-				{
-					// Found start sequence of NalU but we don't know if it has a 3 or 4 byte start code so we check.
-					FNaluH265 Nalu;
-					Nalu.StartIdx = i;
-
-					if (Nalu.StartIdx > 0 && Data[Nalu.StartIdx - 1] == 0)
-					{
-						++Nalu.StartCodeSize;
-						--Nalu.StartIdx;
-					}
 
-					// Extract NAL Header
-					{
-						FBitstreamReader Bitstream(&Data[Nalu.StartIdx + Nalu.StartCodeSize], 1);
-						verifyf(Bitstream.ReadBits(1) == 0, TEXT("Forbidden Zero bit not Zero in NAL Header"));
-
-						Nalu.nal_unit_type = (ENaluType)Bitstream.ReadBits(6);
-						Nalu.nuh_layer_id = Bitstream.ReadBits(6);
-						Nalu.nuh_temporal_id_plus1 = Bitstream.ReadBits(3);
-					}
-
-					Nalu.EBSP = &Data[Nalu.StartIdx];
+			// Extract NAL Header
+			{
+				FBitstreamReader Bitstream(&Data[Nalu.StartIdx + Nalu.StartCodeSize], 1);
+				verifyf(Bitstream.ReadBits(1) == 0, TEXT("Forbidden Zero bit not Zero in NAL Header"));
 
-					// Update length of previous entry.
-					if (FoundNalus.Num() > 0)
-					{
-						FoundNalus.Last().Size = Nalu.StartIdx - FoundNalus.Last().StartIdx;
-					}
+				Nalu.nal_unit_type = (ENaluType)Bitstream.ReadBits(6);
+				Nalu.nuh_layer_id = Bitstream.ReadBits(6);
+				Nalu.nuh_temporal_id_plus1 = Bitstream.ReadBits(3);
+			}
 
-					FoundNalus.Add(Nalu);
-				}
+			Nalu.EBSP = &Data[Nalu.StartIdx];
 
-				i += 3;
-			}
-			else
+			// Update length of previous entry.
+			if (FoundNalus.Num() > 0)
 			{
-				++i;
+				FoundNalus.Last().Size = Nalu.StartIdx - FoundNalus.Last().StartIdx;
 			}
+
+			FoundNalus.Add(Nalu);
 		}
 
 		if (FoundNalus.Num() == 0)
@@ -104,13 +88,15 @@ namespace UE::AVCodecCore::H265
 		// Last Nal size is the remaining size of the bitstream minus a trailing zero byte
 		FoundNalus.Last().Size = Data.Num() - FoundNalus.Last().StartIdx;
 
-		// TODO (aidan) make a verbose msg
-		FAVResult::Log(EAVResult::Success, FString::Printf(TEXT("FAVExtension::TransformConfig found %d NALUs in bitdatastream"), FoundNalus.Num()));
-
-		// TODO (aidan) make a debug only verbose msg
-		for (const FNaluH265& NalUInfo : FoundNalus)
+		// This runs for every packet, so only pay for formatting when someone is actually listening
+		if (UE_LOG_ACTIVE(LogAVCodecs, VeryVerbose))
 		{
-			FAVResult::Log(EAVResult::Success, FString::Printf(TEXT("Found NALU at %llu size %llu with type %u"), NalUInfo.StartIdx, NalUInfo.Size, (uint8)NalUInfo.nal_unit_type.Value));
+			UE_LOG(LogAVCodecs, VeryVerbose, TEXT("FindNALUs found %d NALUs in bitdatastream"), FoundNalus.Num());
+
+			for (const FNaluH265& NalUInfo : FoundNalus)
+			{
+				UE_LOG(LogAVCodecs, VeryVerbose, TEXT("Found NALU at %llu size %llu with type %u"), NalUInfo.StartIdx, NalUInfo.Size, (uint8)NalUInfo.nal_unit_type.Value);
+			}
 		}
 
 		return EAVResult::Success;
@@ -372,13 +358,8 @@ namespace UE::AVCodecCore::H265
 
 	FAVResult FNaluVPS::Parse()
 	{
-		// Get Bitstream
-		TArray64<uint8> RBSP;
-		RBSP.SetNumUninitialized(Size - StartCodeSize);
-
-		// Skip start code
-		int32 RBSPsize = EBSPtoRBSP(RBSP.GetData(), EBSP + StartCodeSize, Size - StartCodeSize);
-		FBitstreamReader Bitstream(RBSP.GetData(), RBSPsize);
+		// Read straight from the EBSP, emulation prevention bytes are skipped by the reader as it goes
+		FBitstreamReader Bitstream = FBitstreamReader::FromEBSP(EBSP + StartCodeSize, Size - StartCodeSize);
 
 		// Skip NAL Header which we have already parsed 
 		Bitstream.SkipBytes(2);
@@ -808,12 +789,8 @@ namespace UE::AVCodecCore::H265
 
 	FAVResult FNaluSPS::Parse()
 	{
-		// Get Bitstream
-		TArray64<uint8> RBSP;
-		RBSP.SetNumUninitialized(Size - StartCodeSize);
-
-		int32 RBSPsize = EBSPtoRBSP(RBSP.GetData(), EBSP + StartCodeSize, Size - StartCodeSize);
-		FBitstreamReader Bitstream(RBSP.GetData(), RBSPsize);
+		// Read straight from the EBSP, emulation prevention bytes are skipped by the reader as it goes
+		FBitstreamReader Bitstream = FBitstreamReader::FromEBSP(EBSP + StartCodeSize, Size - StartCodeSize);
 
 		// Header which we have already parsed 
 		Bitstream.SkipBytes(2);
@@ -1049,12 +1026,8 @@ namespace UE::AVCodecCore::H265
 
 	FAVResult FNaluPPS::Parse()
 	{
-		// Get Bitstream
-		TArray64<uint8> RBSP;
-		RBSP.SetNumUninitialized(Size - StartCodeSize);
-
-		int32 RBSPsize = EBSPtoRBSP(RBSP.GetData(), EBSP + StartCodeSize, Size - StartCodeSize);
-		FBitstreamReader Bitstream(RBSP.GetData(), RBSPsize);
+		// Read straight from the EBSP, emulation prevention bytes are skipped by the reader as it goes
+		FBitstreamReader Bitstream = FBitstreamReader::FromEBSP(EBSP + StartCodeSize, Size - StartCodeSize);
 
 		// Skip NAL Header which we have already parsed 
 		Bitstream.SkipBytes(2);
@@ -1295,15 +1268,11 @@ namespace UE::AVCodecCore::H265
 	
 	FAVResult FNaluSlice::Parse(FVideoDecoderConfigH265* InConfig)
 	{
-		// Get Bitstream
-		TArray64<uint8> RBSP;
-		RBSP.SetNumUninitialized(Size);
-
-		int32 RBSPsize = EBSPtoRBSP(RBSP.GetData(), EBSP, Size);
-		FBitstreamReader Bitstream(RBSP.GetData(), RBSPsize);
+		// Only the header is parsed so read straight from the EBSP rather than un-escaping the whole slice payload
+		FBitstreamReader Bitstream = FBitstreamReader::FromEBSP(EBSP + StartCodeSize, Size - StartCodeSize);
 
-		// Skip NALU delimiter and NAL Header which we have already parsed 
-		Bitstream.SkipBytes(StartCodeSize + 2);
+		// Skip NAL Header which we have already parsed 
+		Bitstream.SkipBytes(2);
 
 		// Start parsing SliceHeader
 		Bitstream.Read(first_slice_segment_in_pic_flag);
@@ -1384,10 +1353,10 @@ namespace UE::AVCodecCore::H265
 
 				if (!short_term_ref_pic_set_sps_flag)
 				{
-					NumBitsForShortTermRPSInSlice = Bitstream.NumBitsRemaining();
+					NumBitsForShortTermRPSInSlice = Bitstream.NumBitsRead();
 					PinnedSPS->short_term_ref_pic_sets[PinnedSPS->num_short_term_ref_pic_sets].Parse(PinnedSPS->num_short_term_ref_pic_sets, PinnedSPS->short_term_ref_pic_sets, Bitstream);
 					PinnedSPS->short_term_ref_pic_sets[PinnedSPS->num_short_term_ref_pic_sets].CalculateValues(PinnedSPS->num_short_term_ref_pic_sets, PinnedSPS->short_term_ref_pic_sets);
-					NumBitsForShortTermRPSInSlice -= Bitstream.NumBitsRemaining();
+					NumBitsForShortTermRPSInSlice = Bitstream.NumBitsRead() - NumBitsForShortTermRPSInSlice;
 				}
 				else if (PinnedSPS->num_short_term_ref_pic_sets > 1)
 				{
@@ -1633,18 +1602,41 @@ namespace UE::AVCodecCore::H265
 
 	FAVResult FNaluSEI::Parse()
 	{
-		// Get Bitstream
-		TArray64<uint8> RBSP;
-		RBSP.SetNumUninitialized(Size - StartCodeSize);
-
-		int32 RBSPsize = EBSPtoRBSP(RBSP.GetData(), EBSP + StartCodeSize, Size - StartCodeSize);
-		FBitstreamReader Bitstream(RBSP.GetData(), RBSPsize);
+		// Read straight from the EBSP, emulation prevention bytes are skipped by the reader as it goes
+		FBitstreamReader Bitstream = FBitstreamReader::FromEBSP(EBSP + StartCodeSize, Size - StartCodeSize);
 
 		// Skip NAL Header which we have already parsed 
 		Bitstream.SkipBytes(2);
 
-		// Start parsing SEI
-		return FAVResult(EAVResult::Success, TEXT("SEI Unimplemented"));
+		return SEI::ParseMessages(Bitstream, Messages);
+	}
+
+	FAVResult InsertSEI(FVideoPacket& InOutPacket, SEI::EPayloadType PayloadType, TConstArrayView<uint8> Payload)
+	{
+		TArray<FNaluH265> FoundNalus;
+
+		FAVResult const Result = FindNALUs(InOutPacket, FoundNalus);
+		if (Result.IsNotSuccess())
+		{
+			return Result;
+		}
+
+		for (FNaluH265& Nalu : FoundNalus)
+		{
+			if (Nalu.IsSlice())
+			{
+				// Base layer, nuh_temporal_id_plus1 of 1
+				uint8 const NalHeader[] = { (uint8)((uint8)ENaluType::PREFIX_SEI_NUT << 1), 0x01 };
+
+				TArray<uint8> SEINalu;
+				SEI::MakeNalu(NalHeader, PayloadType, Payload, SEINalu);
+				SEI::InsertNalu(InOutPacket, Nalu.StartIdx, SEINalu);
+
+				return EAVResult::Success;
+			}
+		}
+
+		return FAVResult(EAVResult::Warning, TEXT("No slice to attach SEI to"), TEXT("H265"));
 	}
 
 } // namespace UE::AVCodecCore::H265
@@ -0,0 +1,185 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Video/CodecUtils/CodecUtilsSEI.h"
+
+#include "Utils/PacketBufferPool.h"
+
+namespace UE::AVCodecCore::SEI
+{
+	namespace Private
+	{
+		/*
+		 * payloadType and payloadSize are coded as a run of 0xFF bytes followed by a final byte, all summed together.
+		 */
+		uint32 ReadFFCoded(FBitstreamReader& Bitstream)
+		{
+			uint32 Value = 0;
+			for (uint32 Byte = 0xFF; Byte == 0xFF && Bitstream.NumBitsRemaining() >= 8;)
+			{
+				Byte = Bitstream.ReadBits(8);
+				Value += Byte;
+			}
+
+			return Value;
+		}
+
+		void WriteFFCoded(FBitstreamWriter& Writer, uint32 Value)
+		{
+			for (; Value >= 0xFF; Value -= 0xFF)
+			{
+				Writer.WriteBits(0xFFu, 8);
+			}
+
+			Writer.WriteBits(Value, 8);
+		}
+
+		/*
+		 * Messages are always byte aligned, so the rbsp_trailing_bits are a lone 0x80 with nothing but zero bytes after it.
+		 */
+		bool MoreRBSPData(FBitstreamReader const& Bitstream)
+		{
+			if (Bitstream.NumBytesRemaining() == 0)
+			{
+				return false;
+			}
+
+			FBitstreamReader Lookahead = Bitstream;
+			if (Lookahead.ReadBits(8) != 0x80)
+			{
+				return true;
+			}
+
+			while (Lookahead.NumBytesRemaining() > 0)
+			{
+				if (Lookahead.ReadBits(8) != 0)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void WriteInt64(TArray<uint8>& Output, int64 Value)
+		{
+			for (int32 Shift = 56; Shift >= 0; Shift -= 8)
+			{
+				Output.Add(uint8(uint64(Value) >> Shift));
+			}
+		}
+
+		int64 ReadInt64(uint8 const* Data)
+		{
+			uint64 Value = 0;
+			for (int32 i = 0; i < 8; ++i)
+			{
+				Value = (Value << 8) | Data[i];
+			}
+
+			return int64(Value);
+		}
+	} // namespace Private
+
+	FAVResult ParseMessages(FBitstreamReader& Bitstream, TArray<FMessage>& OutMessages)
+	{
+		do
+		{
+			uint32 const PayloadType = Private::ReadFFCoded(Bitstream);
+			uint32 const PayloadSize = Private::ReadFFCoded(Bitstream);
+
+			if (PayloadSize > Bitstream.NumBytesRemaining())
+			{
+				return FAVResult(EAVResult::Error, FString::Printf(TEXT("SEI payload of %u bytes runs past the end of the NALU"), PayloadSize), TEXT("SEI"));
+			}
+
+			FMessage& Message = OutMessages.AddDefaulted_GetRef();
+			Message.PayloadType = (EPayloadType)PayloadType;
+			Message.Payload.SetNumUninitialized(PayloadSize);
+
+			for (uint8& Byte : Message.Payload)
+			{
+				Byte = (uint8)Bitstream.ReadBits(8);
+			}
+		} while (Private::MoreRBSPData(Bitstream));
+
+		return EAVResult::Success;
+	}
+
+	void WriteMessage(FBitstreamWriter& Writer, EPayloadType PayloadType, TConstArrayView<uint8> Payload)
+	{
+		Private::WriteFFCoded(Writer, (uint32)PayloadType);
+		Private::WriteFFCoded(Writer, Payload.Num());
+
+		for (uint8 const Byte : Payload)
+		{
+			Writer.WriteBits(Byte, 8);
+		}
+	}
+
+	void MakeNalu(TConstArrayView<uint8> NalHeader, EPayloadType PayloadType, TConstArrayView<uint8> Payload, TArray<uint8>& OutNalu)
+	{
+		OutNalu.Append({ 0x00, 0x00, 0x00, 0x01 });
+		OutNalu.Append(NalHeader.GetData(), NalHeader.Num());
+
+		FBitstreamWriter Writer = FBitstreamWriter::ToEBSP(OutNalu);
+		WriteMessage(Writer, PayloadType, Payload);
+		Writer.WriteTrailingBits();
+	}
+
+	void InsertNalu(FVideoPacket& InOutPacket, uint64 Offset, TConstArrayView<uint8> Nalu)
+	{
+		Offset = FMath::Min(Offset, InOutPacket.DataSize);
+
+		uint8 const* const OldData = InOutPacket.DataPtr.Get();
+		uint64 const NewSize = InOutPacket.DataSize + Nalu.Num();
+
+		TSharedPtr<uint8> const NewData = FPacketBufferPool::Get().Allocate(NewSize);
+		FMemory::Memcpy(NewData.Get(), OldData, Offset);
+		FMemory::Memcpy(NewData.Get() + Offset, Nalu.GetData(), Nalu.Num());
+		FMemory::Memcpy(NewData.Get() + Offset + Nalu.Num(), OldData + Offset, InOutPacket.DataSize - Offset);
+
+		InOutPacket.DataPtr = NewData;
+		InOutPacket.DataSize = NewSize;
+	}
+
+	bool FindUserDataUnregistered(TArray<FMessage> const& Messages, uint8 const (&UUID)[UUIDSize], TConstArrayView<uint8>& OutData)
+	{
+		for (FMessage const& Message : Messages)
+		{
+			if (Message.PayloadType == EPayloadType::UserDataUnregistered && Message.Payload.Num() >= UUIDSize && FMemory::Memcmp(Message.Payload.GetData(), UUID, UUIDSize) == 0)
+			{
+				OutData = TConstArrayView<uint8>(Message.Payload.GetData() + UUIDSize, Message.Payload.Num() - UUIDSize);
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	uint8 const FFrameTiming::UUID[UUIDSize] = { 0x61, 0xAA, 0x5C, 0x14, 0x2F, 0xE5, 0x49, 0xA7, 0x98, 0xCB, 0x3E, 0x24, 0x2A, 0x43, 0x9C, 0xAE };
+
+	void FFrameTiming::Serialize(TArray<uint8>& OutPayload) const
+	{
+		OutPayload.Append(UUID, UUIDSize);
+
+		Private::WriteInt64(OutPayload, CaptureTimeUs);
+		Private::WriteInt64(OutPayload, EncodeStartTimeUs);
+		Private::WriteInt64(OutPayload, EncodeEndTimeUs);
+	}
+
+	bool FFrameTiming::Deserialize(TArray<FMessage> const& Messages)
+	{
+		TConstArrayView<uint8> Data;
+		if (!FindUserDataUnregistered(Messages, UUID, Data) || Data.Num() < 3 * sizeof(int64))
+		{
+			return false;
+		}
+
+		CaptureTimeUs = Private::ReadInt64(Data.GetData());
+		EncodeStartTimeUs = Private::ReadInt64(Data.GetData() + 8);
+		EncodeEndTimeUs = Private::ReadInt64(Data.GetData() + 16);
+
+		return true;
+	}
+} // namespace UE::AVCodecCore::SEI
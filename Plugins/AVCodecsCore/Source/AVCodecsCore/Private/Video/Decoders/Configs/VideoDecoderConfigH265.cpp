@@ -3,10 +3,41 @@
 #include "Video/Decoders/Configs/VideoDecoderConfigH265.h"
 
 #include "AVUtility.h"
+#include "Hash/CityHash.h"
 #include "Video/CodecUtils/CodecUtilsH265.h"
 
 REGISTER_TYPEID(FVideoDecoderConfigH265);
 
+namespace UE::AVCodecCore::H265::Private
+{
+	/*
+	 * Parameter sets are resent with every keyframe but almost never change within a session, so only parse one if we haven't already parsed the exact same bytes.
+	 */
+	template <typename TNalu>
+	TSharedPtr<TNalu> FindOrParseParameterSet(TMap<uint32, TSharedPtr<TNalu>> const& ParsedSets, FNaluH265& Nalu, bool& bOutParsed)
+	{
+		Nalu.ContentHash = CityHash64(reinterpret_cast<char const*>(Nalu.EBSP + Nalu.StartCodeSize), Nalu.Size - Nalu.StartCodeSize);
+
+		for (TPair<uint32, TSharedPtr<TNalu>> const& ParsedSet : ParsedSets)
+		{
+			if (ParsedSet.Value->ContentHash == Nalu.ContentHash)
+			{
+				// The parsed members are still valid but the position members need to point into the packet we just received
+				static_cast<FNaluH265&>(*ParsedSet.Value) = Nalu;
+
+				bOutParsed = false;
+				return ParsedSet.Value;
+			}
+		}
+
+		TSharedPtr<TNalu> ParsedSet = MakeShared<TNalu>(Nalu);
+		ParsedSet->Parse();
+
+		bOutParsed = true;
+		return ParsedSet;
+	}
+} // namespace UE::AVCodecCore::H265::Private
+
 FAVResult FVideoDecoderConfigH265::Parse(TSharedRef<FAVInstance> const& Instance, FVideoPacket const& Packet, TArray<TSharedPtr<UE::AVCodecCore::H265::FNaluH265>>& Nalus)
 {
 	using namespace UE::AVCodecCore::H265;
@@ -25,6 +56,10 @@ FAVResult FVideoDecoderConfigH265::Parse(TSharedRef<FAVInstance> const& Instance
 	TSharedPtr<FNaluVPS> CandidateVPS;
 	TSharedPtr<FNaluSPS> CandidateSPS;
 	TSharedPtr<FNaluPPS> CandidatePPS;
+	bool bParsedParameterSet = false;
+
+	// SEI only applies to the access unit it arrived with
+	H265.ParsedSEI.Reset();
 
 	for (auto& Nalu : FoundNalus)
 	{
@@ -105,25 +140,32 @@ FAVResult FVideoDecoderConfigH265::Parse(TSharedRef<FAVInstance> const& Instance
 				checkNoEntry(); // Reserved
 				break;
 			case ENaluType::VPS_NUT:
-				CandidateVPS = MakeShared<FNaluVPS>(Nalu);
-				CandidateVPS->Parse();
-				H265.ParsedVPS.Add(CandidateVPS->vps_video_parameter_set_id, CandidateVPS);
+				CandidateVPS = Private::FindOrParseParameterSet(H265.ParsedVPS, Nalu, bParsedParameterSet);
+				if (bParsedParameterSet)
+				{
+					H265.ParsedVPS.Add(CandidateVPS->vps_video_parameter_set_id, CandidateVPS);
+				}
 				Nalus.Add(CandidateVPS);
-				UE_LOG(LogTemp, Verbose, TEXT("H256 Parsing: Recieved VPS %u"), CandidateVPS->vps_video_parameter_set_id.Value);
+				UE_LOG(LogTemp, Verbose, TEXT("H256 Parsing: Recieved %s VPS %u"), bParsedParameterSet ? TEXT("new") : TEXT("cached"), CandidateVPS->vps_video_parameter_set_id.Value);
 				break;
 			case ENaluType::SPS_NUT:
-				CandidateSPS = MakeShared<FNaluSPS>(Nalu);
-				CandidateSPS->Parse();
-				H265.ParsedSPS.Add(CandidateSPS->sps_video_parameter_set_id, CandidateSPS);
+				CandidateSPS = Private::FindOrParseParameterSet(H265.ParsedSPS, Nalu, bParsedParameterSet);
+				if (bParsedParameterSet)
+				{
+					// Slices find their SPS through pps_seq_parameter_set_id so this needs to be keyed on the SPS id rather than the VPS id
+					H265.ParsedSPS.Add(CandidateSPS->sps_seq_parameter_set_id, CandidateSPS);
+				}
 				Nalus.Add(CandidateSPS);
-				UE_LOG(LogTemp, Verbose, TEXT("H256 Parsing: Recieved SPS %u"), CandidateSPS->sps_video_parameter_set_id.Value);
+				UE_LOG(LogTemp, Verbose, TEXT("H256 Parsing: Recieved %s SPS %u"), bParsedParameterSet ? TEXT("new") : TEXT("cached"), CandidateSPS->sps_seq_parameter_set_id.Value);
 				break;
 			case ENaluType::PPS_NUT:
-				CandidatePPS = MakeShared<FNaluPPS>(Nalu);
-				CandidatePPS->Parse();
-				H265.ParsedPPS.Add(CandidatePPS->pps_pic_parameter_set_id, CandidatePPS);
+				CandidatePPS = Private::FindOrParseParameterSet(H265.ParsedPPS, Nalu, bParsedParameterSet);
+				if (bParsedParameterSet)
+				{
+					H265.ParsedPPS.Add(CandidatePPS->pps_pic_parameter_set_id, CandidatePPS);
+				}
 				Nalus.Add(CandidatePPS);
-				UE_LOG(LogTemp, Verbose, TEXT("H256 Parsing: Recieved PPS %u"), CandidatePPS->pps_pic_parameter_set_id.Value);
+				UE_LOG(LogTemp, Verbose, TEXT("H256 Parsing: Recieved %s PPS %u"), bParsedParameterSet ? TEXT("new") : TEXT("cached"), CandidatePPS->pps_pic_parameter_set_id.Value);
 				break;
 			case ENaluType::AUD_NUT:
 				Nalus.Add(MakeShared<FNaluH265>(Nalu));
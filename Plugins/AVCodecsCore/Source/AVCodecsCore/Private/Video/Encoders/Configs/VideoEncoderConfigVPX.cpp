@@ -0,0 +1,7 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Video/Encoders/Configs/VideoEncoderConfigVPX.h"
+
+#include "AVUtility.h"
+
+REGISTER_TYPEID(FVideoEncoderConfigVPX);
@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Video/Encoders/VideoEncodeAdmission.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+FVideoEncodeAdmission::FVideoEncodeAdmission(int32 InMaxFramesInFlight, int32 InHistorySize)
+	: MaxFramesInFlight(InMaxFramesInFlight)
+	, HistorySize(FMath::Max(InHistorySize, 1))
+{
+	History.Reserve(HistorySize);
+}
+
+bool FVideoEncodeAdmission::Admit(bool bKeyframe, double FrameIntervalSeconds)
+{
+	double const Now = FPlatformTime::Seconds();
+
+	FScopeLock const Lock(&Guard);
+
+	// The encoder works through frames one at a time, so this one starts once everything ahead of it is done
+	double const StartTime = FMath::Max(Now, BusyUntil);
+	double const FinishTime = StartTime + GetAverageEncodeSecondsLocked();
+
+	bool const bHasRoom = MaxFramesInFlight <= 0 || FramesInFlight < MaxFramesInFlight;
+	bool const bOnTime = FinishTime <= Now + FrameIntervalSeconds;
+
+	if (bKeyframe || FramesInFlight == 0 || (bHasRoom && bOnTime))
+	{
+		FramesInFlight++;
+		BusyUntil = FinishTime;
+		Admitted++;
+
+		return true;
+	}
+
+	Dropped++;
+
+	return false;
+}
+
+void FVideoEncodeAdmission::OnEncodeFinished(double EncodeSeconds)
+{
+	FScopeLock const Lock(&Guard);
+
+	if (History.Num() < HistorySize)
+	{
+		History.Add(EncodeSeconds);
+	}
+	else
+	{
+		HistorySum -= History[HistoryNext];
+		History[HistoryNext] = EncodeSeconds;
+	}
+
+	HistorySum += EncodeSeconds;
+	HistoryNext = (HistoryNext + 1) % HistorySize;
+
+	FramesInFlight = FMath::Max(FramesInFlight - 1, 0);
+
+	// Nothing left to wait on, so forget whatever was predicted for it
+	if (FramesInFlight == 0)
+	{
+		BusyUntil = 0.0;
+	}
+}
+
+void FVideoEncodeAdmission::OnEncodeAbandoned()
+{
+	FScopeLock const Lock(&Guard);
+
+	FramesInFlight = FMath::Max(FramesInFlight - 1, 0);
+
+	if (FramesInFlight == 0)
+	{
+		BusyUntil = 0.0;
+	}
+}
+
+int32 FVideoEncodeAdmission::NumFramesInFlight() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return FramesInFlight;
+}
+
+uint64 FVideoEncodeAdmission::NumAdmitted() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return Admitted;
+}
+
+uint64 FVideoEncodeAdmission::NumDropped() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return Dropped;
+}
+
+double FVideoEncodeAdmission::GetAverageEncodeSeconds() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return GetAverageEncodeSecondsLocked();
+}
+
+double FVideoEncodeAdmission::GetAverageEncodeSecondsLocked() const
+{
+	return History.Num() > 0 ? HistorySum / History.Num() : 0.0;
+}
@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Video/Encoders/VideoEncodePipeline.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+
+FVideoEncodePipeline::FStage::FStage(FString const& Name)
+	: TasksPending(FPlatformProcess::GetSynchEventFromPool(false))
+{
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		Thread = FRunnableThread::Create(this, *Name, 0, TPri_AboveNormal);
+	}
+}
+
+FVideoEncodePipeline::FStage::~FStage()
+{
+	if (Thread != nullptr)
+	{
+		// Kill stops the runnable and waits for it, which drains whatever is still queued
+		Thread->Kill(true);
+
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(TasksPending);
+	TasksPending = nullptr;
+}
+
+void FVideoEncodePipeline::FStage::Enqueue(TUniqueFunction<void()>&& Task)
+{
+	Tasks.Enqueue(MoveTemp(Task));
+	TasksPending->Trigger();
+}
+
+uint32 FVideoEncodePipeline::FStage::Run()
+{
+	while (true)
+	{
+		TUniqueFunction<void()> Task;
+		while (Tasks.Dequeue(Task))
+		{
+			Task();
+		}
+
+		if (bStopping)
+		{
+			break;
+		}
+
+		TasksPending->Wait();
+	}
+
+	return 0;
+}
+
+void FVideoEncodePipeline::FStage::Stop()
+{
+	bStopping = true;
+	TasksPending->Trigger();
+}
+
+FVideoEncodePipeline::FVideoEncodePipeline(int32 InMaxFramesInFlight, FString const& Name)
+	: MaxFramesInFlight(FMath::Max(InMaxFramesInFlight, 1))
+	, FrameDelivered(FPlatformProcess::GetSynchEventFromPool(false))
+	, CompleteStage(MakeUnique<FStage>(Name + TEXT(" Complete")))
+	, EncodeStage(MakeUnique<FStage>(Name + TEXT(" Encode")))
+{
+}
+
+FVideoEncodePipeline::~FVideoEncodePipeline()
+{
+	// Encode first, as draining it can still hand work to the completion stage
+	EncodeStage.Reset();
+	CompleteStage.Reset();
+
+	FPlatformProcess::ReturnSynchEventToPool(FrameDelivered);
+	FrameDelivered = nullptr;
+}
+
+bool FVideoEncodePipeline::Submit(FEncodeFunc&& Encode)
+{
+	if (!EncodeStage->IsRunning() || !CompleteStage->IsRunning())
+	{
+		return false;
+	}
+
+	while (FramesInFlight.GetValue() >= MaxFramesInFlight)
+	{
+		FrameDelivered->Wait();
+	}
+
+	FramesInFlight.Increment();
+
+	EncodeStage->Enqueue([this, Encode = MoveTemp(Encode)]() mutable {
+		FCompleteFunc Complete = Encode();
+
+		CompleteStage->Enqueue([this, Complete = MoveTemp(Complete)]() mutable {
+			if (Complete)
+			{
+				Complete();
+			}
+
+			OnFrameDelivered();
+		});
+	});
+
+	return true;
+}
+
+void FVideoEncodePipeline::Flush()
+{
+	while (FramesInFlight.GetValue() > 0)
+	{
+		FrameDelivered->Wait();
+	}
+}
+
+void FVideoEncodePipeline::OnFrameDelivered()
+{
+	FramesInFlight.Decrement();
+	FrameDelivered->Trigger();
+}
@@ -0,0 +1,237 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Video/Encoders/VideoEncodeSession.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+FVideoEncodeSession::FVideoEncodeSession(EVideoEncodeRatePolicy InRatePolicy, FVideoKeyframeArbiter const& InKeyframeArbiter, TUniquePtr<FVideoEncodeAdmission> InAdmission)
+	: RatePolicy(InRatePolicy)
+	, KeyframeArbiter(InKeyframeArbiter)
+	, Admission(MoveTemp(InAdmission))
+{
+}
+
+void FVideoEncodeSession::Subscribe(void const* Subscriber)
+{
+	FScopeLock const Lock(&Guard);
+
+	Subscribers.FindOrAdd(Subscriber);
+}
+
+void FVideoEncodeSession::Unsubscribe(void const* Subscriber)
+{
+	FScopeLock const Lock(&Guard);
+
+	Subscribers.Remove(Subscriber);
+}
+
+int32 FVideoEncodeSession::NumSubscribers() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return Subscribers.Num();
+}
+
+void FVideoEncodeSession::SetRate(void const* Subscriber, FRate const& Rate)
+{
+	FScopeLock const Lock(&Guard);
+
+	Subscribers.FindOrAdd(Subscriber).Rate = Rate;
+}
+
+TOptional<FVideoEncodeSession::FRate> FVideoEncodeSession::GetRate() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return GetRateLocked();
+}
+
+TOptional<FVideoEncodeSession::FRate> FVideoEncodeSession::TakeRateChange()
+{
+	FScopeLock const Lock(&Guard);
+
+	TOptional<FRate> const Rate = GetRateLocked();
+	if (!Rate.IsSet() || (LastTakenRate.IsSet() && *LastTakenRate == *Rate))
+	{
+		return {};
+	}
+
+	LastTakenRate = Rate;
+
+	return Rate;
+}
+
+void FVideoEncodeSession::RestoreRateChange(FRate const& Rate)
+{
+	FScopeLock const Lock(&Guard);
+
+	// Anything taken since has replaced it, and is still on its way to the encoder
+	if (LastTakenRate.IsSet() && *LastTakenRate == Rate)
+	{
+		LastTakenRate.Reset();
+	}
+}
+
+void FVideoEncodeSession::SetAppliedRate(FRate const& Rate)
+{
+	FScopeLock const Lock(&Guard);
+
+	AppliedRate = Rate;
+}
+
+void FVideoEncodeSession::SeedAppliedRate(FRate const& Rate)
+{
+	FScopeLock const Lock(&Guard);
+
+	if (!AppliedRate.IsSet())
+	{
+		AppliedRate = Rate;
+	}
+}
+
+TOptional<FVideoEncodeSession::FRate> FVideoEncodeSession::GetAppliedRate() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return AppliedRate;
+}
+
+void FVideoEncodeSession::RequestKeyframe(void const* Subscriber)
+{
+	double const Now = FPlatformTime::Seconds();
+
+	FScopeLock const Lock(&Guard);
+
+	// A subscriber without a keyframe joined after the last one went out, so however recent it was it answers nothing for them
+	FSubscriber const* const Found = Subscriber != nullptr ? Subscribers.Find(Subscriber) : nullptr;
+	bool const bMissedLastKeyframe = Found != nullptr && !Found->bHasKeyframe;
+	KeyframeArbiter.Request(Now, Found == nullptr || !Found->bHasKeyframe, bMissedLastKeyframe);
+}
+
+bool FVideoEncodeSession::IsKeyframeRequested() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return KeyframeArbiter.HasPendingRequest();
+}
+
+EVideoKeyframeDecision FVideoEncodeSession::TakeKeyframeRequest()
+{
+	double const Now = FPlatformTime::Seconds();
+
+	FScopeLock const Lock(&Guard);
+
+	return KeyframeArbiter.Decide(Now);
+}
+
+void FVideoEncodeSession::OnKeyframeEncoded()
+{
+	double const Now = FPlatformTime::Seconds();
+
+	FScopeLock const Lock(&Guard);
+
+	KeyframeArbiter.OnKeyframe(Now);
+
+	for (TPair<void const*, FSubscriber>& Subscriber : Subscribers)
+	{
+		Subscriber.Value.bHasKeyframe = true;
+	}
+}
+
+bool FVideoEncodeSession::ClaimFrame(uint64 FrameKey)
+{
+	FScopeLock const Lock(&Guard);
+
+	for (int32 i = 0; i < NumRecent; ++i)
+	{
+		if (RecentFrames[i] == FrameKey)
+		{
+			FramesShared++;
+
+			return false;
+		}
+	}
+
+	RecentFrames[RecentNext] = FrameKey;
+	RecentNext = (RecentNext + 1) % NumRecentFrames;
+	NumRecent = FMath::Min(NumRecent + 1, NumRecentFrames);
+
+	FramesClaimed++;
+
+	return true;
+}
+
+uint64 FVideoEncodeSession::NumFramesClaimed() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return FramesClaimed;
+}
+
+uint64 FVideoEncodeSession::NumFramesShared() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return FramesShared;
+}
+
+uint64 FVideoEncodeSession::NumKeyframeRequests() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return KeyframeArbiter.NumRequests();
+}
+
+uint64 FVideoEncodeSession::NumKeyframesTaken() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return KeyframeArbiter.NumKeyframes();
+}
+
+uint64 FVideoEncodeSession::NumIntraRefreshesTaken() const
+{
+	FScopeLock const Lock(&Guard);
+
+	return KeyframeArbiter.NumIntraRefreshes();
+}
+
+TOptional<FVideoEncodeSession::FRate> FVideoEncodeSession::GetRateLocked() const
+{
+	int32 NumRates = 0;
+	int64 BitrateSum = 0;
+	double FramerateSum = 0.0;
+	FRate Minimum = { MAX_int32, TNumericLimits<double>::Max() };
+
+	for (TPair<void const*, FSubscriber> const& Subscriber : Subscribers)
+	{
+		TOptional<FRate> const& SubscriberRate = Subscriber.Value.Rate;
+		if (!SubscriberRate.IsSet() || SubscriberRate->Bitrate <= 0)
+		{
+			continue;
+		}
+
+		FRate const& Rate = *SubscriberRate;
+
+		NumRates++;
+		BitrateSum += Rate.Bitrate;
+		FramerateSum += Rate.Framerate;
+		Minimum.Bitrate = FMath::Min(Minimum.Bitrate, Rate.Bitrate);
+		Minimum.Framerate = FMath::Min(Minimum.Framerate, Rate.Framerate);
+	}
+
+	if (NumRates == 0)
+	{
+		return {};
+	}
+
+	switch (RatePolicy)
+	{
+		case EVideoEncodeRatePolicy::Average:
+			return FRate{ static_cast<int32>(BitrateSum / NumRates), FramerateSum / NumRates };
+		case EVideoEncodeRatePolicy::Minimum:
+		default:
+			return Minimum;
+	}
+}
@@ -0,0 +1,453 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Video/Encoders/VideoEncoderVPX.h"
+
+#include "Utils/PacketBufferPool.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "vpx/vp8cx.h"
+#include "vpx/vpx_encoder.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace VideoEncoderVPXPrivate
+{
+	// libvpx quantizers run from 0 to 63, the generic config uses the H.264 range of 0 to 51
+	uint32 ConvertQP(int32 QP)
+	{
+		return FMath::Clamp(QP * 63 / 51, 0, 63);
+	}
+
+	bool NeedsReinitialize(FVideoEncoderConfigVPX const& Applied, FVideoEncoderConfigVPX const& Pending)
+	{
+		return Applied.Version != Pending.Version
+			|| Applied.Width != Pending.Width
+			|| Applied.Height != Pending.Height
+			|| Applied.TargetFramerate != Pending.TargetFramerate
+			|| Applied.NumThreads != Pending.NumThreads;
+	}
+
+	bool NeedsReconfigure(FVideoEncoderConfigVPX const& Applied, FVideoEncoderConfigVPX const& Pending)
+	{
+		return Applied.TargetBitrate != Pending.TargetBitrate
+			|| Applied.MaxBitrate != Pending.MaxBitrate
+			|| Applied.MinQP != Pending.MinQP
+			|| Applied.MaxQP != Pending.MaxQP
+			|| Applied.RateControlMode != Pending.RateControlMode
+			|| Applied.KeyframeInterval != Pending.KeyframeInterval
+			|| Applied.CpuUsed != Pending.CpuUsed;
+	}
+
+	void SetRateControl(vpx_codec_enc_cfg_t& OutConfig, FVideoEncoderConfigVPX const& Config)
+	{
+		switch (Config.RateControlMode)
+		{
+			case ERateControlMode::ConstQP:
+				OutConfig.rc_end_usage = VPX_Q;
+				break;
+			case ERateControlMode::VBR:
+				OutConfig.rc_end_usage = VPX_VBR;
+				break;
+			case ERateControlMode::CBR:
+			default:
+				OutConfig.rc_end_usage = VPX_CBR;
+				break;
+		}
+
+		OutConfig.rc_target_bitrate = FMath::Max(Config.TargetBitrate / 1000, 1);
+
+		// libvpx has no peak bitrate, so let VBR overshoot the target by as much as the maximum allows
+		if (Config.RateControlMode == ERateControlMode::VBR && Config.MaxBitrate > Config.TargetBitrate && Config.TargetBitrate > 0)
+		{
+			OutConfig.rc_overshoot_pct = FMath::Min<int64>((int64)(Config.MaxBitrate - Config.TargetBitrate) * 100 / Config.TargetBitrate, 1000);
+		}
+
+		if (Config.MinQP >= 0)
+		{
+			OutConfig.rc_min_quantizer = ConvertQP(Config.MinQP);
+		}
+
+		if (Config.MaxQP >= 0)
+		{
+			OutConfig.rc_max_quantizer = FMath::Max(ConvertQP(Config.MaxQP), OutConfig.rc_min_quantizer);
+		}
+
+		if (Config.KeyframeInterval > 0)
+		{
+			OutConfig.kf_mode = VPX_KF_AUTO;
+			OutConfig.kf_max_dist = Config.KeyframeInterval;
+		}
+		else
+		{
+			// Keyframes are left to whoever forces them, as with the hardware encoders
+			OutConfig.kf_mode = VPX_KF_DISABLED;
+		}
+	}
+
+	// BT.601 limited range, the same conversion the hardware encoders apply to BGRA input
+	FORCEINLINE uint8 RGBToY(int32 R, int32 G, int32 B) { return (uint8)(((66 * R + 129 * G + 25 * B + 128) >> 8) + 16); }
+	FORCEINLINE uint8 RGBToU(int32 R, int32 G, int32 B) { return (uint8)(((-38 * R - 74 * G + 112 * B + 128) >> 8) + 128); }
+	FORCEINLINE uint8 RGBToV(int32 R, int32 G, int32 B) { return (uint8)(((112 * R - 94 * G - 18 * B + 128) >> 8) + 128); }
+
+	void ConvertBGRA(uint8 const* Src, uint32 SrcStride, uint32 Width, uint32 Height, vpx_image_t& Dst)
+	{
+		for (uint32 y = 0; y < Height; ++y)
+		{
+			uint8 const* Row = Src + (uint64)y * SrcStride;
+			uint8* YRow = Dst.planes[VPX_PLANE_Y] + (uint64)y * Dst.stride[VPX_PLANE_Y];
+
+			for (uint32 x = 0; x < Width; ++x)
+			{
+				YRow[x] = RGBToY(Row[x * 4 + 2], Row[x * 4 + 1], Row[x * 4 + 0]);
+			}
+		}
+
+		// Chroma is the average of each 2x2 block, odd edges repeat their last pixel
+		for (uint32 y = 0; y < (Height + 1) / 2; ++y)
+		{
+			uint8 const* Row0 = Src + (uint64)(y * 2) * SrcStride;
+			uint8 const* Row1 = Src + (uint64)FMath::Min(y * 2 + 1, Height - 1) * SrcStride;
+			uint8* URow = Dst.planes[VPX_PLANE_U] + (uint64)y * Dst.stride[VPX_PLANE_U];
+			uint8* VRow = Dst.planes[VPX_PLANE_V] + (uint64)y * Dst.stride[VPX_PLANE_V];
+
+			for (uint32 x = 0; x < (Width + 1) / 2; ++x)
+			{
+				uint32 const X0 = x * 2 * 4;
+				uint32 const X1 = FMath::Min(x * 2 + 1, Width - 1) * 4;
+
+				int32 const B = (Row0[X0 + 0] + Row0[X1 + 0] + Row1[X0 + 0] + Row1[X1 + 0] + 2) >> 2;
+				int32 const G = (Row0[X0 + 1] + Row0[X1 + 1] + Row1[X0 + 1] + Row1[X1 + 1] + 2) >> 2;
+				int32 const R = (Row0[X0 + 2] + Row0[X1 + 2] + Row1[X0 + 2] + Row1[X1 + 2] + 2) >> 2;
+
+				URow[x] = RGBToU(R, G, B);
+				VRow[x] = RGBToV(R, G, B);
+			}
+		}
+	}
+
+	void ConvertNV12(uint8 const* Src, uint32 SrcStride, uint32 Width, uint32 Height, vpx_image_t& Dst)
+	{
+		for (uint32 y = 0; y < Height; ++y)
+		{
+			FMemory::Memcpy(Dst.planes[VPX_PLANE_Y] + (uint64)y * Dst.stride[VPX_PLANE_Y], Src + (uint64)y * SrcStride, Width);
+		}
+
+		// Interleaved UV follows the luma plane
+		uint8 const* const SrcUV = Src + (uint64)Height * SrcStride;
+		for (uint32 y = 0; y < (Height + 1) / 2; ++y)
+		{
+			uint8 const* UVRow = SrcUV + (uint64)y * SrcStride;
+			uint8* URow = Dst.planes[VPX_PLANE_U] + (uint64)y * Dst.stride[VPX_PLANE_U];
+			uint8* VRow = Dst.planes[VPX_PLANE_V] + (uint64)y * Dst.stride[VPX_PLANE_V];
+
+			for (uint32 x = 0; x < (Width + 1) / 2; ++x)
+			{
+				URow[x] = UVRow[x * 2 + 0];
+				VRow[x] = UVRow[x * 2 + 1];
+			}
+		}
+	}
+} // namespace VideoEncoderVPXPrivate
+
+struct FVideoEncoderVPX::FCodec
+{
+	vpx_codec_ctx_t Context;
+	vpx_codec_enc_cfg_t Config;
+	vpx_image_t Image;
+
+	bool bContextInitialized = false;
+	bool bImageAllocated = false;
+
+	~FCodec()
+	{
+		if (bContextInitialized)
+		{
+			vpx_codec_err_t const Result = vpx_codec_destroy(&Context);
+			if (Result != VPX_CODEC_OK)
+			{
+				FAVResult::Log(EAVResult::ErrorDestroying, TEXT("Failed to destroy encoder"), TEXT("VPX"), Result);
+			}
+		}
+
+		if (bImageAllocated)
+		{
+			vpx_img_free(&Image);
+		}
+	}
+};
+
+FVideoEncoderVPX::FVideoEncoderVPX()
+	: bOpen(false)
+{
+}
+
+FVideoEncoderVPX::~FVideoEncoderVPX()
+{
+	Close();
+}
+
+bool FVideoEncoderVPX::IsOpen() const
+{
+	return bOpen;
+}
+
+FAVResult FVideoEncoderVPX::Open(TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance)
+{
+	Close();
+
+	TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>::Open(NewDevice, NewInstance);
+
+	FrameCount = 0;
+	bOpen = true;
+
+	return EAVResult::Success;
+}
+
+void FVideoEncoderVPX::Close()
+{
+	if (IsOpen())
+	{
+		Codec.Reset();
+		Packets.Empty();
+
+		bOpen = false;
+	}
+}
+
+bool FVideoEncoderVPX::IsInitialized() const
+{
+	return Codec.IsValid();
+}
+
+FAVResult FVideoEncoderVPX::ApplyConfig()
+{
+	using namespace VideoEncoderVPXPrivate;
+
+	if (IsOpen())
+	{
+		FVideoEncoderConfigVPX const& PendingConfig = this->GetPendingConfig();
+
+		if (IsInitialized())
+		{
+			if (NeedsReinitialize(AppliedConfig, PendingConfig))
+			{
+				Codec.Reset();
+			}
+			else if (NeedsReconfigure(AppliedConfig, PendingConfig))
+			{
+				SetRateControl(Codec->Config, PendingConfig);
+
+				vpx_codec_err_t Result = vpx_codec_enc_config_set(&Codec->Context, &Codec->Config);
+				if (Result != VPX_CODEC_OK)
+				{
+					return FAVResult(EAVResult::Error, TEXT("Failed to reconfigure encoder"), TEXT("VPX"), Result);
+				}
+
+				Result = vpx_codec_control(&Codec->Context, VP8E_SET_CPUUSED, PendingConfig.CpuUsed);
+				if (Result != VPX_CODEC_OK)
+				{
+					return FAVResult(EAVResult::Error, TEXT("Failed to set encoder speed"), TEXT("VPX"), Result);
+				}
+
+				if (PendingConfig.RateControlMode == ERateControlMode::ConstQP)
+				{
+					vpx_codec_control(&Codec->Context, VP8E_SET_CQ_LEVEL, Codec->Config.rc_min_quantizer);
+				}
+			}
+		}
+
+		if (!IsInitialized())
+		{
+			if (PendingConfig.Width == 0 || PendingConfig.Height == 0)
+			{
+				return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder needs a frame size"), TEXT("VPX"));
+			}
+
+			TUniquePtr<FCodec> NewCodec = MakeUnique<FCodec>();
+
+			vpx_codec_iface_t* const Interface = PendingConfig.Version == EVPXVersion::VP9 ? vpx_codec_vp9_cx() : vpx_codec_vp8_cx();
+
+			vpx_codec_err_t Result = vpx_codec_enc_config_default(Interface, &NewCodec->Config, 0);
+			if (Result != VPX_CODEC_OK)
+			{
+				return FAVResult(EAVResult::ErrorCreating, TEXT("Failed to get default encoder config"), TEXT("VPX"), Result);
+			}
+
+			NewCodec->Config.g_w = PendingConfig.Width;
+			NewCodec->Config.g_h = PendingConfig.Height;
+			NewCodec->Config.g_timebase.num = 1;
+			NewCodec->Config.g_timebase.den = FMath::Max(PendingConfig.TargetFramerate, 1u);
+			NewCodec->Config.g_threads = PendingConfig.NumThreads > 0 ? PendingConfig.NumThreads : FMath::Clamp<uint32>(FPlatformMisc::NumberOfCores() / 2, 1, PendingConfig.Width / 320 + 1);
+			NewCodec->Config.g_lag_in_frames = 0;
+			NewCodec->Config.g_error_resilient = VPX_ERROR_RESILIENT_DEFAULT;
+			NewCodec->Config.g_pass = VPX_RC_ONE_PASS;
+			NewCodec->Config.rc_dropframe_thresh = 0;
+			NewCodec->Config.rc_resize_allowed = 0;
+
+			SetRateControl(NewCodec->Config, PendingConfig);
+
+			Result = vpx_codec_enc_init(&NewCodec->Context, Interface, &NewCodec->Config, 0);
+			if (Result != VPX_CODEC_OK)
+			{
+				return FAVResult(EAVResult::ErrorCreating, TEXT("Failed to initialize encoder"), TEXT("VPX"), Result);
+			}
+
+			NewCodec->bContextInitialized = true;
+
+			vpx_codec_control(&NewCodec->Context, VP8E_SET_CPUUSED, PendingConfig.CpuUsed);
+			vpx_codec_control(&NewCodec->Context, VP8E_SET_STATIC_THRESHOLD, 1);
+
+			if (PendingConfig.RateControlMode == ERateControlMode::ConstQP)
+			{
+				vpx_codec_control(&NewCodec->Context, VP8E_SET_CQ_LEVEL, NewCodec->Config.rc_min_quantizer);
+			}
+
+			if (PendingConfig.Version == EVPXVersion::VP9)
+			{
+				vpx_codec_control(&NewCodec->Context, VP9E_SET_AQ_MODE, 3);
+				vpx_codec_control(&NewCodec->Context, VP9E_SET_ROW_MT, 1);
+			}
+
+			if (vpx_img_alloc(&NewCodec->Image, VPX_IMG_FMT_I420, PendingConfig.Width, PendingConfig.Height, 16) == nullptr)
+			{
+				return FAVResult(EAVResult::ErrorCreating, TEXT("Failed to allocate encoder input"), TEXT("VPX"));
+			}
+
+			NewCodec->bImageAllocated = true;
+
+			Codec = MoveTemp(NewCodec);
+		}
+
+		return TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>::ApplyConfig();
+	}
+
+	return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"), TEXT("VPX"));
+}
+
+FAVResult FVideoEncoderVPX::SendFrame(TSharedPtr<FVideoResourceCPU> const& Resource, uint64 Timestamp, bool bForceKeyframe, uint64 UserData)
+{
+	using namespace VideoEncoderVPXPrivate;
+
+	if (IsOpen())
+	{
+		// An invalid resource flushes whatever is left and tears the encoder down until the next frame
+		if (!Resource.IsValid())
+		{
+			if (IsInitialized())
+			{
+				FAVResult const Result = Encode(nullptr, 0, false, 0);
+
+				Codec.Reset();
+
+				return Result;
+			}
+
+			return EAVResult::Success;
+		}
+
+		FVideoDescriptor const& Descriptor = Resource->GetDescriptor();
+
+		// Follow the size of the frames we are given rather than failing on a mismatch
+		if (Descriptor.Width != GetPendingConfig().Width || Descriptor.Height != GetPendingConfig().Height)
+		{
+			EditPendingConfig().Width = Descriptor.Width;
+			EditPendingConfig().Height = Descriptor.Height;
+		}
+
+		FAVResult Result = ApplyConfig();
+		if (Result.IsNotSuccess())
+		{
+			return Result;
+		}
+
+		FScopeLock const ResourceLock = Resource->LockScope();
+
+		uint8 const* const Raw = Resource->GetRaw().Get();
+		if (Raw == nullptr)
+		{
+			return FAVResult(EAVResult::ErrorInvalidState, TEXT("Frame has no data"), TEXT("VPX"));
+		}
+
+		switch (Descriptor.Format)
+		{
+			case EVideoFormat::BGRA:
+				ConvertBGRA(Raw, Resource->GetStride() > 0 ? Resource->GetStride() : Descriptor.Width * 4, Descriptor.Width, Descriptor.Height, Codec->Image);
+				break;
+			case EVideoFormat::NV12:
+				ConvertNV12(Raw, Resource->GetStride() > 0 ? Resource->GetStride() : Descriptor.Width, Descriptor.Width, Descriptor.Height, Codec->Image);
+				break;
+			default:
+				return FAVResult(EAVResult::ErrorUnsupported, FString::Printf(TEXT("Unsupported frame format %d"), static_cast<int32>(Descriptor.Format)), TEXT("VPX"));
+		}
+
+		return Encode(&Codec->Image, Timestamp, bForceKeyframe, UserData);
+	}
+
+	return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"), TEXT("VPX"));
+}
+
+FAVResult FVideoEncoderVPX::Encode(vpx_image const* Image, uint64 Timestamp, bool bForceKeyframe, uint64 UserData)
+{
+	vpx_codec_err_t Result = vpx_codec_encode(&Codec->Context, Image, FrameCount, 1, bForceKeyframe ? VPX_EFLAG_FORCE_KF : 0, VPX_DL_REALTIME);
+	if (Result != VPX_CODEC_OK)
+	{
+		return FAVResult(EAVResult::Error, TEXT("Failed to encode frame"), TEXT("VPX"), Result);
+	}
+
+	int32 QP = 0;
+	vpx_codec_control(&Codec->Context, VP8E_GET_LAST_QUANTIZER_64, &QP);
+
+	// No lag and no dropped frames, so everything out of this call belongs to the frame just sent
+	vpx_codec_iter_t Iterator = nullptr;
+	while (vpx_codec_cx_pkt_t const* const Packet = vpx_codec_get_cx_data(&Codec->Context, &Iterator))
+	{
+		if (Packet->kind == VPX_CODEC_CX_FRAME_PKT)
+		{
+			TSharedPtr<uint8> const CopiedData = UE::AVCodecCore::FPacketBufferPool::Get().Allocate(Packet->data.frame.sz);
+			FMemory::Memcpy(CopiedData.Get(), Packet->data.frame.buf, Packet->data.frame.sz);
+
+			Packets.Push(
+				FVideoPacket(
+					CopiedData,
+					Packet->data.frame.sz,
+					Timestamp,
+					FrameCount,
+					QP,
+					(Packet->data.frame.flags & VPX_FRAME_IS_KEY) != 0,
+					UserData));
+		}
+	}
+
+	++FrameCount;
+
+	return EAVResult::Success;
+}
+
+FAVResult FVideoEncoderVPX::ReceivePacket(FVideoPacket& OutPacket)
+{
+	if (IsOpen())
+	{
+		if (Packets.Pop(OutPacket))
+		{
+			return EAVResult::Success;
+		}
+
+		return EAVResult::PendingInput;
+	}
+
+	return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"), TEXT("VPX"));
+}
+
+FAVResult FVideoEncoderVPX::WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime)
+{
+	if (IsOpen())
+	{
+		if (Packets.WaitPop(OutPacket, WaitTime))
+		{
+			return EAVResult::Success;
+		}
+
+		return EAVResult::PendingInput;
+	}
+
+	return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"), TEXT("VPX"));
+}
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Video/Encoders/VideoKeyframeArbiter.h"
+
+FVideoKeyframeArbiter::FVideoKeyframeArbiter(double InCoalesceWindowSeconds, double InMinKeyframeSpacingSeconds, bool bInPreferIntraRefresh)
+	: CoalesceWindowSeconds(FMath::Max(InCoalesceWindowSeconds, 0.0))
+	, MinKeyframeSpacingSeconds(FMath::Max(InMinKeyframeSpacingSeconds, 0.0))
+	, bPreferIntraRefresh(bInPreferIntraRefresh)
+{
+}
+
+void FVideoKeyframeArbiter::Request(double NowSeconds, bool bFullKeyframe, bool bMissedLastKeyframe)
+{
+	Requests++;
+
+	// Answered by what just went out, unless it was intra refresh and this needs more than that, or the requester never got it
+	bool const bJustAnswered = !bMissedLastKeyframe && LastAnswerTime.IsSet() && NowSeconds - *LastAnswerTime <= CoalesceWindowSeconds;
+	if (bJustAnswered && (bLastAnswerFull || !bFullKeyframe))
+	{
+		Coalesced++;
+
+		return;
+	}
+
+	if (bPending)
+	{
+		Coalesced++;
+	}
+
+	bPending = true;
+	bPendingFull |= bFullKeyframe;
+}
+
+EVideoKeyframeDecision FVideoKeyframeArbiter::Decide(double NowSeconds)
+{
+	if (!bPending)
+	{
+		return EVideoKeyframeDecision::None;
+	}
+
+	// Intra refresh cannot start a stream, so the first answer is always a full keyframe
+	if (bPreferIntraRefresh && !bPendingFull && LastKeyframeTime.IsSet())
+	{
+		bPending = false;
+		LastAnswerTime = NowSeconds;
+		bLastAnswerFull = false;
+		IntraRefreshes++;
+
+		return EVideoKeyframeDecision::IntraRefresh;
+	}
+
+	// Hold on to the request, along with any others arriving meanwhile, until another keyframe is allowed
+	if (LastKeyframeTime.IsSet() && NowSeconds - *LastKeyframeTime < MinKeyframeSpacingSeconds)
+	{
+		return EVideoKeyframeDecision::None;
+	}
+
+	bPending = false;
+	bPendingFull = false;
+	LastKeyframeTime = NowSeconds;
+	LastAnswerTime = NowSeconds;
+	bLastAnswerFull = true;
+	Keyframes++;
+
+	return EVideoKeyframeDecision::Keyframe;
+}
+
+void FVideoKeyframeArbiter::OnKeyframe(double NowSeconds)
+{
+	LastKeyframeTime = NowSeconds;
+	LastAnswerTime = NowSeconds;
+	bLastAnswerFull = true;
+
+	// Whatever was outstanding is answered by it
+	if (bPending)
+	{
+		bPending = false;
+		bPendingFull = false;
+	}
+}
@@ -2,6 +2,25 @@
 
 #include "Video/VideoResource.h"
 
+#include "Misc/ScopeLock.h"
+
+FVideoDescriptor const* FVideoDescriptor::Intern(FVideoDescriptor const& Descriptor)
+{
+	// Never shrinks, there are only ever a handful of transport formats and sizes in use
+	static FCriticalSection Guard;
+	static TMap<FVideoDescriptor, TUniquePtr<FVideoDescriptor>> Interned;
+
+	FScopeLock const Lock(&Guard);
+
+	TUniquePtr<FVideoDescriptor>& Result = Interned.FindOrAdd(Descriptor);
+	if (!Result.IsValid())
+	{
+		Result = MakeUnique<FVideoDescriptor>(Descriptor.Format, Descriptor.Width, Descriptor.Height);
+	}
+
+	return Result.Get();
+}
+
 FVideoResource::FVideoResource(TSharedRef<FAVDevice> const& Device, FAVLayout const& Layout, FVideoDescriptor const& Descriptor)
 	: FAVResource(Device, Layout)
 	, Descriptor(Descriptor)
@@ -40,6 +40,34 @@
 template <template <typename TResource = void, typename TConfig = void> typename TDomain, typename TResource = void, typename TConfig = void>
 class TAVCoder;
 
+/**
+ * Key of a list of coder factories, by the domain, resource and configuration they are registered for.
+ */
+struct FAVCoderFactoryKey
+{
+public:
+	FTypeID Domain;
+	FTypeID Resource;
+	FTypeID Config;
+
+	FAVCoderFactoryKey(FTypeID Domain, FTypeID Resource, FTypeID Config)
+		: Domain(Domain)
+		, Resource(Resource)
+		, Config(Config)
+	{
+	}
+
+	bool operator==(FAVCoderFactoryKey const& Other) const
+	{
+		return Domain == Other.Domain && Resource == Other.Resource && Config == Other.Config;
+	}
+
+	friend uint32 GetTypeHash(FAVCoderFactoryKey const& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Domain), HashCombine(GetTypeHash(Key.Resource), GetTypeHash(Key.Config)));
+	}
+};
+
 /**
  * Simple base coder interface
  */
@@ -47,14 +75,19 @@ class AVCODECSCORE_API IAVCoder
 {
 protected:
 	/**
-	 * Type-erased factory list. First level is domain ids, second is resource ids, third is configuration ids.
+	 * Type-erased factory lists, keyed by domain, resource and configuration ids.
 	 * Stored void pointers point to a TArray of TAVCoder::TFactory's with types matching the domain, resource, and configuration ids.
 	 * This is declared here to avoid exporting the template types (which can be real dodgy).
 	 *
 	 * @see FTypeID
 	 * @see TAVCoder::GetFactories
 	 */
-	static TMap<FTypeID, TMap<FTypeID, TMap<FTypeID, TSharedPtr<void>>>> Factories;
+	static TMap<FAVCoderFactoryKey, TSharedPtr<void>> Factories;
+
+	/**
+	 * @return A new id, unique across every factory registered with any domain, used to remember its compatibility with each device.
+	 */
+	static uint64 NewFactoryID();
 
 public:
 	virtual ~IAVCoder() = default;
@@ -288,10 +321,19 @@ private:
 	// Internal getter for type-specific coder factories.
 	template <typename TResource, typename TConfig>
 	static TArray<TFactory<TResource, TConfig>>& GetFactories()
+	{
+		// The list itself never moves once created, so each module only has to look it up once
+		static TArray<TFactory<TResource, TConfig>>* const Cached = &FindOrAddFactories<TResource, TConfig>();
+
+		return *Cached;
+	}
+
+	template <typename TResource, typename TConfig>
+	static TArray<TFactory<TResource, TConfig>>& FindOrAddFactories()
 	{
 		// Same as void*, but memory safe because shared pointers store custom deleters (so void is still virtually destructible)
 		// Worth the hack to reduce verbosity elsewhere, see below
-		TSharedPtr<TArray<TFactory<TResource, TConfig>>>& Data = *(TSharedPtr<TArray<TFactory<TResource, TConfig>>>*)&Factories.FindOrAdd(FTypeID::Get<TDomain<>>()).FindOrAdd(FTypeID::Get<TResource>()).FindOrAdd(FTypeID::Get<TConfig>());
+		TSharedPtr<TArray<TFactory<TResource, TConfig>>>& Data = *(TSharedPtr<TArray<TFactory<TResource, TConfig>>>*)&Factories.FindOrAdd(FAVCoderFactoryKey(FTypeID::Get<TDomain<>>(), FTypeID::Get<TResource>(), FTypeID::Get<TConfig>()));
 		if (!Data.IsValid())
 		{
 			Data = MakeShared<TArray<TFactory<TResource, TConfig>>>();
@@ -343,16 +385,23 @@ public:
 	 * @tparam TCoder Fully type-complete (ie. FVideoEncoderNVENC : TVideoEncoder<FVideoResourceCUDA, FVideoConfigNVENC>) coder to be created by the factory. Must have a valid default constructor. Must be assignable to the base domain with the filter types below.
 	 * @tparam TResource Type of AVResource to filter by when requested.
 	 * @tparam TConfig Type of AVConfig to to filter by when requested.
-	 * @param IsCompatible Optional delegate to further filter this coder.
+	 * @param IsCompatible Optional delegate to further filter this coder. Its answer is remembered per device until the contexts on that device change, so it should not depend on the instance.
 	 * @return The constructed factory, to be further customised if desired.
 	 */
 	template <typename TCoder, typename TResource, typename TConfig>
 	static TFactory<TResource, TConfig>& Register(FIsCompatible const& IsCompatible = nullptr)
 	{
+		uint64 const FactoryID = NewFactoryID();
+
 		return GetFactories<TResource, TConfig>().Emplace_GetRef(
-			[IsCompatible](TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance)
+			[FactoryID, IsCompatible](TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance)
 			{
-				return FAVExtension::IsCompatible<TCoder, TResource>(NewDevice) && FAVExtension::IsCompatible<TCoder, TConfig>(NewInstance) && (IsCompatible == nullptr || IsCompatible(NewDevice, NewInstance));
+				bool const bDeviceCompatible = NewDevice->IsCompatible(FactoryID, [&NewDevice, &NewInstance, &IsCompatible]()
+				{
+					return FAVExtension::IsCompatible<TCoder, TResource>(NewDevice) && (IsCompatible == nullptr || IsCompatible(NewDevice, NewInstance));
+				});
+
+				return bDeviceCompatible && FAVExtension::IsCompatible<TCoder, TConfig>(NewInstance);
 			},
 			[]()
 			{
@@ -427,7 +476,7 @@ public:
 	static int32 CountSupported(TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance)
 	{
 		int32 Result = 0;
-		for (TFactory<TResource, TConfig> const& Factory : GetFactories<TResource, TConfig>().Num())
+		for (TFactory<TResource, TConfig> const& Factory : GetFactories<TResource, TConfig>())
 		{
 			if (Factory.IsCompatible(NewDevice, NewInstance))
 			{
@@ -464,7 +513,7 @@ public:
 	template <typename TResource, typename TConfig>
 	static bool IsSupported(TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance)
 	{
-		for (TFactory<TResource, TConfig> const& Factory : GetFactories<TResource, TConfig>().Num())
+		for (TFactory<TResource, TConfig> const& Factory : GetFactories<TResource, TConfig>())
 		{
 			if (Factory.IsCompatible(NewDevice, NewInstance))
 			{
@@ -5,6 +5,9 @@
 #include "AVContext.h"
 #include "AVUtility.h"
 
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+
 /**
  * A representation of a physical computer device, be it a GPU or a CPU or an external device, that can hold device resource contexts (Vulkan, D3D, CUDA, etc).
  */
@@ -16,6 +19,12 @@ private:
 	 */
 	TTypeMap<FAVContext> Contexts;
 
+	/*
+	 * Coder factory compatibility already worked out against this device, keyed by factory id
+	 */
+	mutable FCriticalSection CompatibilityGuard;
+	mutable TMap<uint64, bool> Compatibility;
+
 public:
 	/**
 	 * Get the global hardware device.
@@ -66,8 +75,26 @@ public:
 	void SetContext(TSharedPtr<TContext> const& NewContext)
 	{
 		Contexts.Set<TContext>(NewContext);
+
+		// What a coder is compatible with usually depends on the contexts available
+		ResetCompatibility();
 	}
 
+	/**
+	 * Check whether a coder factory is compatible with this device, remembering the answer for next time.
+	 * Used by the coder factories so that repeatedly creating coders does not repeat their checks, see TAVCoder::Register.
+	 *
+	 * @param FactoryID Id of the factory asking, unique across all factories.
+	 * @param IsCompatible Works out the answer, only called if there is none remembered.
+	 * @return Whether the factory is compatible with this device.
+	 */
+	bool IsCompatible(uint64 FactoryID, TFunctionRef<bool()> IsCompatible) const;
+
+	/**
+	 * Forget every remembered factory compatibility, for when something they depend on other than the contexts of this device changes.
+	 */
+	void ResetCompatibility();
+
 	FAVDevice() = default;
 	virtual ~FAVDevice() = default;
 };
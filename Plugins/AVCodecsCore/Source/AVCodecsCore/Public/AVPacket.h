@@ -23,7 +23,7 @@ struct FAVPacket
 	uint64 DataSize;
 
 	/**
-	 * Timestamp of packet.
+	 * Timestamp of packet, in microseconds for video.
 	 */
 	uint64 Timestamp;
 
@@ -32,6 +32,11 @@ struct FAVPacket
 	 */
 	uint64 Index;
 
+	/**
+	 * Opaque value sent along with the frame this packet was encoded from, carried through the coder untouched.
+	 */
+	uint64 UserData = 0;
+
 	/**
 	 * Convenience wrapper to treat raw data as an array view.
 	 *
@@ -57,11 +62,12 @@ struct FAVPacket
 	}
 
 	FAVPacket() = default;
-	FAVPacket(TSharedPtr<uint8> const& DataPtr, uint64 DataSize, uint64 Timestamp, uint64 Index)
+	FAVPacket(TSharedPtr<uint8> const& DataPtr, uint64 DataSize, uint64 Timestamp, uint64 Index, uint64 UserData = 0)
 		: DataPtr(DataPtr)
 		, DataSize(DataSize)
 		, Timestamp(Timestamp)
 		, Index(Index)
+		, UserData(UserData)
 	{
 	}
 };
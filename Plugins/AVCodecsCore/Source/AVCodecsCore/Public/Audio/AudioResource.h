@@ -64,6 +64,11 @@ public:
 	{
 		return !(*this == RHS);
 	}
+
+	friend uint32 GetTypeHash(FAudioDescriptor const& Descriptor)
+	{
+		return HashCombine(::GetTypeHash(Descriptor.NumSamples), ::GetTypeHash(Descriptor.SampleDuration));
+	}
 };
 
 /**
@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Event.h"
+#include "HAL/Runnable.h"
+
+#include <atomic>
+
+namespace UE::AVCodecCore
+{
+	/**
+	 * What Enqueue does when the worker already has as many tasks queued as it allows.
+	 */
+	enum class EAsyncWorkerOverflow : uint8
+	{
+		// Wait for the worker to take a task off the queue
+		Block,
+
+		// Throw away the oldest queued task, for live sources that would rather skip a frame than fall behind
+		DropOldest,
+	};
+
+	/**
+	 * A thread running queued tasks in order, sleeping on an event while there is nothing to do.
+	 * The queue is bounded so a producer that outpaces the worker either waits or drops work rather than growing it forever.
+	 */
+	class AVCODECSCORE_API FAsyncWorker : public FRunnable
+	{
+	public:
+		using FTask = TUniqueFunction<void()>;
+
+		/**
+		 * @param Name Name of the thread.
+		 * @param InMaxQueued Tasks that may wait behind the one running before Overflow applies.
+		 * @param InOverflow What to do with a task enqueued while the queue is full.
+		 */
+		FAsyncWorker(FString const& Name, int32 InMaxQueued, EAsyncWorkerOverflow InOverflow);
+
+		// Runs everything already queued before the thread is stopped
+		virtual ~FAsyncWorker() override;
+
+		bool IsRunning() const { return Thread != nullptr; }
+
+		/**
+		 * Queue a task to run on the worker thread.
+		 * Enqueue and Flush are expected to be called from a single thread, the one feeding the worker.
+		 *
+		 * @return False if the worker could not start its thread, in which case the task is dropped.
+		 */
+		bool Enqueue(FTask&& Task);
+
+		/**
+		 * Wait until every queued task has run.
+		 */
+		void Flush();
+
+		int32 GetMaxQueued() const { return MaxQueued; }
+		EAsyncWorkerOverflow GetOverflow() const { return Overflow; }
+
+		/**
+		 * @return Number of tasks waiting to run, not counting one that is running.
+		 */
+		int32 NumQueued() const;
+
+		/**
+		 * @return Number of tasks thrown away by DropOldest since the worker started.
+		 */
+		int32 NumDropped() const { return Dropped.load(); }
+
+		/**
+		 * @return Number of times the thread has woken up from waiting for work, which stays put while the worker is idle.
+		 */
+		int32 NumWakeups() const { return Wakeups.load(); }
+
+	private:
+		virtual uint32 Run() override;
+		virtual void Stop() override;
+
+		int32 const MaxQueued;
+		EAsyncWorkerOverflow const Overflow;
+
+		// Guards the queue and the bookkeeping below, so DropOldest can take from the front while the worker does too
+		mutable FCriticalSection Guard;
+		TQueue<FTask> Tasks;
+		int32 Queued = 0;
+		bool bBusy = false;
+
+		// Triggered when a task is queued or the worker is asked to stop
+		FEvent* TasksPending = nullptr;
+
+		// Triggered whenever a task finishes, for a producer waiting on a free slot or a flush
+		FEvent* TaskDone = nullptr;
+
+		std::atomic<bool> bStopping = false;
+		std::atomic<int32> Dropped = 0;
+		std::atomic<int32> Wakeups = 0;
+
+		FRunnableThread* Thread = nullptr;
+	};
+} // namespace UE::AVCodecCore
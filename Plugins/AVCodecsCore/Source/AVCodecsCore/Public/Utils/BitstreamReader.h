@@ -115,48 +115,113 @@ struct FBitstreamSegment
 struct FBitstreamReader
 {
 public:
-	FBitstreamReader(uint8* Data, uint64 DataSize, uint64 BytePosition = 0, uint8 BitPosition = 0)
+	FBitstreamReader(uint8 const* Data, uint64 DataSize, uint64 BytePosition = 0, uint8 BitPosition = 0)
 		: Data(Data)
 		, DataSize(DataSize)
-		, BytePosition(BytePosition)
-		, BitPosition(BitPosition)
+		, FetchPosition(FMath::Min(DataSize, BytePosition))
 	{
+		SkipBits(FMath::Min<uint8>(8, BitPosition));
+	}
+
+	/*
+	 * Create a reader directly over an escaped bitstream (EBSP), such as a NALU as it sits in an Annex-B packet.
+	 * Emulation prevention bytes are skipped as the reader advances, so headers can be parsed without first un-escaping the whole payload into an RBSP.
+	 * Byte positions and sizes reported by this reader refer to the escaped data, with the exception of NumBitsRead and Seek which work in payload bits.
+	 */
+	static FBitstreamReader FromEBSP(uint8 const* Data, uint64 DataSize)
+	{
+		FBitstreamReader Reader(Data, DataSize);
+		Reader.bSkipEmulationPrevention = true;
+
+		return Reader;
 	}
 
 	bool IsByteAligned() const
 	{
-		return (BitPosition & 7) == 0;
+		return (CacheBits & 7) == 0;
 	}
 
-	uint8* GetDataRemaining() const
+	uint8 const* GetDataRemaining() const
 	{
-		return Data + BytePosition;
+		return Data + FMath::Min(DataSize, GetBitPosition() >> 3);
 	}
 
 	uint64 NumBytesRemaining() const
 	{
-		return DataSize - BytePosition;
+		return DataSize - FMath::Min(DataSize, GetBitPosition() >> 3);
 	}
 
 	uint64 NumBitsRemaining() const
 	{
-		return NumBytesRemaining() * 8 + (BitPosition ? 8 - BitPosition : 0);
+		return DataSize * 8 - FMath::Min(DataSize * 8, GetBitPosition());
+	}
+
+	/*
+	 * Number of payload bits consumed so far, not counting any skipped emulation prevention bytes.
+	 */
+	uint64 NumBitsRead() const
+	{
+		return (FetchPosition - NumEmulationPreventionBytes) * 8 - CacheBits;
 	}
 
 	void Seek(uint64 NewBytePosition, uint32 NewBitPosition = 0)
 	{
-		BytePosition = FMath::Min(DataSize, NewBytePosition);
-		BitPosition = FMath::Min(8u, NewBitPosition);
+		Cache = 0;
+		CacheBits = 0;
+
+		if (bSkipEmulationPrevention)
+		{
+			// Escaped positions can't be mapped to payload positions without walking the data from the start
+			FetchPosition = 0;
+			ZeroRun = 0;
+			NumEmulationPreventionBytes = 0;
+
+			SkipBits(NewBytePosition * 8 + FMath::Min(8u, NewBitPosition));
+		}
+		else
+		{
+			FetchPosition = FMath::Min(DataSize, NewBytePosition);
+
+			SkipBits(FMath::Min(8u, NewBitPosition));
+		}
 	}
 
 	void SkipBytes(uint64 NumBytes)
 	{
-		BytePosition += NumBytes;
+		SkipBits(NumBytes * 8);
 	}
 
 	void SkipBits(uint64 NumBits)
 	{
-		SkipBytes(NumBits >> 3);
+		if (NumBits <= CacheBits)
+		{
+			Consume(NumBits);
+			return;
+		}
+
+		// Throw away whatever is cached and step over the whole bytes without loading them
+		NumBits -= CacheBits;
+		Cache = 0;
+		CacheBits = 0;
+
+		if (bSkipEmulationPrevention)
+		{
+			for (uint64 i = NumBits >> 3; i > 0; --i)
+			{
+				if (FetchPosition >= DataSize)
+				{
+					FetchPosition += i;
+					break;
+				}
+
+				FetchByte();
+			}
+		}
+		else
+		{
+			FetchPosition += NumBits >> 3;
+		}
+
 		ReadBits(NumBits & 7);
 	}
 
@@ -168,73 +233,20 @@ public:
 		{
 			return 0;
 		}
-		else
-		{
-			uint32 PeekBytePosition = BytePosition + (BitPosition >> 3);
-			uint32 PeekBitPosition = BitPosition & 7;
-
-			uint32 Result;
-			uint64 const PeekBytesRemaining = NumBytesRemaining();
-			if (PeekBytesRemaining >= 4)
-			{
-#if defined(_MSC_VER)
-				Result = _byteswap_ulong(*(uint32*)(Data + PeekBytePosition));
-#else
-				Result = __builtin_bswap32(*(uint32*)(Data + PeekBytePosition));
-#endif
-			}
-			else
-			{
-				if (PeekBytesRemaining == 3)
-				{
-					Result = ((uint32)Data[PeekBytePosition + 0] << 24) | ((uint32)Data[PeekBytePosition + 1] << 16) | ((uint32)Data[PeekBytePosition + 2] << 8);
-				}
-				else if (PeekBytesRemaining == 2)
-				{
-					Result = ((uint32)Data[PeekBytePosition + 0] << 24) | ((uint32)Data[PeekBytePosition + 1] << 16);
-				}
-				else if (PeekBytesRemaining == 1)
-				{
-					Result = ((uint32)Data[PeekBytePosition + 0] << 24);
-				}
-				else
-				{
-					Result = 0;
-				}
-
-			}
 
-			if (PeekBitPosition == 0)
-			{
-				Result = Result >> (32 - NumBits);
-				return Result;
-			}
-			else
-			{
-				uint32 w0 = Result;
-				uint8 w1;
-				if (PeekBytesRemaining > 4)
-				{
-					w1 = *(uint8*)(Data + PeekBytePosition + 4);
-				}
-				else
-				{
-					w1 = 0;
-				}
-				Result = (w0 << PeekBitPosition) | uint32(w1 >> (8 - PeekBitPosition));
-				Result = Result >> (32 - NumBits);
-				return Result;
-			}
+		if (CacheBits < NumBits)
+		{
+			Refill();
 		}
+
+		return uint32(Cache >> (64 - NumBits));
 	}
 
 	uint32 ReadBits(uint64 NumBits)
 	{
 		uint32 const Result = PeekBits(NumBits);
 		
-		uint32 const NewBitPosition = BitPosition + NumBits;
-		BytePosition += NewBitPosition >> 3;
-		BitPosition = NewBitPosition & 7;
+		Consume(NumBits);
 		
 		return Result;
 	}
@@ -273,19 +285,22 @@ public:
 	template <typename ValueType>
 	void Read(FBitstreamSegment::UnsignedExpGolomb<ValueType>& Output)
 	{
-		int32 lz = -1;
-		for (uint32 b = 0; b == 0; ++lz)
+		if (CacheBits < 32)
 		{
-			b = ReadBits(1);
+			Refill();
 		}
 
-		if (lz)
+		// The whole code is 2 * LeadingZeros + 1 bits, so after a refill any code of up to 57 bits is decoded straight out of the cache
+		uint32 const LeadingZeros = (uint32)FMath::CountLeadingZeros64(Cache);
+		uint32 const CodeBits = 2 * LeadingZeros + 1;
+		if (CodeBits <= CacheBits)
 		{
-			Output = static_cast<ValueType>(((1 << lz) | ReadBits(lz)) - 1);
+			Output = static_cast<ValueType>((Cache >> (64 - CodeBits)) - 1);
+			Consume(CodeBits);
 		}
 		else
 		{
-			Output = static_cast<ValueType>(0u);
+			ReadLongExpGolomb(Output);
 		}
 	}
 	
@@ -306,11 +321,122 @@ public:
 	}
 
 private:
-	uint8* Data;
+	/*
+	 * Position of the next unread bit. For EBSP readers this ignores any emulation prevention bytes that are already in the cache.
+	 */
+	uint64 GetBitPosition() const
+	{
+		return FetchPosition * 8 - CacheBits;
+	}
+
+	void Consume(uint64 NumBits)
+	{
+		Cache = NumBits < 64 ? Cache << NumBits : 0;
+		CacheBits -= (uint32)NumBits;
+	}
+
+	/*
+	 * Tops the cache up to at least 57 bits. Reads past the end of the data load zeros.
+	 */
+	void Refill() const
+	{
+		if (FetchPosition + 8 <= DataSize)
+		{
+			uint64 Bytes;
+			FMemory::Memcpy(&Bytes, Data + FetchPosition, sizeof(Bytes));
+#if defined(_MSC_VER)
+			Bytes = _byteswap_uint64(Bytes);
+#else
+			Bytes = __builtin_bswap64(Bytes);
+#endif
+
+			// Emulation prevention bytes are always 0x03, so if there isn't one in the window we can take the whole thing as payload
+			uint64 const Escapes = Bytes ^ 0x0303030303030303ULL;
+			if (!bSkipEmulationPrevention || ((Escapes - 0x0101010101010101ULL) & ~Escapes & 0x8080808080808080ULL) == 0)
+			{
+				uint32 const NumBytes = (64 - CacheBits) >> 3;
+
+				// Only the bytes we take may land in the cache, the bits below CacheBits must stay zero
+				uint64 const Taken = Bytes & (~0ULL << ((8 - NumBytes) * 8));
+				Cache |= Taken >> CacheBits;
+				CacheBits += NumBytes * 8;
+				FetchPosition += NumBytes;
+
+				if (bSkipEmulationPrevention)
+				{
+					// Only the last two bytes can affect the zero run
+					for (uint32 i = NumBytes > 2 ? NumBytes - 2 : 0; i < NumBytes; ++i)
+					{
+						ZeroRun = uint8(Taken >> ((7 - i) * 8)) == 0 ? FMath::Min<uint8>(ZeroRun + 1, 2) : 0;
+					}
+				}
+
+				return;
+			}
+		}
+
+		while (CacheBits <= 56)
+		{
+			Cache |= uint64(FetchByte()) << (56 - CacheBits);
+			CacheBits += 8;
+		}
+	}
+
+	/*
+	 * Returns the next payload byte, stepping over an emulation prevention byte first if one is due.
+	 */
+	uint8 FetchByte() const
+	{
+		// A 0x03 following two payload zeros is an emulation prevention byte and not part of the payload
+		if (bSkipEmulationPrevention && ZeroRun == 2 && FetchPosition < DataSize && Data[FetchPosition] == 0x03)
+		{
+			++FetchPosition;
+			++NumEmulationPreventionBytes;
+			ZeroRun = 0;
+		}
+
+		uint8 const Byte = FetchPosition < DataSize ? Data[FetchPosition] : 0;
+		++FetchPosition;
+
+		ZeroRun = Byte == 0 ? FMath::Min<uint8>(ZeroRun + 1, 2) : 0;
+
+		return Byte;
+	}
+
+	/*
+	 * Slow path for codes that don't fit in the cache, either because they are very long or because we are at the end of the data.
+	 */
+	template <typename ValueType>
+	void ReadLongExpGolomb(FBitstreamSegment::UnsignedExpGolomb<ValueType>& Output)
+	{
+		uint32 LeadingZeros = 0;
+		while (LeadingZeros < 32 && ReadBits(1) == 0)
+		{
+			++LeadingZeros;
+		}
+
+		if (LeadingZeros)
+		{
+			Output = static_cast<ValueType>(((uint64(1) << LeadingZeros) | ReadBits(LeadingZeros)) - 1);
+		}
+		else
+		{
+			Output = static_cast<ValueType>(0u);
+		}
+	}
+
+	uint8 const* Data;
 	uint64 DataSize;
 
-	uint64 BytePosition;
-	uint8 BitPosition;
+	// Bits are read from the top of the cache, FetchPosition is the next byte of Data to be loaded into it
+	mutable uint64 Cache = 0;
+	mutable uint32 CacheBits = 0;
+	mutable uint64 FetchPosition;
+
+	// Emulation prevention state, only used by readers created with FromEBSP
+	bool bSkipEmulationPrevention = false;
+	mutable uint8 ZeroRun = 0;
+	mutable uint64 NumEmulationPreventionBytes = 0;
 };
 
 // Requires template param for ValueType, so that all instantiations of U<0> route through this (and more importantly, the deleted specialization of FBitstreamReader::Read)
@@ -335,7 +461,7 @@ public:
 	}
 };
 
-template <int32 NumBits, typename ValueType>
+template <uint8 NumBits, typename ValueType>
 struct TBitSizeOf<FBitstreamSegment::U<NumBits, ValueType>>
 {
 	static constexpr uint16 Value = NumBits;
@@ -0,0 +1,154 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utils/BitstreamReader.h"
+
+/*
+ * Simple wrapper for typed writes to a bitstream, the counterpart to FBitstreamReader.
+ */
+struct FBitstreamWriter
+{
+public:
+	/*
+	 * Appends to Output, which must outlive the writer.
+	 */
+	FBitstreamWriter(TArray<uint8>& Output)
+		: Output(Output)
+	{
+	}
+
+	/*
+	 * Create a writer that escapes the payload as it goes, producing an EBSP that can be placed straight into an Annex-B packet.
+	 * An emulation prevention byte is inserted wherever two zero bytes would be followed by a byte <= 0x03.
+	 */
+	static FBitstreamWriter ToEBSP(TArray<uint8>& Output)
+	{
+		FBitstreamWriter Writer(Output);
+		Writer.bInsertEmulationPrevention = true;
+
+		return Writer;
+	}
+
+	bool IsByteAligned() const
+	{
+		return CacheBits == 0;
+	}
+
+	/*
+	 * Number of payload bits written so far, not counting any inserted emulation prevention bytes.
+	 */
+	uint64 NumBitsWritten() const
+	{
+		return NumBytesWritten * 8 + CacheBits;
+	}
+
+	void WriteBits(uint32 Value, uint64 NumBits)
+	{
+		verifyf(NumBits <= 32, TEXT("This function can write at most 32 bits!"));
+
+		Cache = (Cache << NumBits) | (Value & (0xFFFFFFFFULL >> (32 - NumBits)));
+		CacheBits += (uint32)NumBits;
+
+		while (CacheBits >= 8)
+		{
+			CacheBits -= 8;
+			WriteByte(uint8(Cache >> CacheBits));
+		}
+	}
+
+	void WriteBits64(uint64 Value, uint64 NumBits)
+	{
+		if (NumBits <= 32)
+		{
+			WriteBits(uint32(Value), NumBits);
+		}
+		else
+		{
+			WriteBits(uint32(Value >> 32), NumBits - 32);
+			WriteBits(uint32(Value), 32);
+		}
+	}
+
+	template <typename TInput>
+	void WriteBits(TInput const& Input, uint64 NumBits)
+	{
+		verifyf(NumBits <= static_cast<uint64>(sizeof(TInput)) * 8, TEXT("Attempted to write more bits than we hold!"));
+
+		uint64 Bits = 0;
+		FMemory::Memcpy(&Bits, &Input, (NumBits + 7) >> 3);
+
+		WriteBits64(Bits, NumBits);
+	}
+
+	template <typename TInput>
+	void Write(TInput const& Input)
+	{
+		WriteBits(Input, TBitSizeOf<TInput>::Value);
+	}
+
+	template <typename ValueType>
+	void Write(FBitstreamSegment::UnsignedExpGolomb<ValueType> const& Input)
+	{
+		uint64 const Code = uint64(Input.Value) + 1;
+		uint32 const NumBits = 64 - (uint32)FMath::CountLeadingZeros64(Code);
+
+		WriteBits(0u, NumBits - 1);
+		WriteBits64(Code, NumBits);
+	}
+
+	template <typename ValueType>
+	void Write(FBitstreamSegment::SignedExpGolomb<ValueType> const& Input)
+	{
+		int64 const Value = Input.Value;
+
+		Write(FBitstreamSegment::UnsignedExpGolomb<uint64>(Value > 0 ? uint64(Value) * 2 - 1 : uint64(-Value) * 2));
+	}
+
+	template <typename TInput, typename... TInputs>
+	void Write(TInput const& Input, TInputs const&... Inputs)
+	{
+		Write(Input);
+		Write(Inputs...);
+	}
+
+	/*
+	 * Write the rbsp_trailing_bits that end a NALU payload, a stop bit followed by zeros up to the next byte boundary.
+	 */
+	void WriteTrailingBits()
+	{
+		WriteBits(1u, 1);
+
+		if (CacheBits > 0)
+		{
+			WriteBits(0u, 8 - CacheBits);
+		}
+	}
+
+private:
+	void WriteByte(uint8 Byte)
+	{
+		if (bInsertEmulationPrevention && ZeroRun == 2 && Byte <= 0x03)
+		{
+			Output.Add(0x03);
+			ZeroRun = 0;
+		}
+
+		Output.Add(Byte);
+		++NumBytesWritten;
+
+		ZeroRun = Byte == 0 ? FMath::Min<uint8>(ZeroRun + 1, 2) : 0;
+	}
+
+	TArray<uint8>& Output;
+
+	// Bits that don't yet make up a whole byte sit at the bottom of the cache
+	uint64 Cache = 0;
+	uint32 CacheBits = 0;
+	uint64 NumBytesWritten = 0;
+
+	// Emulation prevention state, only used by writers created with ToEBSP
+	bool bInsertEmulationPrevention = false;
+	uint8 ZeroRun = 0;
+};
@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::AVCodecCore
+{
+	/**
+	 * Thread safe pool of packet data buffers, bucketed by power of two size.
+	 * Buffers go back to their bucket when the last reference to them is dropped, from whichever thread that happens on,
+	 * so encoders can hand them out in packets without tracking who consumes them.
+	 */
+	class AVCODECSCORE_API FPacketBufferPool
+	{
+	public:
+		// Smallest bucket, anything smaller is rounded up to it
+		static constexpr uint64 MinBucketSize = 4 * 1024;
+
+		// Largest bucket, anything larger is allocated and freed as is
+		static constexpr uint64 MaxBucketSize = 64 * 1024 * 1024;
+
+		/**
+		 * Pool shared by all encoders.
+		 */
+		static FPacketBufferPool& Get();
+
+		/**
+		 * @param InMaxBuffersPerBucket Free buffers kept per bucket, anything released past this is freed.
+		 */
+		FPacketBufferPool(int32 InMaxBuffersPerBucket = 8);
+		~FPacketBufferPool();
+
+		/**
+		 * Allocate a buffer of at least Size bytes, reusing a free one from the same bucket if there is one.
+		 * The contents are not initialized.
+		 *
+		 * @param Size Size in bytes.
+		 * @return The buffer, which returns itself to the pool once released. Null if Size is zero.
+		 */
+		TSharedPtr<uint8> Allocate(uint64 Size);
+
+		/**
+		 * Free every buffer currently sitting in the pool. Buffers still in use return to the pool as normal.
+		 */
+		void Trim();
+
+		/**
+		 * @return Number of free buffers currently held by the pool.
+		 */
+		int32 NumFree() const;
+
+		/**
+		 * @return Size of the bucket a request of Size bytes is served from, or Size itself if it is too large to be pooled.
+		 */
+		static uint64 GetBucketSize(uint64 Size);
+
+		/**
+		 * @return The pool's free buffers, which outlive the pool until every buffer it handed out has been released and freed along with them. Only meant for tests.
+		 */
+		TWeakPtr<void> GetBucketsForTesting() const;
+
+	private:
+		struct FBuckets;
+
+		// Shared with the buffers handed out, so any still in use after the pool is destroyed are simply freed
+		TSharedRef<FBuckets> Buckets;
+	};
+} // namespace UE::AVCodecCore
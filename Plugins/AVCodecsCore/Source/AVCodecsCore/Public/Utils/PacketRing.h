@@ -0,0 +1,189 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Timespan.h"
+
+#include <atomic>
+
+namespace UE::AVCodecCore
+{
+	/**
+	 * Lock free queue of packets between exactly one producer, usually an encoder's SendFrame, and one consumer reading them out.
+	 * Packets are moved in and out rather than copied, so the shared data pointer of a packet is never touched on the way through.
+	 * The consumer can sleep until a packet arrives, the producer only signals when it is actually waiting.
+	 * A fixed ring handles the usual case without allocating. Losing an encoded packet would corrupt the stream until the next
+	 * keyframe, so once the ring is full packets spill into an unbounded overflow queue rather than being refused.
+	 */
+	template <typename TPacket>
+	class TPacketRing
+	{
+	public:
+		/**
+		 * @param InCapacity Packets the ring can hold before Push starts to spill into the overflow queue, rounded up to a power of two.
+		 */
+		explicit TPacketRing(uint32 InCapacity = 64)
+			: Mask(FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(InCapacity, 2)) - 1)
+			, PacketReady(FPlatformProcess::GetSynchEventFromPool(false))
+		{
+			Slots.SetNum(Mask + 1);
+		}
+
+		~TPacketRing()
+		{
+			FPlatformProcess::ReturnSynchEventToPool(PacketReady);
+			PacketReady = nullptr;
+		}
+
+		TPacketRing(TPacketRing const&) = delete;
+		TPacketRing& operator=(TPacketRing const&) = delete;
+
+		/**
+		 * Add a packet to the back of the ring. Producer only.
+		 */
+		void Push(TPacket&& Packet)
+		{
+			uint32 const Tail = Back.load(std::memory_order_relaxed);
+
+			// Once anything has overflowed, later packets follow it there until the consumer has caught up, so they stay in order
+			if (NumOverflowed.load(std::memory_order_seq_cst) > 0 || Tail - Front.load(std::memory_order_acquire) > Mask)
+			{
+				Overflow.Enqueue(MoveTemp(Packet));
+
+				// Sequentially consistent, so either the consumer sees this packet or we see it waiting
+				NumOverflowed.fetch_add(1, std::memory_order_seq_cst);
+			}
+			else
+			{
+				Slots[Tail & Mask] = MoveTemp(Packet);
+
+				// Sequentially consistent, so either the consumer sees this packet or we see it waiting
+				Back.store(Tail + 1, std::memory_order_seq_cst);
+			}
+
+			if (bConsumerWaiting.load(std::memory_order_seq_cst))
+			{
+				PacketReady->Trigger();
+			}
+		}
+
+		/**
+		 * Take the packet at the front of the ring, if there is one. Consumer only.
+		 *
+		 * @return False if the ring is empty, in which case OutPacket is left as it was.
+		 */
+		bool Pop(TPacket& OutPacket)
+		{
+			// The ring first, anything overflowed was pushed after what is still in it
+			uint32 const Head = Front.load(std::memory_order_relaxed);
+			if (Head != Back.load(std::memory_order_seq_cst))
+			{
+				OutPacket = MoveTemp(Slots[Head & Mask]);
+
+				Front.store(Head + 1, std::memory_order_release);
+
+				return true;
+			}
+
+			if (NumOverflowed.load(std::memory_order_seq_cst) > 0 && Overflow.Dequeue(OutPacket))
+			{
+				// Only once the packet is out, so the producer keeps using the overflow queue until it is empty
+				NumOverflowed.fetch_sub(1, std::memory_order_seq_cst);
+
+				return true;
+			}
+
+			return false;
+		}
+
+		/**
+		 * Take the packet at the front of the ring, sleeping until one is pushed if it is empty. Consumer only.
+		 *
+		 * @param WaitTime Longest to wait for a packet.
+		 * @return False if no packet arrived in time.
+		 */
+		bool WaitPop(TPacket& OutPacket, FTimespan WaitTime)
+		{
+			if (Pop(OutPacket))
+			{
+				return true;
+			}
+
+			double const Deadline = FPlatformTime::Seconds() + WaitTime.GetTotalSeconds();
+			while (true)
+			{
+				bConsumerWaiting.store(true, std::memory_order_seq_cst);
+
+				bool const bPopped = Pop(OutPacket);
+				if (!bPopped)
+				{
+					double const Remaining = Deadline - FPlatformTime::Seconds();
+					if (Remaining > 0.0)
+					{
+						PacketReady->Wait(FTimespan::FromSeconds(Remaining));
+					}
+				}
+
+				bConsumerWaiting.store(false, std::memory_order_relaxed);
+
+				// The event may have been left over from a packet already popped, so only give up once the time is actually up
+				if (bPopped || Pop(OutPacket))
+				{
+					return true;
+				}
+
+				if (FPlatformTime::Seconds() >= Deadline)
+				{
+					return false;
+				}
+			}
+		}
+
+		/**
+		 * Drop every packet in the ring. Consumer only.
+		 */
+		void Empty()
+		{
+			// Each pop releases the packet popped before it
+			TPacket Dropped;
+			while (Pop(Dropped))
+			{
+			}
+		}
+
+		/**
+		 * @return Number of packets in the ring and its overflow queue, which may already be out of date if called from neither end.
+		 */
+		uint32 Num() const
+		{
+			// Front first, as it can only catch up with Back and never pass it
+			uint32 const Head = Front.load(std::memory_order_acquire);
+
+			return Back.load(std::memory_order_acquire) - Head + NumOverflowed.load(std::memory_order_acquire);
+		}
+
+		bool IsEmpty() const { return Num() == 0; }
+
+		uint32 GetCapacity() const { return Mask + 1; }
+
+	private:
+		uint32 const Mask;
+		TArray<TPacket> Slots;
+
+		// Each end on its own cache line, so the producer and consumer do not fight over one
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Front = 0;
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Back = 0;
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<bool> bConsumerWaiting = false;
+
+		// Packets pushed while the ring was full, or while earlier ones were still waiting here
+		TQueue<TPacket, EQueueMode::Spsc> Overflow;
+		std::atomic<uint32> NumOverflowed = 0;
+
+		FEvent* PacketReady = nullptr;
+	};
+} // namespace UE::AVCodecCore
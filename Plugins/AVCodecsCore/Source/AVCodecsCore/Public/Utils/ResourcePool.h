@@ -0,0 +1,280 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+
+namespace UE::AVCodecCore
+{
+	/**
+	 * Thread safe pool of free resources, bucketed by a hash of their descriptor so finding one to reuse does not scan the whole pool.
+	 * Holds at most a fixed number of free resources, evicting the least recently released one to make room for another.
+	 * All bookkeeping lives in storage sized up front, so once every descriptor in use has been seen acquiring and releasing does not allocate.
+	 *
+	 * TResource must provide GetDescriptor(), and TDescriptor must be comparable and hashable with GetTypeHash.
+	 */
+	template <typename TResource, typename TDescriptor>
+	class TResourcePool
+	{
+	public:
+		/**
+		 * @param InMaxFree Free resources kept by the pool, anything released past this evicts the least recently released one.
+		 */
+		TResourcePool(int32 InMaxFree = 8)
+			: MaxFree(FMath::Max(InMaxFree, 1))
+		{
+			Slots.SetNum(MaxFree);
+
+			FreeSlots.Reserve(MaxFree);
+			for (int32 i = MaxFree - 1; i >= 0; --i)
+			{
+				FreeSlots.Add(i);
+			}
+		}
+
+		/**
+		 * Take a free resource matching Descriptor out of the pool, preferring the one released most recently.
+		 *
+		 * @return The resource, or null if there is none and the caller should create one.
+		 */
+		TSharedPtr<TResource> Acquire(TDescriptor const& Descriptor)
+		{
+			TSharedPtr<TResource> Result;
+
+			FScopeLock const Lock(&Guard);
+
+			if (TArray<int32>* const Bucket = Buckets.Find(GetTypeHash(Descriptor)))
+			{
+				for (int32 i = Bucket->Num() - 1; i >= 0; --i)
+				{
+					int32 const Index = (*Bucket)[i];
+					if (*Slots[Index].Descriptor == Descriptor)
+					{
+						Bucket->RemoveAt(i, 1, false);
+						Result = Take(Index);
+
+						break;
+					}
+				}
+			}
+
+			if (Result.IsValid())
+			{
+				Hits++;
+			}
+			else
+			{
+				Misses++;
+			}
+
+			return Result;
+		}
+
+		/**
+		 * Acquire a resource matching Descriptor, or create one with Create if the pool has none.
+		 */
+		template <typename TCreate>
+		TSharedPtr<TResource> AcquireOrCreate(TDescriptor const& Descriptor, TCreate&& Create)
+		{
+			TSharedPtr<TResource> Result = Acquire(Descriptor);
+			if (!Result.IsValid())
+			{
+				Result = Create();
+			}
+
+			return Result;
+		}
+
+		/**
+		 * Return a resource to the pool, filed under its current descriptor.
+		 */
+		void Release(TSharedPtr<TResource> const& Resource)
+		{
+			if (!Resource.IsValid())
+			{
+				return;
+			}
+
+			// Evicted resources are destroyed once the lock is released, in case that is expensive
+			TSharedPtr<TResource> Evicted;
+
+			FScopeLock const Lock(&Guard);
+
+			if (FreeSlots.IsEmpty())
+			{
+				int32 const Oldest = LeastRecent;
+
+				// The oldest in the pool is also the oldest in its bucket, so this is found straight away
+				TArray<int32>& Bucket = Buckets.FindChecked(Slots[Oldest].Hash);
+				Bucket.RemoveAt(Bucket.Find(Oldest), 1, false);
+
+				Evicted = Take(Oldest);
+
+				Evictions++;
+			}
+
+			int32 const Index = FreeSlots.Pop(false);
+
+			FSlot& Slot = Slots[Index];
+			Slot.Resource = Resource;
+			Slot.Descriptor.Emplace(Resource->GetDescriptor());
+			Slot.Hash = GetTypeHash(*Slot.Descriptor);
+
+			// Link it in as the most recently released
+			Slot.LessRecent = MostRecent;
+			Slot.MoreRecent = INDEX_NONE;
+			if (MostRecent != INDEX_NONE)
+			{
+				Slots[MostRecent].MoreRecent = Index;
+			}
+			else
+			{
+				LeastRecent = Index;
+			}
+			MostRecent = Index;
+
+			Buckets.FindOrAdd(Slot.Hash).Add(Index);
+
+			HighWaterMark = FMath::Max(HighWaterMark, MaxFree - FreeSlots.Num());
+		}
+
+		/**
+		 * Drop every free resource held by the pool.
+		 */
+		void Trim()
+		{
+			TArray<TSharedPtr<TResource>> Dropped;
+
+			FScopeLock const Lock(&Guard);
+
+			Dropped.Reserve(MaxFree - FreeSlots.Num());
+			while (LeastRecent != INDEX_NONE)
+			{
+				Dropped.Add(Take(LeastRecent));
+			}
+
+			// Keep the buckets themselves, as the same descriptors are likely to come back
+			for (TPair<uint32, TArray<int32>>& Bucket : Buckets)
+			{
+				Bucket.Value.Reset();
+			}
+		}
+
+		int32 GetMaxFree() const { return MaxFree; }
+
+		/**
+		 * @return Number of free resources currently held by the pool.
+		 */
+		int32 NumFree() const
+		{
+			FScopeLock const Lock(&Guard);
+
+			return MaxFree - FreeSlots.Num();
+		}
+
+		/**
+		 * @return Most free resources the pool has held at once.
+		 */
+		int32 GetHighWaterMark() const
+		{
+			FScopeLock const Lock(&Guard);
+
+			return HighWaterMark;
+		}
+
+		/**
+		 * @return Number of calls to Acquire that found a resource to reuse.
+		 */
+		uint64 NumHits() const
+		{
+			FScopeLock const Lock(&Guard);
+
+			return Hits;
+		}
+
+		/**
+		 * @return Number of calls to Acquire that found nothing to reuse.
+		 */
+		uint64 NumMisses() const
+		{
+			FScopeLock const Lock(&Guard);
+
+			return Misses;
+		}
+
+		/**
+		 * @return Number of free resources evicted to make room for another.
+		 */
+		uint64 NumEvictions() const
+		{
+			FScopeLock const Lock(&Guard);
+
+			return Evictions;
+		}
+
+	private:
+		struct FSlot
+		{
+			TSharedPtr<TResource> Resource;
+
+			// Set only while the slot holds a resource
+			TOptional<TDescriptor> Descriptor;
+			uint32 Hash = 0;
+
+			// Neighbours in release order, INDEX_NONE at either end
+			int32 LessRecent = INDEX_NONE;
+			int32 MoreRecent = INDEX_NONE;
+		};
+
+		// Unlink an occupied slot from release order and free it, the caller has already removed it from its bucket
+		TSharedPtr<TResource> Take(int32 Index)
+		{
+			FSlot& Slot = Slots[Index];
+
+			if (Slot.LessRecent != INDEX_NONE)
+			{
+				Slots[Slot.LessRecent].MoreRecent = Slot.MoreRecent;
+			}
+			else
+			{
+				LeastRecent = Slot.MoreRecent;
+			}
+
+			if (Slot.MoreRecent != INDEX_NONE)
+			{
+				Slots[Slot.MoreRecent].LessRecent = Slot.LessRecent;
+			}
+			else
+			{
+				MostRecent = Slot.LessRecent;
+			}
+
+			TSharedPtr<TResource> Result = MoveTemp(Slot.Resource);
+			Slot.Resource.Reset();
+			Slot.Descriptor.Reset();
+			Slot.LessRecent = Slot.MoreRecent = INDEX_NONE;
+
+			FreeSlots.Add(Index);
+
+			return Result;
+		}
+
+		int32 const MaxFree;
+
+		mutable FCriticalSection Guard;
+
+		TArray<FSlot> Slots;
+		TArray<int32> FreeSlots;
+		TMap<uint32, TArray<int32>> Buckets;
+
+		int32 LeastRecent = INDEX_NONE;
+		int32 MostRecent = INDEX_NONE;
+
+		int32 HighWaterMark = 0;
+		uint64 Hits = 0;
+		uint64 Misses = 0;
+		uint64 Evictions = 0;
+	};
+} // namespace UE::AVCodecCore
@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::AVCodecCore
+{
+	/**
+	 * Find the next Annex-B start code prefix (0x000001) in a bitstream. Uses SSE2/AVX2/NEON where available.
+	 *
+	 * @param Data Bitstream to search.
+	 * @param DataSize Size of the bitstream in bytes.
+	 * @param Offset Byte offset to start searching from.
+	 * @return Byte offset of the first zero byte of the prefix, or INDEX_NONE if no prefix was found.
+	 */
+	AVCODECSCORE_API int64 FindStartCode(uint8 const* Data, int64 DataSize, int64 Offset = 0);
+
+	/**
+	 * Scalar implementation of FindStartCode. Used for the unaligned tail of the vectorized search and as the reference for validating it.
+	 */
+	AVCODECSCORE_API int64 FindStartCodeScalar(uint8 const* Data, int64 DataSize, int64 Offset = 0);
+} // namespace UE::AVCodecCore
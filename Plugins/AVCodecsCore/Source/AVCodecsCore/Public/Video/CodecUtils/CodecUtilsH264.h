@@ -6,6 +6,7 @@
 #include "Utils/BitstreamReader.h"
 
 #include "AVResult.h"
+#include "Video/CodecUtils/CodecUtilsSEI.h"
 #include "Video/VideoPacket.h"
 
 struct FH264ProfileDefinition;
@@ -432,6 +433,9 @@ namespace UE::AVCodecCore::H264
 		U<5> dpb_output_delay_length_minus1 = 23;
 		U<5> time_offset_length = 24;
 
+		// Bit position of vui_parameters_present_flag relative to the start of the parse, the VUI is the last thing in an SPS so this is where a rewrite starts
+		uint64 VUIBitOffset = 0;
+
 		EH264Profile GetProfile() const
 		{
 			for (FH264ProfileDefinition const& H264Profile : GH264ProfileDefinitions)
@@ -448,6 +452,40 @@ namespace UE::AVCodecCore::H264
 
 	FAVResult ParseSPS(FBitstreamReader& Bitstream, FNaluInfo const& InNaluInfo, TMap<uint32, SPS_t>& OutMapSPS);
 
+	/*
+	 * VUI values to patch into an SPS when rewriting it.
+	 */
+	struct FVUIRewrite
+	{
+		/*
+		 * Write a bitstream restriction that forbids frame reordering and sizes the DPB to the reference frames.
+		 * Without one decoders have to assume the largest DPB the level allows, and may hold back that many frames before output.
+		 */
+		bool bRestrictFrameBuffering = true;
+
+		/*
+		 * Replace the timing info when set. A frame lasts two ticks, so the frame rate is TimeScale / (2 * NumUnitsInTick).
+		 */
+		TOptional<uint32> TimeScale;
+		uint32 NumUnitsInTick = 1;
+		bool bFixedFrameRate = false;
+	};
+
+	/*
+	 * Rewrite the VUI of an SPS, copying every other field as is.
+	 *
+	 * @param InNaluInfo SPS as found by FindNALUs.
+	 * @param Rewrite Values to patch into the VUI.
+	 * @param OutNalu Receives the rewritten SPS as an escaped NALU, including the start code.
+	 * @return Success, or an error if the SPS could not be parsed.
+	 */
+	AVCODECSCORE_API FAVResult RewriteSPS(FNaluInfo const& InNaluInfo, FVUIRewrite const& Rewrite, TArray<uint8>& OutNalu);
+
+	/*
+	 * Rewrite the VUI of every SPS in an Annex-B packet. The packet is pointed at a new buffer if it contained an SPS and is left alone otherwise.
+	 */
+	AVCODECSCORE_API FAVResult RewriteSPS(FVideoPacket& InOutPacket, FVUIRewrite const& Rewrite);
+
 	struct PPS_t : public FNalu
 	{
 		UE pic_parameter_set_id;
@@ -531,12 +569,53 @@ namespace UE::AVCodecCore::H264
 		U<1> adaptive_ref_pic_marking_mode_flag;
 	};
 
-	FAVResult ParseSliceHeader(FBitstreamReader& Bitstream, FNaluInfo const& InNaluInfo, TMap<uint32, SPS_t> InMapSPS, TMap<uint32, PPS_t> const& InMapPPS, Slice_t& OutSlice);
+	FAVResult ParseSliceHeader(FBitstreamReader& Bitstream, FNaluInfo const& InNaluInfo, TMap<uint32, SPS_t> const& InMapSPS, TMap<uint32, PPS_t> const& InMapPPS, Slice_t& OutSlice);
 
-	// SEI can transmit arbitrary data so we probably want something less rigid for this
+	// SEI can transmit arbitrary data so messages are kept as raw payloads, see CodecUtilsSEI.h for helpers to interpret them
 	struct SEI_t
 	{
+		TArray<SEI::FMessage> Messages;
 	};
 
 	FAVResult ParseSEI(FBitstreamReader& Bitstream, FNaluInfo const& InNaluInfo, SEI_t& OutSEI);
+
+	/*
+	 * Insert an SEI NALU holding a single message in front of the first slice of an Annex-B packet. The packet is pointed at a new buffer.
+	 */
+	AVCODECSCORE_API FAVResult InsertSEI(FVideoPacket& InOutPacket, SEI::EPayloadType PayloadType, TConstArrayView<uint8> Payload);
+
+	/*
+	 * Parameter sets outlive the packet they arrive in, so a stream is parsed through one of these that owns every SPS and PPS seen so far.
+	 * Slices are parsed against the sets in place and callers only ever get const views of them.
+	 */
+	class AVCODECSCORE_API FParserState
+	{
+	public:
+		/*
+		 * Parse every NALU in an Annex-B packet, updating the parameter sets and appending any slice headers and SEI.
+		 */
+		FAVResult ParsePacket(FVideoPacket const& InPacket, TArray<Slice_t>& OutSlices, TArray<SEI_t>& OutSEI);
+
+		/*
+		 * Parse a single NALU as found by FindNALUs.
+		 */
+		FAVResult ParseNalu(FNaluInfo const& InNaluInfo, TArray<Slice_t>& OutSlices, TArray<SEI_t>& OutSEI);
+
+		SPS_t const* FindSPS(uint32 Id) const { return SPS.Find(Id); }
+		PPS_t const* FindPPS(uint32 Id) const { return PPS.Find(Id); }
+
+		// Active parameter sets for a parsed slice, or null if the slice refers to a set we have not seen
+		PPS_t const* FindPPS(Slice_t const& Slice) const { return PPS.Find(Slice.pic_parameter_set_id); }
+		SPS_t const* FindSPS(Slice_t const& Slice) const;
+
+		TMap<uint32, SPS_t> const& GetSPS() const { return SPS; }
+		TMap<uint32, PPS_t> const& GetPPS() const { return PPS; }
+
+		// Forget every parameter set, for when a stream is restarted
+		void Reset();
+
+	private:
+		TMap<uint32, SPS_t> SPS;
+		TMap<uint32, PPS_t> PPS;
+	};
 } // namespace UE::AVCodecCore::H264
@@ -9,6 +9,7 @@
 #include "Containers/StaticArray.h"
 #include "AVResult.h"
 #include "Math/MathFwd.h"
+#include "Video/CodecUtils/CodecUtilsSEI.h"
 
 struct FH265ProfileDefinition;
 struct FVideoPacket;
@@ -304,6 +305,9 @@ namespace UE::AVCodecCore::H265
 		U<3> nuh_temporal_id_plus1 = 0;
 		const uint8* EBSP = nullptr;
 
+		// Hash of the escaped payload, only calculated for parameter sets so we can tell when they change
+		uint64 ContentHash = 0;
+
 		bool IsSlice()
 		{
 			return	nal_unit_type == ENaluType::TRAIL_N ||
@@ -1053,6 +1057,7 @@ public:
 
 	struct FNaluSEI : public FNaluH265
 	{
+		TArray<SEI::FMessage> Messages;
 
 		FNaluSEI() = delete;
 		FNaluSEI(FNaluH265 const& InNaluH265)
@@ -1061,4 +1066,9 @@ public:
 		FAVResult Parse();
 	};
 
+	/*
+	 * Insert a prefix SEI NALU holding a single message in front of the first slice of an Annex-B packet. The packet is pointed at a new buffer.
+	 */
+	AVCODECSCORE_API FAVResult InsertSEI(FVideoPacket& InOutPacket, SEI::EPayloadType PayloadType, TConstArrayView<uint8> Payload);
+
 } // namespace UE::AVCodecCore::H265
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utils/BitstreamReader.h"
+#include "Utils/BitstreamWriter.h"
+
+#include "AVResult.h"
+#include "Video/VideoPacket.h"
+
+/*
+ * Supplemental enhancement information shared by H.264 and H.265. The sei_message syntax and payload types are the same in both, only the NAL header differs.
+ */
+namespace UE::AVCodecCore::SEI
+{
+	// Payload types from Annex D of T-REC-H.264 and T-REC-H.265, only the ones we are likely to meet are listed
+	enum class EPayloadType : uint32
+	{
+		BufferingPeriod = 0,
+		PicTiming = 1,
+		PanScanRect = 2,
+		FillerPayload = 3,
+		UserDataRegisteredITUTT35 = 4,
+		UserDataUnregistered = 5,
+		RecoveryPoint = 6,
+		MasteringDisplayColourVolume = 137,
+		ContentLightLevelInfo = 144,
+	};
+
+	struct FMessage
+	{
+		EPayloadType PayloadType = EPayloadType::UserDataUnregistered;
+
+		// Un-escaped payload bytes
+		TArray<uint8> Payload;
+	};
+
+	/*
+	 * Read every sei_message in an sei_rbsp. The reader should be positioned just after the NAL header.
+	 */
+	AVCODECSCORE_API FAVResult ParseMessages(FBitstreamReader& Bitstream, TArray<FMessage>& OutMessages);
+
+	/*
+	 * Write a single sei_message. The caller is responsible for the NAL header and the rbsp_trailing_bits.
+	 */
+	AVCODECSCORE_API void WriteMessage(FBitstreamWriter& Writer, EPayloadType PayloadType, TConstArrayView<uint8> Payload);
+
+	/*
+	 * Build a complete Annex-B SEI NALU with a four byte start code, holding a single message.
+	 */
+	AVCODECSCORE_API void MakeNalu(TConstArrayView<uint8> NalHeader, EPayloadType PayloadType, TConstArrayView<uint8> Payload, TArray<uint8>& OutNalu);
+
+	/*
+	 * Splice a complete Annex-B NALU into a packet at a byte offset, replacing the packet's data.
+	 */
+	AVCODECSCORE_API void InsertNalu(FVideoPacket& InOutPacket, uint64 Offset, TConstArrayView<uint8> Nalu);
+
+	/*
+	 * user_data_unregistered is identified by a 16 byte UUID followed by free form data.
+	 */
+	constexpr int32 UUIDSize = 16;
+
+	/*
+	 * Find the first user_data_unregistered message with a matching UUID, returning the data after the UUID.
+	 */
+	AVCODECSCORE_API bool FindUserDataUnregistered(TArray<FMessage> const& Messages, uint8 const (&UUID)[UUIDSize], TConstArrayView<uint8>& OutData);
+
+	/*
+	 * Per frame timestamps carried in user_data_unregistered, so that a receiver can measure latency against the moment the frame was captured.
+	 * All times are wall clock microseconds since the Unix epoch, so sender and receiver clocks need to be in sync for the results to mean anything.
+	 */
+	struct FFrameTiming
+	{
+		AVCODECSCORE_API static uint8 const UUID[UUIDSize];
+
+		int64 CaptureTimeUs = 0;
+		int64 EncodeStartTimeUs = 0;
+		int64 EncodeEndTimeUs = 0;
+
+		AVCODECSCORE_API void Serialize(TArray<uint8>& OutPayload) const;
+		AVCODECSCORE_API bool Deserialize(TArray<FMessage> const& Messages);
+	};
+} // namespace UE::AVCodecCore::SEI
@@ -10,8 +10,8 @@
  */
 struct AVCODECSCORE_API FVideoDecoderConfigH264 : public FVideoDecoderConfig
 {
-	TMap<uint32, UE::AVCodecCore::H264::SPS_t> SPS;
-	TMap<uint32, UE::AVCodecCore::H264::PPS_t> PPS;
+	// Owns the SPS and PPS received so far, query it for the parameter sets a parsed slice refers to
+	UE::AVCodecCore::H264::FParserState ParserState;
 	TArray<UE::AVCodecCore::H264::SEI_t> SEI;
 
 	FVideoDecoderConfigH264(EAVPreset Preset = EAVPreset::Default)
@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Video/VideoEncoder.h"
+
+enum class EVPXVersion : uint8
+{
+	VP8 = 8,
+	VP9 = 9
+};
+
+/*
+ * Configuration settings for the libvpx software encoder.
+ */
+struct FVideoEncoderConfigVPX : public FVideoEncoderConfig
+{
+public:
+	EVPXVersion Version = EVPXVersion::VP8;
+
+	// Speed against quality, higher is faster. Real time encoding wants the upper end of the range, 0 to 16 for VP8 and 0 to 9 for VP9.
+	int32 CpuUsed = 8;
+
+	// Threads libvpx may spread a frame across, 0 picks from the core count and frame width
+	uint32 NumThreads = 0;
+
+	FVideoEncoderConfigVPX(EAVPreset Preset = EAVPreset::Default)
+		: FVideoEncoderConfig(Preset)
+	{
+	}
+};
+
+DECLARE_TYPEID(FVideoEncoderConfigVPX, AVCODECSCORE_API);
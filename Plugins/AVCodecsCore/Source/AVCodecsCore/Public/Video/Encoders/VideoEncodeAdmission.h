@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/*
+ * Decides whether a frame is worth submitting to an encoder that may be falling behind.
+ * Tracks how many frames are in flight and how long recent ones took to encode, and turns away delta frames that would only finish after the next frame is due.
+ * Dropping them up front keeps latency from building up in the encoder's own queues when the GPU is contended.
+ */
+class AVCODECSCORE_API FVideoEncodeAdmission
+{
+public:
+	/*
+	 * @param InMaxFramesInFlight Frames that may be admitted but not yet finished before delta frames are turned away regardless of timing, <= 0 for no limit.
+	 * @param InHistorySize Recent encode durations averaged to predict the next one.
+	 */
+	FVideoEncodeAdmission(int32 InMaxFramesInFlight, int32 InHistorySize = 16);
+
+	/*
+	 * Decide whether to encode a frame. A frame is always admitted if it is a keyframe, as dropping one leaves the receiver unable to decode anything until the next,
+	 * or if nothing else is in flight, as it then has the encoder to itself and cannot add to any backlog.
+	 *
+	 * @param bKeyframe Whether the frame is to be encoded as a keyframe.
+	 * @param FrameIntervalSeconds Time until the next frame is due, which this frame should be finished by.
+	 * @return True if the frame should be encoded, in which case OnEncodeFinished must be called once it is.
+	 */
+	bool Admit(bool bKeyframe, double FrameIntervalSeconds);
+
+	/*
+	 * Report that an admitted frame has finished encoding.
+	 *
+	 * @param EncodeSeconds Time the encoder spent on the frame.
+	 */
+	void OnEncodeFinished(double EncodeSeconds);
+
+	/*
+	 * Report that an admitted frame will not be encoded after all, freeing its place without counting it towards recent encode times.
+	 */
+	void OnEncodeAbandoned();
+
+	int32 GetMaxFramesInFlight() const { return MaxFramesInFlight; }
+	int32 NumFramesInFlight() const;
+
+	uint64 NumAdmitted() const;
+	uint64 NumDropped() const;
+
+	/*
+	 * @return Average time the encoder spent on recent frames, zero until a frame has finished.
+	 */
+	double GetAverageEncodeSeconds() const;
+
+private:
+	double GetAverageEncodeSecondsLocked() const;
+
+	int32 const MaxFramesInFlight;
+	int32 const HistorySize;
+
+	mutable FCriticalSection Guard;
+
+	// Most recent encode durations, written round robin
+	TArray<double> History;
+	int32 HistoryNext = 0;
+	double HistorySum = 0.0;
+
+	int32 FramesInFlight = 0;
+
+	// When the encoder is expected to be done with everything admitted so far
+	double BusyUntil = 0.0;
+
+	uint64 Admitted = 0;
+	uint64 Dropped = 0;
+};
@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "HAL/Event.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeCounter.h"
+
+#include <atomic>
+
+/*
+ * Runs encodes on a dedicated thread so that whoever submits a frame can get back to capturing the next one, and hands each result to a second thread for delivery.
+ * Both stages are first in first out, so results are always delivered in the order their frames were submitted.
+ */
+class AVCODECSCORE_API FVideoEncodePipeline
+{
+public:
+	// Runs on the completion thread once the frame has been encoded
+	using FCompleteFunc = TUniqueFunction<void()>;
+
+	// Runs on the encode thread and returns the work to deliver its result, which may be empty
+	using FEncodeFunc = TUniqueFunction<FCompleteFunc()>;
+
+	/*
+	 * @param InMaxFramesInFlight Frames that may be submitted but not yet delivered before Submit starts to block.
+	 * @param Name Prefix for the names of the two threads.
+	 */
+	FVideoEncodePipeline(int32 InMaxFramesInFlight, FString const& Name);
+
+	// Delivers everything already submitted before the threads are stopped
+	~FVideoEncodePipeline();
+
+	/*
+	 * Queue a frame to be encoded, waiting for an earlier frame to be delivered if MaxFramesInFlight are already in flight.
+	 * Submit and Flush are expected to be called from a single thread, the one feeding frames to the pipeline.
+	 *
+	 * @return False if the pipeline could not start its threads, in which case the frame is dropped.
+	 */
+	bool Submit(FEncodeFunc&& Encode);
+
+	/*
+	 * Wait until every submitted frame has been delivered.
+	 */
+	void Flush();
+
+	int32 GetMaxFramesInFlight() const { return MaxFramesInFlight; }
+	int32 NumFramesInFlight() const { return FramesInFlight.GetValue(); }
+
+private:
+	/*
+	 * A thread draining a queue of tasks.
+	 */
+	class FStage : public FRunnable
+	{
+	public:
+		FStage(FString const& Name);
+		virtual ~FStage() override;
+
+		bool IsRunning() const { return Thread != nullptr; }
+		void Enqueue(TUniqueFunction<void()>&& Task);
+
+	private:
+		virtual uint32 Run() override;
+		virtual void Stop() override;
+
+		TQueue<TUniqueFunction<void()>, EQueueMode::Mpsc> Tasks;
+		FEvent* TasksPending = nullptr;
+		std::atomic<bool> bStopping = false;
+		FRunnableThread* Thread = nullptr;
+	};
+
+	void OnFrameDelivered();
+
+	int32 const MaxFramesInFlight;
+	FThreadSafeCounter FramesInFlight;
+
+	// Triggered whenever a frame is delivered, for anyone waiting on a free slot or a flush
+	FEvent* FrameDelivered = nullptr;
+
+	// Declared after the state above so the threads stop before it is destroyed
+	TUniquePtr<FStage> CompleteStage;
+	TUniquePtr<FStage> EncodeStage;
+};
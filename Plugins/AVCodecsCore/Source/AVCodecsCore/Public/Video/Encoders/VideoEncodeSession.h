@@ -0,0 +1,172 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/UniquePtr.h"
+#include "Video/Encoders/VideoEncodeAdmission.h"
+#include "Video/Encoders/VideoKeyframeArbiter.h"
+
+/*
+ * How the rates asked for by each subscriber of a shared encode session are combined into the one the encoder runs at.
+ */
+enum class EVideoEncodeRatePolicy : uint8
+{
+	// The lowest rate asked for, so every subscriber can keep up
+	Minimum,
+	// The mean of the rates asked for, trading the slowest subscriber's experience for everyone else's
+	Average,
+};
+
+/*
+ * Bookkeeping for one encoder shared by every subscriber to the same stream, so that each captured frame is encoded once and the result fanned out to all of them.
+ * Subscribers each offer every frame, and only the first to offer a given frame gets to encode it.
+ * Rate changes asked for by subscribers are combined according to a policy, and keyframe requests are coalesced and spaced out by a keyframe arbiter.
+ */
+class AVCODECSCORE_API FVideoEncodeSession
+{
+public:
+	struct FRate
+	{
+		int32 Bitrate = 0;
+		double Framerate = 0.0;
+
+		bool operator==(FRate const& Other) const { return Bitrate == Other.Bitrate && Framerate == Other.Framerate; }
+		bool operator!=(FRate const& Other) const { return !(*this == Other); }
+	};
+
+	/*
+	 * @param InAdmission Decides which frames are worth submitting to the encoder, null to submit every frame.
+	 */
+	explicit FVideoEncodeSession(EVideoEncodeRatePolicy InRatePolicy = EVideoEncodeRatePolicy::Minimum, FVideoKeyframeArbiter const& InKeyframeArbiter = FVideoKeyframeArbiter(), TUniquePtr<FVideoEncodeAdmission> InAdmission = nullptr);
+
+	void Subscribe(void const* Subscriber);
+
+	// Drops the subscriber's rate, which may change the rate the encoder should run at
+	void Unsubscribe(void const* Subscriber);
+
+	int32 NumSubscribers() const;
+
+	/*
+	 * Set the rate a subscriber would like the encoder to run at, subscribing it if it is not already.
+	 * A subscriber asking for no bitrate has paused its stream, and is left out until it asks for one again so that it does not starve everyone else.
+	 */
+	void SetRate(void const* Subscriber, FRate const& Rate);
+
+	/*
+	 * @return The rate the encoder should run at given what every subscriber has asked for, unset if none has asked for anything yet.
+	 */
+	TOptional<FRate> GetRate() const;
+
+	/*
+	 * @return The rate the encoder should run at if it has changed since it was last taken, for whoever encodes the next frame to apply.
+	 */
+	TOptional<FRate> TakeRateChange();
+
+	/*
+	 * Give back a rate change taken for a frame that was never encoded, so whoever encodes the next frame takes it instead.
+	 */
+	void RestoreRateChange(FRate const& Rate);
+
+	/*
+	 * Record the rate the encoder now runs at, for whoever encodes a frame that carried a rate change.
+	 * Every subscriber configures the encoder from this rather than from a rate of its own, which would undo the policy whenever a different subscriber encodes a frame.
+	 */
+	void SetAppliedRate(FRate const& Rate);
+
+	/*
+	 * Record the rate the encoder was created with, unless a rate has already been applied to it.
+	 */
+	void SeedAppliedRate(FRate const& Rate);
+
+	/*
+	 * @return The rate the encoder was last configured with, unset until it has been seeded or applied.
+	 */
+	TOptional<FRate> GetAppliedRate() const;
+
+	/*
+	 * Ask for a keyframe, which the keyframe arbiter coalesces with other requests and may hold back or answer with intra refresh.
+	 *
+	 * @param Subscriber Who is asking. A subscriber that has not had a keyframe since subscribing needs a full one to start decoding, as does anyone unknown.
+	 * A subscriber without a keyframe is never taken to be answered by one that went out before it joined.
+	 */
+	void RequestKeyframe(void const* Subscriber = nullptr);
+
+	bool IsKeyframeRequested() const;
+
+	/*
+	 * @return How whoever encodes the next frame should answer outstanding keyframe requests, clearing them if they are answered.
+	 */
+	EVideoKeyframeDecision TakeKeyframeRequest();
+
+	/*
+	 * Report a keyframe coming out of the encoder, whether asked for or not, so every subscriber has one to decode from and the arbiter can space the next one out.
+	 */
+	void OnKeyframeEncoded();
+
+	/*
+	 * Offer a captured frame for encoding.
+	 *
+	 * @param FrameKey Identifies the captured frame, the same for every subscriber offering it.
+	 * @return True if the caller is the first to offer the frame and should encode it, false if it already has been or is being encoded for everyone.
+	 */
+	bool ClaimFrame(uint64 FrameKey);
+
+	/*
+	 * To be held by whoever encodes a frame for the session, from reconfiguring the encoder and sending it the frame until its packets are collected.
+	 * Subscribers encode on their own threads, so without it two frames could be in the encoder at once and their packets mixed up.
+	 */
+	FCriticalSection& GetEncodeGuard() { return EncodeGuard; }
+
+	/*
+	 * @return The admission control every subscriber's frames go through, as they all queue on the same encoder, or null if frames are not turned away.
+	 */
+	FVideoEncodeAdmission* GetAdmission() const { return Admission.Get(); }
+
+	EVideoEncodeRatePolicy GetRatePolicy() const { return RatePolicy; }
+
+	uint64 NumFramesClaimed() const;
+	uint64 NumFramesShared() const;
+	uint64 NumKeyframeRequests() const;
+	uint64 NumKeyframesTaken() const;
+	uint64 NumIntraRefreshesTaken() const;
+
+private:
+	struct FSubscriber
+	{
+		// The rate last asked for, if any
+		TOptional<FRate> Rate;
+		// Whether a keyframe has gone out since subscribing
+		bool bHasKeyframe = false;
+	};
+
+	TOptional<FRate> GetRateLocked() const;
+
+	EVideoEncodeRatePolicy const RatePolicy;
+
+	mutable FCriticalSection Guard;
+
+	// Separate from Guard, which is only ever held briefly, so subscribers can request keyframes and rates while a frame is encoding
+	FCriticalSection EncodeGuard;
+
+	TMap<void const*, FSubscriber> Subscribers;
+
+	TOptional<FRate> LastTakenRate;
+
+	TOptional<FRate> AppliedRate;
+
+	FVideoKeyframeArbiter KeyframeArbiter;
+
+	// Thread safe on its own, so it is never touched under Guard
+	TUniquePtr<FVideoEncodeAdmission> const Admission;
+
+	// Frames offered most recently, written round robin, as subscribers may offer the same frames slightly out of step with each other
+	static constexpr int32 NumRecentFrames = 8;
+	uint64 RecentFrames[NumRecentFrames] = {};
+	int32 NumRecent = 0;
+	int32 RecentNext = 0;
+
+	uint64 FramesClaimed = 0;
+	uint64 FramesShared = 0;
+};
@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Video/VideoEncoder.h"
+#include "Video/Encoders/Configs/VideoEncoderConfigVPX.h"
+#include "Video/Resources/VideoResourceCPU.h"
+#include "Utils/PacketRing.h"
+
+struct vpx_image;
+
+/**
+ * Software VP8/VP9 encoder backed by libvpx, for hosts without a hardware encoder.
+ * Takes BGRA or NV12 frames in system memory and converts them to I420 for libvpx.
+ */
+class AVCODECSCORE_API FVideoEncoderVPX : public TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>
+{
+private:
+	// libvpx state, kept out of this header so consumers do not need the libvpx includes
+	struct FCodec;
+
+	TUniquePtr<FCodec> Codec;
+	uint8 bOpen : 1;
+
+	uint64 FrameCount = 0;
+
+	UE::AVCodecCore::TPacketRing<FVideoPacket> Packets;
+
+public:
+	FVideoEncoderVPX();
+	virtual ~FVideoEncoderVPX() override;
+
+	virtual bool IsOpen() const override;
+	virtual FAVResult Open(TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance) override;
+	virtual void Close() override;
+
+	bool IsInitialized() const;
+
+	virtual FAVResult ApplyConfig() override;
+
+	virtual FAVResult SendFrame(TSharedPtr<FVideoResourceCPU> const& Resource, uint64 Timestamp, bool bForceKeyframe = false, uint64 UserData = 0) override;
+
+	virtual FAVResult ReceivePacket(FVideoPacket& OutPacket) override;
+	virtual FAVResult WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime) override;
+
+private:
+	FAVResult Encode(vpx_image const* Image, uint64 Timestamp, bool bForceKeyframe, uint64 UserData);
+};
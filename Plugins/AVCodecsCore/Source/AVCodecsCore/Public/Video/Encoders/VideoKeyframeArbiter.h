@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * How an encoder should answer outstanding keyframe requests with the frame it is about to encode.
+ */
+enum class EVideoKeyframeDecision : uint8
+{
+	// Nothing to answer, or requests are being held back, so encode as usual
+	None,
+	// Force a full keyframe
+	Keyframe,
+	// Leave it to the intra refresh the encoder is running, which heals the stream without the spike of a full keyframe
+	IntraRefresh,
+};
+
+/*
+ * Decides when keyframe requests for an encoder are answered, so that a burst of them does not turn into a burst of keyframes.
+ * Requests arriving shortly after a keyframe are taken to be answered by it, and requests arriving before the next keyframe is allowed are held and answered together.
+ * Times are passed in rather than read from the clock so behaviour is deterministic. Not thread safe, callers sharing one are expected to guard it.
+ */
+class AVCODECSCORE_API FVideoKeyframeArbiter
+{
+public:
+	/*
+	 * @param InCoalesceWindowSeconds Requests arriving within this long of a keyframe being answered are taken to be answered by it.
+	 * @param InMinKeyframeSpacingSeconds Least time between two full keyframes, requests arriving sooner are held until it has passed.
+	 * @param bInPreferIntraRefresh Whether the encoder runs intra refresh, in which case requests that do not need a full keyframe are left to it.
+	 */
+	FVideoKeyframeArbiter(double InCoalesceWindowSeconds = 0.0, double InMinKeyframeSpacingSeconds = 0.0, bool bInPreferIntraRefresh = false);
+
+	/*
+	 * Ask for a keyframe.
+	 *
+	 * @param NowSeconds Time of the request.
+	 * @param bFullKeyframe Whether the requester cannot make do with intra refresh, such as a receiver that has not decoded anything yet.
+	 * @param bMissedLastKeyframe Whether the requester started receiving after the last keyframe went out, so it cannot have been answered by it however recent it was.
+	 */
+	void Request(double NowSeconds, bool bFullKeyframe = false, bool bMissedLastKeyframe = false);
+
+	bool HasPendingRequest() const { return bPending; }
+
+	/*
+	 * Decide how to answer outstanding requests with the next frame, to be called once for each frame about to be encoded.
+	 * Outstanding requests are cleared once answered.
+	 *
+	 * @param NowSeconds Time the frame is encoded.
+	 */
+	EVideoKeyframeDecision Decide(double NowSeconds);
+
+	/*
+	 * Report a keyframe the encoder produced of its own accord, such as its first frame or one from its keyframe interval, so it counts towards spacing.
+	 */
+	void OnKeyframe(double NowSeconds);
+
+	double GetCoalesceWindowSeconds() const { return CoalesceWindowSeconds; }
+	double GetMinKeyframeSpacingSeconds() const { return MinKeyframeSpacingSeconds; }
+	bool PrefersIntraRefresh() const { return bPreferIntraRefresh; }
+
+	uint64 NumRequests() const { return Requests; }
+	uint64 NumCoalesced() const { return Coalesced; }
+	uint64 NumKeyframes() const { return Keyframes; }
+	uint64 NumIntraRefreshes() const { return IntraRefreshes; }
+
+private:
+	double CoalesceWindowSeconds;
+	double MinKeyframeSpacingSeconds;
+	bool bPreferIntraRefresh;
+
+	bool bPending = false;
+	bool bPendingFull = false;
+
+	// Set once there has been a keyframe, so that intra refresh has something to work from
+	TOptional<double> LastKeyframeTime;
+	TOptional<double> LastAnswerTime;
+	bool bLastAnswerFull = false;
+
+	uint64 Requests = 0;
+	uint64 Coalesced = 0;
+	uint64 Keyframes = 0;
+	uint64 IntraRefreshes = 0;
+};
@@ -6,6 +6,8 @@
 #include "Video/VideoPacket.h"
 #include "Video/VideoResource.h"
 
+#include "Misc/Timespan.h"
+
 /*
  * Implementation of Video Encoding domain, see TAVCoder for inheritance model
  */
@@ -131,7 +133,7 @@ public:
 		{
 		}
 
-		virtual FAVResult SendFrame(TSharedPtr<TResource> const& Resource, uint32 Timestamp, bool bForceKeyframe = false) override
+		virtual FAVResult SendFrame(TSharedPtr<TResource> const& Resource, uint64 Timestamp, bool bForceKeyframe = false, uint64 UserData = 0) override
 		{
 			if (!this->IsOpen())
 			{
@@ -146,7 +148,7 @@ public:
 
 			if (!Resource.IsValid())
 			{
-				return this->Child->SendFrame(nullptr, Timestamp, bForceKeyframe);
+				return this->Child->SendFrame(nullptr, Timestamp, bForceKeyframe, UserData);
 			}
 
 			FScopeLock const Lock = Resource->LockScope();
@@ -163,7 +165,7 @@ public:
 				}
 			}
 
-			Result = this->Child->SendFrame(MappedResource, Timestamp, bForceKeyframe);
+			Result = this->Child->SendFrame(MappedResource, Timestamp, bForceKeyframe, UserData);
 
 			MappedResource.Reset();
 
@@ -179,6 +181,16 @@ public:
 
 			return this->Child->ReceivePacket(OutPacket);
 		}
+
+		virtual FAVResult WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime) override
+		{
+			if (!this->IsOpen())
+			{
+				return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"));
+			}
+
+			return this->Child->WaitForPacket(OutPacket, WaitTime);
+		}
 	};
 
 	/**
@@ -218,11 +230,12 @@ public:
 	 * Send a frame to the underlying codec architecture.
 	 *
 	 * @param Resource Resource holding the frame data. An invalid resource will perform a flush (@see FlushPackets) and invalidate the underlying architecture.
-	 * @param Timestamp Recorded timestamp of the frame.
+	 * @param Timestamp Presentation timestamp of the frame in microseconds, copied to every packet encoded from it.
 	 * @param bForceKeyframe Whether the frame should be forced to be a keyframe.
+	 * @param UserData Opaque value copied to every packet encoded from the frame, so callers can find their own frame metadata again without a lookup.
 	 * @return Result of the operation, @see FAVResult.
 	 */
-	virtual FAVResult SendFrame(TSharedPtr<TResource> const& Resource, uint32 Timestamp, bool bForceKeyframe = false) = 0;
+	virtual FAVResult SendFrame(TSharedPtr<TResource> const& Resource, uint64 Timestamp, bool bForceKeyframe = false, uint64 UserData = 0) = 0;
 
 	/**
 	 * Flush remaining packets and invalidate the underlying architecture.
@@ -268,6 +281,20 @@ public:
 	 */
 	virtual FAVResult ReceivePacket(FVideoPacket& OutPacket) = 0;
 
+	/**
+	 * Read a finished packet out of the codec, waiting for one to finish if there is none yet.
+	 * Only worth calling when frames are sent from another thread, as nothing finishes while the caller waits otherwise.
+	 * Coders that cannot wait check once, the same as ReceivePacket.
+	 *
+	 * @param OutPacket Output packet if one is complete.
+	 * @param WaitTime Longest to wait for a packet.
+	 * @return Result of the operation, PendingInput if no packet finished in time, @see FAVResult.
+	 */
+	virtual FAVResult WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime)
+	{
+		return ReceivePacket(OutPacket);
+	}
+
 	/**
 	 * Read all finished packets out of the codec.
 	 *
@@ -281,7 +308,7 @@ public:
 		FVideoPacket Packet;
 		while ((Result = ReceivePacket(Packet)).IsSuccess())
 		{
-			OutPackets.Add(Packet);
+			OutPackets.Add(MoveTemp(Packet));
 		}
 
 		return Result;
@@ -21,8 +21,8 @@ public:
 	uint8 bIsKeyframe : 1;
 
 	FVideoPacket() = default;
-	FVideoPacket(TSharedPtr<uint8> const& DataPtr, uint64 DataSize, uint64 Timestamp, uint64 Index, uint32 QP, bool bIsKeyframe)
-		: FAVPacket(DataPtr, DataSize, Timestamp, Index)
+	FVideoPacket(TSharedPtr<uint8> const& DataPtr, uint64 DataSize, uint64 Timestamp, uint64 Index, uint32 QP, bool bIsKeyframe, uint64 UserData = 0)
+		: FAVPacket(DataPtr, DataSize, Timestamp, Index, UserData)
 		, QP(QP)
 		, bIsKeyframe(bIsKeyframe)
 	{
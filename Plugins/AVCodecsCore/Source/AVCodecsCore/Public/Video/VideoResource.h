@@ -65,19 +65,12 @@ public:
 
 	/**
 	 * If this is a descriptor stored in a different format than it really is
-	 * for transport then its raw descriptor should be described in this variable
+	 * for transport then its raw descriptor should be described in this variable.
+	 * Always points at an interned descriptor from Intern, so descriptors copy as plain values.
 	 */
-	mutable FVideoDescriptor* RawDescriptor;
+	mutable FVideoDescriptor const* RawDescriptor = nullptr;
 
 	FVideoDescriptor() = default;
-	FVideoDescriptor(const FVideoDescriptor& Descriptor)
-		: Format(Descriptor.Format)
-		, Width(Descriptor.Width)
-		, Height(Descriptor.Height)
-		, RawDescriptor(Descriptor.RawDescriptor ? new FVideoDescriptor(*Descriptor.RawDescriptor) : nullptr)
-	{
-
-	}
 
 	FVideoDescriptor(EVideoFormat Format, uint32 Width, uint32 Height)
 		: Format(Format), Width(Width), Height(Height), RawDescriptor(nullptr)
@@ -85,18 +78,18 @@ public:
 	}
 
 	FVideoDescriptor(EVideoFormat Format, uint32 Width, uint32 Height, const FVideoDescriptor& RawDescriptor)
-		: Format(Format), Width(Width), Height(Height), RawDescriptor(new FVideoDescriptor(RawDescriptor))
+		: Format(Format), Width(Width), Height(Height), RawDescriptor(Intern(RawDescriptor))
 	{
-
 	}
 
-	~FVideoDescriptor()
-	{ 
-		if(RawDescriptor)
-		{
-			delete RawDescriptor;
-		}
-	};
+	/**
+	 * Find or add the shared copy of a raw descriptor, which lives for the rest of the process.
+	 * Only the first lookup of each distinct format and size allocates, and only its format and size are kept,
+	 * as a raw descriptor never has a raw descriptor of its own.
+	 *
+	 * @return The shared copy, equal to Descriptor.
+	 */
+	static AVCODECSCORE_API FVideoDescriptor const* Intern(FVideoDescriptor const& Descriptor);
 
 	bool operator==(FVideoDescriptor const &RHS) const
 	{
@@ -108,6 +101,12 @@ public:
 		return !(*this == RHS);
 	}
 
+	// Covers the same fields as operator==, so the raw descriptor does not take part
+	friend uint32 GetTypeHash(FVideoDescriptor const &Descriptor)
+	{
+		return HashCombine(::GetTypeHash(Descriptor.Format), HashCombine(::GetTypeHash(Descriptor.Width), ::GetTypeHash(Descriptor.Height)));
+	}
+
 	// Planar formats are treated as single channel 
 	uint8 GetNumChannels() const
 	{
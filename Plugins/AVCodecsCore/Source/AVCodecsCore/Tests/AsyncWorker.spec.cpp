@@ -0,0 +1,162 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadSafeCounter.h"
+
+#include <Utils/AsyncWorker.h>
+
+DEFINE_SPEC(AsyncWorkerSpec, "AVCodecsCore.AsyncWorker", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace AsyncWorkerSpecPrivate
+{
+	using namespace UE::AVCodecCore;
+
+	constexpr int32 NumTasks = 32;
+
+	// Stand in for an encoder busy with a frame
+	constexpr float WorkSeconds = 0.004f;
+
+	double RunSynchronous(FThreadSafeCounter& NumRun)
+	{
+		double const StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumTasks; ++i)
+		{
+			FPlatformProcess::Sleep(WorkSeconds);
+			NumRun.Increment();
+		}
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	double RunAsync(FAsyncWorker& Worker, FThreadSafeCounter& NumRun)
+	{
+		double const StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumTasks; ++i)
+		{
+			Worker.Enqueue([&NumRun]() {
+				FPlatformProcess::Sleep(WorkSeconds);
+				NumRun.Increment();
+			});
+		}
+
+		Worker.Flush();
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+} // namespace AsyncWorkerSpecPrivate
+
+void AsyncWorkerSpec::Define()
+{
+	using namespace AsyncWorkerSpecPrivate;
+
+	Describe("Idle", [this]() {
+		It("should sleep while there is nothing to do", [this]() {
+			FAsyncWorker Worker(TEXT("Async Worker Spec"), 4, EAsyncWorkerOverflow::Block);
+
+			FThreadSafeCounter NumRun;
+			Worker.Enqueue([&NumRun]() { NumRun.Increment(); });
+			Worker.Flush();
+
+			// A worker polling its queue would wake up thousands of times over this, one waiting on its event not at all
+			int32 const WakeupsBefore = Worker.NumWakeups();
+			FPlatformProcess::Sleep(0.25f);
+
+			TestTrue("should", Worker.NumWakeups() - WakeupsBefore <= 1);
+			TestEqual("should", NumRun.GetValue(), 1);
+		});
+	});
+
+	Describe("Ordering", [this]() {
+		It("should run tasks in the order they were queued", [this]() {
+			TArray<int32> Ran;
+			{
+				FAsyncWorker Worker(TEXT("Async Worker Spec"), 4, EAsyncWorkerOverflow::Block);
+				for (int32 i = 0; i < NumTasks; ++i)
+				{
+					Worker.Enqueue([&Ran, i]() { Ran.Add(i); });
+				}
+			}
+
+			TArray<int32> Expected;
+			for (int32 i = 0; i < NumTasks; ++i)
+			{
+				Expected.Add(i);
+			}
+
+			TestEqual("should", Ran, Expected);
+		});
+	});
+
+	Describe("Overflow", [this]() {
+		It("should wait for room when blocking", [this]() {
+			FAsyncWorker Worker(TEXT("Async Worker Spec"), 2, EAsyncWorkerOverflow::Block);
+
+			FThreadSafeCounter NumRun;
+			int32 MostQueued = 0;
+			for (int32 i = 0; i < 8; ++i)
+			{
+				Worker.Enqueue([&NumRun]() {
+					FPlatformProcess::Sleep(WorkSeconds);
+					NumRun.Increment();
+				});
+
+				MostQueued = FMath::Max(MostQueued, Worker.NumQueued());
+			}
+
+			Worker.Flush();
+
+			TestTrue("should", MostQueued <= 2);
+			TestEqual("should", NumRun.GetValue(), 8);
+			TestEqual("should", Worker.NumDropped(), 0);
+		});
+
+		It("should throw away the oldest task when dropping", [this]() {
+			FAsyncWorker Worker(TEXT("Async Worker Spec"), 2, EAsyncWorkerOverflow::DropOldest);
+
+			// Hold the worker on the first task so the rest pile up behind it
+			FEvent* Release = FPlatformProcess::GetSynchEventFromPool(true);
+			TArray<int32> Ran;
+
+			Worker.Enqueue([Release, &Ran]() {
+				Release->Wait();
+				Ran.Add(0);
+			});
+
+			// Wait for the worker to pick it up, so it does not count against the queue
+			while (Worker.NumQueued() > 0)
+			{
+				FPlatformProcess::Sleep(0.001f);
+			}
+
+			for (int32 i = 1; i <= 4; ++i)
+			{
+				Worker.Enqueue([&Ran, i]() { Ran.Add(i); });
+			}
+
+			Release->Trigger();
+			Worker.Flush();
+			FPlatformProcess::ReturnSynchEventToPool(Release);
+
+			TestEqual("should", Ran, TArray<int32>({ 0, 3, 4 }));
+			TestEqual("should", Worker.NumDropped(), 2);
+		});
+	});
+
+	Describe("Throughput", [this]() {
+		It("should keep up with running the same work synchronously", [this]() {
+			FThreadSafeCounter SynchronousRun;
+			double const SynchronousSeconds = RunSynchronous(SynchronousRun);
+
+			FAsyncWorker Worker(TEXT("Async Worker Spec"), 4, EAsyncWorkerOverflow::Block);
+
+			FThreadSafeCounter AsyncRun;
+			double const AsyncSeconds = RunAsync(Worker, AsyncRun);
+
+			TestEqual("should", AsyncRun.GetValue(), SynchronousRun.GetValue());
+
+			// Ideally the same, the margin keeps a busy test machine from failing it
+			TestTrue("should", AsyncSeconds < SynchronousSeconds * 1.5);
+		});
+	});
+}
@@ -0,0 +1,312 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#include <Utils/BitstreamReader.h>
+#include <Video/CodecUtils/CodecUtilsH265.h>
+
+DEFINE_SPEC(BitstreamReaderSpec, "AVCodecsCore.BitstreamReader", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace BitstreamReaderSpecPrivate
+{
+	// Escape an RBSP the same way an encoder would, inserting 0x03 wherever two zeros are followed by a byte <= 0x03
+	TArray<uint8> RBSPtoEBSP(TArray<uint8> const& RBSP)
+	{
+		TArray<uint8> EBSP;
+		int32 Zeros = 0;
+		for (uint8 const Byte : RBSP)
+		{
+			if (Zeros == 2 && Byte <= 0x03)
+			{
+				EBSP.Add(0x03);
+				Zeros = 0;
+			}
+
+			EBSP.Add(Byte);
+			Zeros = Byte == 0 ? Zeros + 1 : 0;
+		}
+
+		return EBSP;
+	}
+
+	TArray<uint8> MakeRBSP(int32 Seed, int32 Size)
+	{
+		FRandomStream Random(Seed);
+
+		TArray<uint8> RBSP;
+		RBSP.SetNumUninitialized(Size);
+		for (uint8& Byte : RBSP)
+		{
+			// Bias heavily towards zeros so that plenty of emulation prevention is needed
+			Byte = (uint8)(Random.RandRange(0, 3) == 0 ? Random.RandRange(0, 255) : Random.RandRange(0, 1) * Random.RandRange(0, 3));
+		}
+
+		return RBSP;
+	}
+
+	// The reader as it was before the cached window, one byteswapped 32 bit peek per read and exp-golomb decoded a bit at a time. Kept as the benchmark baseline.
+	struct FLegacyBitstreamReader
+	{
+		FLegacyBitstreamReader(uint8 const* Data, uint64 DataSize)
+			: Data(Data)
+			, DataSize(DataSize)
+		{
+		}
+
+		uint32 PeekBits(uint64 NumBits) const
+		{
+			uint64 const PeekBytesRemaining = DataSize - BytePosition;
+
+			uint32 Result = 0;
+			if (PeekBytesRemaining >= 4)
+			{
+				FMemory::Memcpy(&Result, Data + BytePosition, sizeof(Result));
+				Result = NETWORK_ORDER32(Result);
+			}
+			else
+			{
+				for (uint64 i = 0; i < PeekBytesRemaining; ++i)
+				{
+					Result |= (uint32)Data[BytePosition + i] << (24 - i * 8);
+				}
+			}
+
+			if (BitPosition != 0)
+			{
+				uint8 const Next = PeekBytesRemaining > 4 ? Data[BytePosition + 4] : 0;
+				Result = (Result << BitPosition) | uint32(Next >> (8 - BitPosition));
+			}
+
+			return Result >> (32 - NumBits);
+		}
+
+		uint32 ReadBits(uint64 NumBits)
+		{
+			uint32 const Result = PeekBits(NumBits);
+
+			uint64 const NewBitPosition = BitPosition + NumBits;
+			BitPosition = NewBitPosition & 7;
+			BytePosition += NewBitPosition >> 3;
+
+			return Result;
+		}
+
+		uint32 ReadUE()
+		{
+			int32 lz = -1;
+			for (uint32 b = 0; b == 0; ++lz)
+			{
+				b = ReadBits(1);
+			}
+
+			return lz ? ((1u << lz) | ReadBits(lz)) - 1 : 0u;
+		}
+
+		uint64 NumBitsRemaining() const
+		{
+			return (DataSize - BytePosition) * 8 - BitPosition;
+		}
+
+		uint8 const* Data;
+		uint64 DataSize;
+		uint64 BytePosition = 0;
+		uint8 BitPosition = 0;
+	};
+
+	// Random bytes give exp-golomb codes with roughly the same length distribution as the ids, flags and sizes that make up parameter sets and slice headers
+	TArray<TArray<uint8>> MakeParameterSetCorpus(int32 Seed, int32 NumSets)
+	{
+		FRandomStream Random(Seed);
+
+		TArray<TArray<uint8>> Corpus;
+		for (int32 i = 0; i < NumSets; ++i)
+		{
+			TArray<uint8>& Set = Corpus.AddDefaulted_GetRef();
+			Set.SetNumUninitialized(Random.RandRange(16, 96));
+			for (uint8& Byte : Set)
+			{
+				Byte = (uint8)Random.RandRange(0, 255);
+			}
+		}
+
+		return Corpus;
+	}
+
+	// Mix of flags, fixed width fields and exp-golomb codes, stopping while there are still enough bits left for the longest exp-golomb code we'll meet in the corpus
+	template <typename TReader, typename TReadUE>
+	uint64 ParseParameterSet(TReader& Reader, TReadUE&& ReadUE)
+	{
+		uint64 Checksum = 0;
+		for (uint32 Field = 0; Reader.NumBitsRemaining() >= 64; ++Field)
+		{
+			switch (Field % 4)
+			{
+				case 0:
+					Checksum += Reader.ReadBits(1);
+					break;
+				case 1:
+					Checksum += Reader.ReadBits(1 + Field % 8);
+					break;
+				default:
+					Checksum += ReadUE(Reader);
+					break;
+			}
+		}
+
+		return Checksum;
+	}
+} // namespace BitstreamReaderSpecPrivate
+
+void BitstreamReaderSpec::Define()
+{
+	using namespace BitstreamReaderSpecPrivate;
+
+	Describe("EBSP", [this]() {
+		It("should read the same bits as an un-escaped RBSP", [this]() {
+			for (int32 Seed = 0; Seed < 32; ++Seed)
+			{
+				TArray<uint8> const RBSP = MakeRBSP(Seed, 64 + Seed * 31);
+				TArray<uint8> const EBSP = RBSPtoEBSP(RBSP);
+
+				FBitstreamReader RBSPReader(RBSP.GetData(), RBSP.Num());
+				FBitstreamReader EBSPReader = FBitstreamReader::FromEBSP(EBSP.GetData(), EBSP.Num());
+
+				FRandomStream Random(Seed);
+				for (uint64 BitsLeft = RBSP.Num() * 8; BitsLeft > 0;)
+				{
+					uint64 const NumBits = FMath::Min<uint64>(Random.RandRange(1, 32), BitsLeft);
+
+					TestEqual("should", EBSPReader.PeekBits(NumBits), RBSPReader.PeekBits(NumBits));
+					TestEqual("should", EBSPReader.ReadBits(NumBits), RBSPReader.ReadBits(NumBits));
+					TestEqual("should", EBSPReader.NumBitsRead(), RBSPReader.NumBitsRead());
+
+					BitsLeft -= NumBits;
+				}
+			}
+		});
+
+		It("should match EBSPtoRBSP on exp-golomb reads", [this]() {
+			TArray<uint8> const RBSP = MakeRBSP(0x265, 4096);
+			TArray<uint8> const EBSP = RBSPtoEBSP(RBSP);
+
+			TArray<uint8> Unescaped;
+			Unescaped.SetNumUninitialized(EBSP.Num());
+			Unescaped.SetNum(UE::AVCodecCore::H265::EBSPtoRBSP(Unescaped.GetData(), EBSP.GetData(), EBSP.Num()));
+
+			FBitstreamReader RBSPReader(Unescaped.GetData(), Unescaped.Num());
+			FBitstreamReader EBSPReader = FBitstreamReader::FromEBSP(EBSP.GetData(), EBSP.Num());
+
+			for (int32 i = 0; i < 512; ++i)
+			{
+				FBitstreamSegment::UE Expected, Actual;
+				RBSPReader.Read(Expected);
+				EBSPReader.Read(Actual);
+
+				TestEqual("should", Actual.Value, Expected.Value);
+			}
+		});
+
+		It("should skip bytes in payload space", [this]() {
+			uint8 const EBSP[] = { 0x00, 0x00, 0x03, 0x01, 0xAB };
+
+			FBitstreamReader Reader = FBitstreamReader::FromEBSP(EBSP, sizeof(EBSP));
+			Reader.SkipBytes(3);
+
+			TestEqual("should", Reader.ReadBits(8), 0xABu);
+			TestEqual("should", Reader.NumBitsRead(), (uint64)32);
+		});
+	});
+
+	Describe("ExpGolomb", [this]() {
+		It("should decode codes of every length", [this]() {
+			// Write every value 2^n - 1 + n, with n up to 31, so that codes are split across refills and some are too long to be decoded from the cache
+			TArray<uint8> RBSP;
+			uint64 NumBits = 0;
+			auto const WriteBit = [&RBSP, &NumBits](uint32 Bit) {
+				if ((NumBits & 7) == 0)
+				{
+					RBSP.Add(0);
+				}
+
+				RBSP.Last() |= (uint8)(Bit << (7 - (NumBits & 7)));
+				++NumBits;
+			};
+
+			TArray<uint32> Values;
+			for (uint32 n = 0; n < 32; ++n)
+			{
+				uint64 const Code = (uint64(1) << n) + n;
+				Values.Add(uint32(Code - 1));
+
+				for (uint32 i = 0; i < n; ++i)
+				{
+					WriteBit(0);
+				}
+
+				for (int32 i = n; i >= 0; --i)
+				{
+					WriteBit(uint32(Code >> i) & 1);
+				}
+			}
+
+			FBitstreamReader Reader(RBSP.GetData(), RBSP.Num());
+			for (uint32 const Expected : Values)
+			{
+				FBitstreamSegment::UE Actual;
+				Reader.Read(Actual);
+
+				TestEqual("should", Actual.Value, Expected);
+			}
+
+			TestEqual("should", Reader.NumBitsRead(), NumBits);
+		});
+
+		It("should match the legacy reader on parameter sets", [this]() {
+			for (TArray<uint8> const& Set : MakeParameterSetCorpus(0x264, 256))
+			{
+				FLegacyBitstreamReader LegacyReader(Set.GetData(), Set.Num());
+				FBitstreamReader Reader(Set.GetData(), Set.Num());
+
+				uint64 const Expected = ParseParameterSet(LegacyReader, [](FLegacyBitstreamReader& Legacy) { return Legacy.ReadUE(); });
+				uint64 const Actual = ParseParameterSet(Reader, [](FBitstreamReader& Cached) { FBitstreamSegment::UE Value; Cached.Read(Value); return Value.Value; });
+
+				TestEqual("should", Actual, Expected);
+			}
+		});
+	});
+
+	Describe("Benchmark", [this]() {
+		It("should report parameter set parse times against the legacy reader", [this]() {
+			TArray<TArray<uint8>> const Corpus = MakeParameterSetCorpus(0x265, 4096);
+
+			uint64 LegacyChecksum = 0;
+			double const LegacyStart = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < 16; ++Iteration)
+			{
+				for (TArray<uint8> const& Set : Corpus)
+				{
+					FLegacyBitstreamReader LegacyReader(Set.GetData(), Set.Num());
+					LegacyChecksum += ParseParameterSet(LegacyReader, [](FLegacyBitstreamReader& Legacy) { return Legacy.ReadUE(); });
+				}
+			}
+			double const LegacySeconds = FPlatformTime::Seconds() - LegacyStart;
+
+			uint64 Checksum = 0;
+			double const Start = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < 16; ++Iteration)
+			{
+				for (TArray<uint8> const& Set : Corpus)
+				{
+					FBitstreamReader Reader(Set.GetData(), Set.Num());
+					Checksum += ParseParameterSet(Reader, [](FBitstreamReader& Cached) { FBitstreamSegment::UE Value; Cached.Read(Value); return Value.Value; });
+				}
+			}
+			double const Seconds = FPlatformTime::Seconds() - Start;
+
+			AddInfo(FString::Printf(TEXT("Legacy reader %.2f ms, cached reader %.2f ms"), LegacySeconds * 1000.0, Seconds * 1000.0));
+			// Timings depend on the machine, so only the results are checked
+			TestEqual("should", Checksum, LegacyChecksum);
+		});
+	});
+}
@@ -0,0 +1,201 @@
+#include "Misc/AutomationTest.h"
+
+#include "Math/RandomStream.h"
+
+#include <Utils/BitstreamReader.h>
+#include <Utils/BitstreamWriter.h>
+
+DEFINE_SPEC(BitstreamWriterSpec, "AVCodecsCore.BitstreamWriter", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace BitstreamWriterSpecPrivate
+{
+	// Same escaping rules as an encoder, inserting 0x03 wherever two zeros are followed by a byte <= 0x03
+	TArray<uint8> RBSPtoEBSP(TArray<uint8> const& RBSP)
+	{
+		TArray<uint8> EBSP;
+		int32 Zeros = 0;
+		for (uint8 const Byte : RBSP)
+		{
+			if (Zeros == 2 && Byte <= 0x03)
+			{
+				EBSP.Add(0x03);
+				Zeros = 0;
+			}
+
+			EBSP.Add(Byte);
+			Zeros = Byte == 0 ? Zeros + 1 : 0;
+		}
+
+		return EBSP;
+	}
+
+	struct FField
+	{
+		uint32 Value;
+		uint32 NumBits;
+	};
+
+	// Fields of random width, biased towards zero so that plenty of emulation prevention is needed
+	TArray<FField> MakeFields(int32 Seed, int32 NumFields)
+	{
+		FRandomStream Random(Seed);
+
+		TArray<FField> Fields;
+		for (int32 i = 0; i < NumFields; ++i)
+		{
+			uint32 const NumBits = Random.RandRange(1, 32);
+			uint32 const Value = Random.RandRange(0, 3) == 0 ? (uint32)Random.RandRange(0, MAX_int32) : 0;
+
+			Fields.Add({ Value & (0xFFFFFFFFu >> (32 - NumBits)), NumBits });
+		}
+
+		return Fields;
+	}
+} // namespace BitstreamWriterSpecPrivate
+
+void BitstreamWriterSpec::Define()
+{
+	using namespace BitstreamWriterSpecPrivate;
+
+	Describe("RoundTrip", [this]() {
+		It("should read back fixed width fields", [this]() {
+			for (int32 Seed = 0; Seed < 16; ++Seed)
+			{
+				TArray<FField> const Fields = MakeFields(Seed, 256);
+
+				TArray<uint8> RBSP;
+				FBitstreamWriter Writer(RBSP);
+
+				uint64 NumBits = 0;
+				for (FField const& Field : Fields)
+				{
+					Writer.WriteBits(Field.Value, Field.NumBits);
+					NumBits += Field.NumBits;
+				}
+
+				TestEqual("should", Writer.NumBitsWritten(), NumBits);
+
+				Writer.WriteTrailingBits();
+				TestTrue("should", Writer.IsByteAligned());
+
+				FBitstreamReader Reader(RBSP.GetData(), RBSP.Num());
+				for (FField const& Field : Fields)
+				{
+					TestEqual("should", Reader.ReadBits(Field.NumBits), Field.Value);
+				}
+
+				TestEqual("should", Reader.ReadBits(1), 1u);
+			}
+		});
+
+		It("should read back exp-golomb codes", [this]() {
+			TArray<uint32> Unsigned;
+			for (uint32 n = 0; n < 32; ++n)
+			{
+				Unsigned.Append({ (1u << n) - 1, (1u << n) + n });
+			}
+
+			TArray<int32> const Signed = { 0, 1, -1, 2, -2, 1000, -1000, MAX_int32, -MAX_int32 };
+
+			TArray<uint8> RBSP;
+			FBitstreamWriter Writer(RBSP);
+
+			for (uint32 const Value : Unsigned)
+			{
+				Writer.Write(FBitstreamSegment::UE(Value));
+			}
+
+			for (int32 const Value : Signed)
+			{
+				Writer.Write(FBitstreamSegment::SE(Value));
+			}
+
+			Writer.WriteTrailingBits();
+
+			FBitstreamReader Reader(RBSP.GetData(), RBSP.Num());
+			for (uint32 const Expected : Unsigned)
+			{
+				FBitstreamSegment::UE Actual;
+				Reader.Read(Actual);
+
+				TestEqual("should", Actual.Value, Expected);
+			}
+
+			for (int32 const Expected : Signed)
+			{
+				FBitstreamSegment::SE Actual;
+				Reader.Read(Actual);
+
+				TestEqual("should", Actual.Value, Expected);
+			}
+		});
+
+		It("should write typed fields at their declared width", [this]() {
+			TArray<uint8> RBSP;
+			FBitstreamWriter Writer(RBSP);
+
+			Writer.Write(FBitstreamSegment::U<1>(1), FBitstreamSegment::U<3>(5), FBitstreamSegment::U<12>(0xABC), FBitstreamSegment::U<32>(0xDEADBEEF));
+
+			TestEqual("should", Writer.NumBitsWritten(), (uint64)48);
+
+			FBitstreamReader Reader(RBSP.GetData(), RBSP.Num());
+
+			FBitstreamSegment::U<1> A;
+			FBitstreamSegment::U<3> B;
+			FBitstreamSegment::U<12> C;
+			FBitstreamSegment::U<32> D;
+			Reader.Read(A, B, C, D);
+
+			TestEqual("should", (uint32)A, 1u);
+			TestEqual("should", (uint32)B, 5u);
+			TestEqual("should", (uint32)C, 0xABCu);
+			TestEqual("should", (uint32)D, 0xDEADBEEFu);
+		});
+	});
+
+	Describe("EBSP", [this]() {
+		It("should match escaping the RBSP afterwards", [this]() {
+			for (int32 Seed = 0; Seed < 32; ++Seed)
+			{
+				TArray<FField> const Fields = MakeFields(Seed, 64 + Seed * 7);
+
+				TArray<uint8> RBSP;
+				TArray<uint8> EBSP;
+				FBitstreamWriter RBSPWriter(RBSP);
+				FBitstreamWriter EBSPWriter = FBitstreamWriter::ToEBSP(EBSP);
+
+				for (FField const& Field : Fields)
+				{
+					RBSPWriter.WriteBits(Field.Value, Field.NumBits);
+					EBSPWriter.WriteBits(Field.Value, Field.NumBits);
+				}
+
+				RBSPWriter.WriteTrailingBits();
+				EBSPWriter.WriteTrailingBits();
+
+				TestEqual("should", EBSP, RBSPtoEBSP(RBSP));
+				TestEqual("should", EBSPWriter.NumBitsWritten(), RBSPWriter.NumBitsWritten());
+			}
+		});
+
+		It("should read back through an EBSP reader", [this]() {
+			TArray<FField> const Fields = MakeFields(0x264, 1024);
+
+			TArray<uint8> EBSP;
+			FBitstreamWriter Writer = FBitstreamWriter::ToEBSP(EBSP);
+
+			for (FField const& Field : Fields)
+			{
+				Writer.WriteBits(Field.Value, Field.NumBits);
+			}
+
+			Writer.WriteTrailingBits();
+
+			FBitstreamReader Reader = FBitstreamReader::FromEBSP(EBSP.GetData(), EBSP.Num());
+			for (FField const& Field : Fields)
+			{
+				TestEqual("should", Reader.ReadBits(Field.NumBits), Field.Value);
+			}
+		});
+	});
+}
@@ -0,0 +1,179 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/PlatformTime.h"
+
+#include <AVDevice.h>
+#include <Video/VideoEncoder.h>
+#include <Video/Resources/VideoResourceCPU.h>
+
+namespace CoderFactorySpecPrivate
+{
+	// A config only the mock encoders below are registered for, so nothing else in the registry gets in their way
+	struct FMockConfig : public FVideoEncoderConfig
+	{
+	};
+} // namespace CoderFactorySpecPrivate
+
+REGISTER_TYPEID(CoderFactorySpecPrivate::FMockConfig);
+
+DEFINE_SPEC(CoderFactorySpec, "AVCodecsCore.CoderFactory", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace CoderFactorySpecPrivate
+{
+	constexpr int32 NumFactories = 48;
+	constexpr int32 NumCreates = 1000;
+
+	class FMockEncoder : public TVideoEncoder<FVideoResourceCPU, FMockConfig>
+	{
+	public:
+		virtual bool IsOpen() const override { return bOpen; }
+
+		virtual FAVResult Open(TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance) override
+		{
+			TVideoEncoder<FVideoResourceCPU, FMockConfig>::Open(NewDevice, NewInstance);
+			bOpen = true;
+
+			return EAVResult::Success;
+		}
+
+		virtual void Close() override { bOpen = false; }
+
+		virtual FAVResult SendFrame(TSharedPtr<FVideoResourceCPU> const& Resource, uint64 Timestamp, bool bForceKeyframe = false, uint64 UserData = 0) override { return EAVResult::Success; }
+		virtual FAVResult ReceivePacket(FVideoPacket& OutPacket) override { return EAVResult::PendingInput; }
+
+	private:
+		bool bOpen = false;
+	};
+
+	// Stand in for a check that has to ask a driver whether it supports something
+	constexpr double CheckSeconds = 0.00002;
+
+	// Times each factory has checked a device, only the last factory accepts a device with a CPU context
+	int32 NumChecks[NumFactories] = {};
+
+	void RegisterMockFactories()
+	{
+		static bool bRegistered = false;
+		if (bRegistered)
+		{
+			return;
+		}
+
+		bRegistered = true;
+
+		for (int32 i = 0; i < NumFactories; ++i)
+		{
+			FVideoEncoder::Register<FMockEncoder, FVideoResourceCPU, FMockConfig>([i](TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance) {
+				NumChecks[i]++;
+
+				double const Until = FPlatformTime::Seconds() + CheckSeconds;
+				while (FPlatformTime::Seconds() < Until)
+				{
+				}
+
+				return i == NumFactories - 1 && NewDevice->HasContext<FVideoContextCPU>();
+			});
+		}
+	}
+
+	int32 TotalChecks()
+	{
+		int32 Result = 0;
+		for (int32 i = 0; i < NumFactories; ++i)
+		{
+			Result += NumChecks[i];
+		}
+
+		return Result;
+	}
+
+	TSharedRef<FAVDevice> MakeDevice()
+	{
+		TSharedRef<FAVDevice> Device = MakeShared<FAVDevice>();
+		Device->SetContext<FVideoContextCPU>(MakeShared<FVideoContextCPU>());
+
+		return Device;
+	}
+} // namespace CoderFactorySpecPrivate
+
+void CoderFactorySpec::Define()
+{
+	using namespace CoderFactorySpecPrivate;
+
+	BeforeEach([this]() {
+		RegisterMockFactories();
+	});
+
+	Describe("Create", [this]() {
+		It("should create a coder from the compatible factory", [this]() {
+			TSharedRef<FAVDevice> const Device = MakeDevice();
+
+			TSharedPtr<TVideoEncoder<FVideoResourceCPU, FMockConfig>> const Encoder = FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(Device, FMockConfig());
+			TestTrue("should", Encoder.IsValid() && Encoder->IsOpen());
+		});
+
+		It("should not create a coder when no factory is compatible", [this]() {
+			TSharedRef<FAVDevice> const Device = MakeShared<FAVDevice>();
+
+			TestFalse("should", FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(Device, FMockConfig()).IsValid());
+		});
+	});
+
+	Describe("Compatibility", [this]() {
+		It("should check each factory once per device", [this]() {
+			TSharedRef<FAVDevice> const Device = MakeDevice();
+
+			int32 const ChecksBefore = TotalChecks();
+			for (int32 i = 0; i < NumCreates; ++i)
+			{
+				FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(Device, FMockConfig());
+			}
+
+			TestEqual("should", TotalChecks() - ChecksBefore, NumFactories);
+		});
+
+		It("should check again once the contexts on the device change", [this]() {
+			TSharedRef<FAVDevice> const Device = MakeShared<FAVDevice>();
+			TestFalse("should", FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(Device, FMockConfig()).IsValid());
+
+			Device->SetContext<FVideoContextCPU>(MakeShared<FVideoContextCPU>());
+			TestTrue("should", FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(Device, FMockConfig()).IsValid());
+		});
+
+		It("should keep devices apart", [this]() {
+			TSharedRef<FAVDevice> const With = MakeDevice();
+			TSharedRef<FAVDevice> const Without = MakeShared<FAVDevice>();
+
+			TestTrue("should", FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(With, FMockConfig()).IsValid());
+			TestFalse("should", FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(Without, FMockConfig()).IsValid());
+			TestTrue("should", FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(With, FMockConfig()).IsValid());
+		});
+	});
+
+	Describe("Cost", [this]() {
+		It("should report how much cheaper repeated creation is than the first", [this]() {
+			TSharedRef<FAVDevice> const Device = MakeDevice();
+
+			int32 const ChecksBefore = TotalChecks();
+
+			double const FirstStart = FPlatformTime::Seconds();
+			FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(Device, FMockConfig());
+			double const FirstSeconds = FPlatformTime::Seconds() - FirstStart;
+
+			int32 const ChecksAfterFirst = TotalChecks();
+
+			double const RepeatStart = FPlatformTime::Seconds();
+			for (int32 i = 0; i < NumCreates; ++i)
+			{
+				FVideoEncoder::Create<FVideoResourceCPU, FMockConfig>(Device, FMockConfig());
+			}
+			double const RepeatSeconds = (FPlatformTime::Seconds() - RepeatStart) / NumCreates;
+
+			AddInfo(FString::Printf(TEXT("Creating with %d factories took %.2fus the first time and %.2fus on average after"), NumFactories, FirstSeconds * 1000000.0, RepeatSeconds * 1000000.0));
+
+			// The first creation pays for every check and later ones only for a lookup each. Timings depend on the machine, so the checks are counted instead.
+			TestEqual("should", ChecksAfterFirst - ChecksBefore, NumFactories);
+			TestEqual("should", TotalChecks() - ChecksAfterFirst, 0);
+		});
+	});
+}
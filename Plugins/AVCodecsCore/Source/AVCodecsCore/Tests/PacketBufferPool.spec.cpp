@@ -0,0 +1,195 @@
+#include "Misc/AutomationTest.h"
+
+#include "Async/Async.h"
+#include "Containers/Queue.h"
+#include "HAL/ThreadSafeCounter.h"
+
+#include <Utils/PacketBufferPool.h>
+
+DEFINE_SPEC(PacketBufferPoolSpec, "AVCodecsCore.PacketBufferPool", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace PacketBufferPoolSpecPrivate
+{
+	using namespace UE::AVCodecCore;
+
+	constexpr int32 NumProducers = 4;
+	constexpr int32 NumPacketsPerProducer = 500;
+
+	struct FPacket
+	{
+		TSharedPtr<uint8> Data;
+		uint64 Size;
+		uint8 Fill;
+	};
+
+	// Every byte of a packet is set to its fill value, so a buffer handed to two owners at once shows up as a mismatch
+	FPacket MakePacket(FPacketBufferPool& Pool, int32 Producer, int32 Index)
+	{
+		FPacket Packet;
+		Packet.Size = 1 + ((Producer * 7919 + Index * 104729) % 20000);
+		Packet.Fill = (uint8)(Producer * 31 + Index);
+		Packet.Data = Pool.Allocate(Packet.Size);
+		FMemory::Memset(Packet.Data.Get(), Packet.Fill, Packet.Size);
+
+		return Packet;
+	}
+
+	bool IsIntact(FPacket const& Packet)
+	{
+		for (uint64 i = 0; i < Packet.Size; ++i)
+		{
+			if (Packet.Data.Get()[i] != Packet.Fill)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+} // namespace PacketBufferPoolSpecPrivate
+
+void PacketBufferPoolSpec::Define()
+{
+	using namespace UE::AVCodecCore;
+	using namespace PacketBufferPoolSpecPrivate;
+
+	Describe("Allocate", [this]() {
+		It("should round sizes up to their bucket", [this]() {
+			TestEqual("should", FPacketBufferPool::GetBucketSize(1), FPacketBufferPool::MinBucketSize);
+			TestEqual("should", FPacketBufferPool::GetBucketSize(4096), 4096ull);
+			TestEqual("should", FPacketBufferPool::GetBucketSize(4097), 8192ull);
+			TestEqual("should", FPacketBufferPool::GetBucketSize(300000), 512ull * 1024);
+			TestEqual("should", FPacketBufferPool::GetBucketSize(FPacketBufferPool::MaxBucketSize + 1), FPacketBufferPool::MaxBucketSize + 1);
+		});
+
+		It("should reuse a released buffer from the same bucket", [this]() {
+			FPacketBufferPool Pool;
+
+			uint8* Released = nullptr;
+			{
+				TSharedPtr<uint8> Buffer = Pool.Allocate(5000);
+				Released = Buffer.Get();
+			}
+
+			TestEqual("should", Pool.NumFree(), 1);
+
+			TSharedPtr<uint8> Buffer = Pool.Allocate(6000);
+			TestEqual("should", Buffer.Get(), Released);
+			TestEqual("should", Pool.NumFree(), 0);
+		});
+
+		It("should not reuse a buffer from another bucket", [this]() {
+			FPacketBufferPool Pool;
+
+			uint8* Released = nullptr;
+			{
+				TSharedPtr<uint8> Buffer = Pool.Allocate(5000);
+				Released = Buffer.Get();
+			}
+
+			TSharedPtr<uint8> Buffer = Pool.Allocate(20000);
+			TestNotEqual("should", Buffer.Get(), Released);
+			TestEqual("should", Pool.NumFree(), 1);
+		});
+
+		It("should return nothing for an empty request", [this]() {
+			FPacketBufferPool Pool;
+			TestFalse("should", Pool.Allocate(0).IsValid());
+		});
+	});
+
+	Describe("Release", [this]() {
+		It("should keep no more free buffers than allowed", [this]() {
+			FPacketBufferPool Pool(2);
+
+			TArray<TSharedPtr<uint8>> Buffers;
+			for (int32 i = 0; i < 4; ++i)
+			{
+				Buffers.Add(Pool.Allocate(5000));
+			}
+
+			Buffers.Empty();
+
+			TestEqual("should", Pool.NumFree(), 2);
+		});
+
+		It("should free buffers too large to pool", [this]() {
+			FPacketBufferPool Pool;
+			Pool.Allocate(FPacketBufferPool::MaxBucketSize + 1);
+
+			TestEqual("should", Pool.NumFree(), 0);
+		});
+
+		It("should free buffers released after the pool is gone", [this]() {
+			TSharedPtr<uint8> Buffer;
+			TWeakPtr<void> Buckets;
+			{
+				FPacketBufferPool Pool;
+				Buffer = Pool.Allocate(5000);
+				Buckets = Pool.GetBucketsForTesting();
+			}
+
+			// The buffer is still out, so it keeps the free buffers alive to return itself to
+			TestTrue("should", Buckets.IsValid());
+
+			// Releasing it is the last reference, so it and the free buffers it went back to are freed
+			Buffer.Reset();
+			TestFalse("should", Buckets.IsValid());
+		});
+
+		It("should free every pooled buffer when trimmed", [this]() {
+			FPacketBufferPool Pool;
+			Pool.Allocate(5000);
+			Pool.Allocate(20000);
+			Pool.Trim();
+
+			TestEqual("should", Pool.NumFree(), 0);
+		});
+	});
+
+	Describe("Threading", [this]() {
+		It("should hand each buffer to one owner at a time under concurrent send and receive", [this]() {
+			FPacketBufferPool Pool(4);
+
+			TQueue<FPacket, EQueueMode::Mpsc> Sent;
+			FThreadSafeCounter NumProducing = NumProducers;
+
+			TArray<TFuture<void>> Producers;
+			for (int32 Producer = 0; Producer < NumProducers; ++Producer)
+			{
+				Producers.Add(Async(EAsyncExecution::Thread, [&Pool, &Sent, &NumProducing, Producer]() {
+					for (int32 i = 0; i < NumPacketsPerProducer; ++i)
+					{
+						Sent.Enqueue(MakePacket(Pool, Producer, i));
+					}
+
+					NumProducing.Decrement();
+				}));
+			}
+
+			TFuture<int32> Receiver = Async(EAsyncExecution::Thread, [&Sent, &NumProducing]() {
+				int32 NumIntact = 0;
+
+				FPacket Packet;
+				while (NumProducing.GetValue() > 0 || !Sent.IsEmpty())
+				{
+					while (Sent.Dequeue(Packet))
+					{
+						NumIntact += IsIntact(Packet) ? 1 : 0;
+						Packet.Data.Reset();
+					}
+				}
+
+				return NumIntact;
+			});
+
+			for (TFuture<void>& Producer : Producers)
+			{
+				Producer.Wait();
+			}
+
+			TestEqual("should", Receiver.Get(), NumProducers * NumPacketsPerProducer);
+			TestTrue("should", Pool.NumFree() > 0);
+		});
+	});
+}
@@ -0,0 +1,260 @@
+#include "Misc/AutomationTest.h"
+
+#include "Async/Async.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+
+#include <AVDevice.h>
+#include <AVInstance.h>
+#include <Utils/PacketBufferPool.h>
+#include <Utils/PacketRing.h>
+#include <Video/VideoEncoder.h>
+#include <Video/Encoders/Configs/VideoEncoderConfigH264.h>
+#include <Video/Resources/VideoResourceCPU.h>
+
+DEFINE_SPEC(PacketRingSpec, "AVCodecsCore.PacketRing", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace PacketRingSpecPrivate
+{
+	using namespace UE::AVCodecCore;
+
+	constexpr int32 NumFrames = 64;
+
+	// Stand in for the time a hardware encoder spends on a frame
+	constexpr float EncodeSeconds = 0.001f;
+
+	FVideoPacket MakePacket(uint64 Index, uint64 Size = 16)
+	{
+		return FVideoPacket(FPacketBufferPool::Get().Allocate(Size), Size, Index, Index, 0, Index == 0);
+	}
+
+	/**
+	 * Encoder that hands out a packet per frame through a ring, the same way the vendor encoders do, so it can be tested without any hardware.
+	 */
+	class FMockEncoder : public TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigH264>
+	{
+	public:
+		virtual bool IsOpen() const override { return bOpen; }
+
+		virtual FAVResult Open(TSharedRef<FAVDevice> const& NewDevice, TSharedRef<FAVInstance> const& NewInstance) override
+		{
+			TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigH264>::Open(NewDevice, NewInstance);
+			bOpen = true;
+
+			return EAVResult::Success;
+		}
+
+		virtual void Close() override { bOpen = false; }
+
+		virtual FAVResult SendFrame(TSharedPtr<FVideoResourceCPU> const& Resource, uint64 Timestamp, bool bForceKeyframe = false, uint64 UserData = 0) override
+		{
+			Packets.Push(MakePacket(Timestamp));
+
+			return EAVResult::Success;
+		}
+
+		virtual FAVResult ReceivePacket(FVideoPacket& OutPacket) override
+		{
+			return Packets.Pop(OutPacket) ? EAVResult::Success : EAVResult::PendingInput;
+		}
+
+		virtual FAVResult WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime) override
+		{
+			return Packets.WaitPop(OutPacket, WaitTime) ? EAVResult::Success : EAVResult::PendingInput;
+		}
+
+	private:
+		bool bOpen = false;
+
+		TPacketRing<FVideoPacket> Packets;
+	};
+} // namespace PacketRingSpecPrivate
+
+void PacketRingSpec::Define()
+{
+	using namespace PacketRingSpecPrivate;
+
+	Describe("Push", [this]() {
+		It("should pop packets in the order they were pushed", [this]() {
+			TPacketRing<FVideoPacket> Ring(4);
+
+			// Go round the ring a few times so the indices wrap
+			for (uint64 i = 0; i < 16; ++i)
+			{
+				Ring.Push(MakePacket(i));
+
+				FVideoPacket Packet;
+				TestTrue("should", Ring.Pop(Packet));
+				TestEqual("should", Packet.Index, i);
+			}
+
+			TestTrue("should", Ring.IsEmpty());
+		});
+
+		It("should round its capacity up to a power of two", [this]() {
+			TestEqual("should", TPacketRing<FVideoPacket>(5).GetCapacity(), 8u);
+			TestEqual("should", TPacketRing<FVideoPacket>(8).GetCapacity(), 8u);
+		});
+
+		It("should keep packets pushed once full", [this]() {
+			TPacketRing<FVideoPacket> Ring(4);
+			for (uint64 i = 0; i < 10; ++i)
+			{
+				Ring.Push(MakePacket(i));
+			}
+
+			TestEqual("should", Ring.Num(), 10u);
+
+			for (uint64 i = 0; i < 10; ++i)
+			{
+				FVideoPacket Packet;
+				if (TestTrue("should", Ring.Pop(Packet)))
+				{
+					TestEqual("should", Packet.Index, i);
+					TestTrue("should", Packet.DataPtr.IsValid());
+				}
+			}
+
+			TestTrue("should", Ring.IsEmpty());
+		});
+
+		It("should keep packets in order while the overflow drains", [this]() {
+			TPacketRing<FVideoPacket> Ring(4);
+			for (uint64 i = 0; i < 6; ++i)
+			{
+				Ring.Push(MakePacket(i));
+			}
+
+			// The ring has room again, but packets 4 and 5 are still waiting in the overflow, so 6 has to go after them
+			FVideoPacket Packet;
+			TestTrue("should", Ring.Pop(Packet));
+			Ring.Push(MakePacket(6));
+
+			TArray<uint64> Received = { Packet.Index };
+			while (Ring.Pop(Packet))
+			{
+				Received.Add(Packet.Index);
+			}
+
+			// Once the overflow has drained the ring is used again
+			Ring.Push(MakePacket(7));
+			if (TestTrue("should", Ring.Pop(Packet)))
+			{
+				Received.Add(Packet.Index);
+			}
+
+			TestEqual("should", Received, TArray<uint64>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+		});
+	});
+
+	Describe("Pop", [this]() {
+		It("should find nothing in an empty ring", [this]() {
+			TPacketRing<FVideoPacket> Ring;
+
+			FVideoPacket Packet;
+			TestFalse("should", Ring.Pop(Packet));
+		});
+
+		It("should move packet data through without copying it", [this]() {
+			TPacketRing<FVideoPacket> Ring;
+
+			FVideoPacket Packet = MakePacket(0);
+			TSharedPtr<uint8> const Data = Packet.DataPtr;
+
+			Ring.Push(MoveTemp(Packet));
+			TestFalse("should", Packet.DataPtr.IsValid());
+			TestEqual("should", Data.GetSharedReferenceCount(), 2);
+
+			FVideoPacket Popped;
+			Ring.Pop(Popped);
+			TestTrue("should", Popped.DataPtr == Data);
+			TestEqual("should", Data.GetSharedReferenceCount(), 2);
+
+			// Move only types only compile if nothing copies them
+			TPacketRing<TUniquePtr<int32>> MoveOnly;
+			MoveOnly.Push(MakeUnique<int32>(42));
+
+			TUniquePtr<int32> Value;
+			TestTrue("should", MoveOnly.Pop(Value) && *Value == 42);
+		});
+
+		It("should release every packet on empty", [this]() {
+			TPacketRing<FVideoPacket> Ring;
+
+			FVideoPacket Packet = MakePacket(0);
+			TSharedPtr<uint8> const Data = Packet.DataPtr;
+			Ring.Push(MoveTemp(Packet));
+			Ring.Push(MakePacket(1));
+
+			Ring.Empty();
+
+			TestTrue("should", Ring.IsEmpty());
+			TestEqual("should", Data.GetSharedReferenceCount(), 1);
+		});
+	});
+
+	Describe("WaitPop", [this]() {
+		It("should give up once the wait time is over", [this]() {
+			TPacketRing<FVideoPacket> Ring;
+
+			double const StartTime = FPlatformTime::Seconds();
+
+			FVideoPacket Packet;
+			TestFalse("should", Ring.WaitPop(Packet, FTimespan::FromMilliseconds(50)));
+			TestTrue("should", FPlatformTime::Seconds() - StartTime >= 0.045);
+		});
+
+		It("should wake up as soon as a packet is pushed from another thread", [this]() {
+			TPacketRing<FVideoPacket> Ring;
+
+			TFuture<void> Producer = Async(EAsyncExecution::Thread, [&Ring]() {
+				FPlatformProcess::Sleep(0.02f);
+				Ring.Push(MakePacket(7));
+			});
+
+			double const StartTime = FPlatformTime::Seconds();
+
+			FVideoPacket Packet;
+			TestTrue("should", Ring.WaitPop(Packet, FTimespan::FromSeconds(5)));
+			TestEqual("should", Packet.Index, 7ull);
+
+			// Nowhere near the full wait, the margin keeps a busy test machine from failing it
+			TestTrue("should", FPlatformTime::Seconds() - StartTime < 1.0);
+
+			Producer.Wait();
+		});
+	});
+
+	Describe("Encoder", [this]() {
+		It("should deliver every packet to a consumer waiting on another thread", [this]() {
+			TSharedPtr<FMockEncoder> const Encoder = MakeShared<FMockEncoder>();
+			Encoder->Open(FAVDevice::GetSoftwareDevice(), MakeShared<FAVInstance>());
+
+			TFuture<void> Producer = Async(EAsyncExecution::Thread, [Encoder]() {
+				for (int32 i = 0; i < NumFrames; ++i)
+				{
+					FPlatformProcess::Sleep(EncodeSeconds);
+					Encoder->SendFrame(nullptr, i);
+				}
+			});
+
+			TArray<uint64> Received;
+			FVideoPacket Packet;
+			while (Received.Num() < NumFrames && Encoder->WaitForPacket(Packet, FTimespan::FromSeconds(5)).IsSuccess())
+			{
+				Received.Add(Packet.Index);
+			}
+
+			Producer.Wait();
+
+			TArray<uint64> Expected;
+			for (int32 i = 0; i < NumFrames; ++i)
+			{
+				Expected.Add(i);
+			}
+
+			TestEqual("should", Received, Expected);
+			TestTrue("should", Encoder->ReceivePacket(Packet) == EAVResult::PendingInput);
+		});
+	});
+}
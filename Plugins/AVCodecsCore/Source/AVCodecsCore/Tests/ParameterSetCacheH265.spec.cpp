@@ -0,0 +1,246 @@
+#include "Misc/AutomationTest.h"
+
+#include <AVInstance.h>
+#include <Video/Decoders/Configs/VideoDecoderConfigH265.h>
+#include <Video/VideoPacket.h>
+
+DEFINE_SPEC(ParameterSetCacheH265Spec, "AVCodecsCore.H265.ParameterSetCache", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace ParameterSetCacheH265SpecPrivate
+{
+	// Packs syntax elements MSB first so parameter sets can be written out field by field
+	class FBitPacker
+	{
+	public:
+		FBitPacker& Bits(TCHAR const* InBits)
+		{
+			for (TCHAR const* Bit = InBits; *Bit; ++Bit)
+			{
+				if (*Bit == TEXT('0') || *Bit == TEXT('1'))
+				{
+					Bit1(*Bit == TEXT('1'));
+				}
+			}
+
+			return *this;
+		}
+
+		FBitPacker& UE(uint32 Value)
+		{
+			int32 const NumBits = 32 - FMath::CountLeadingZeros(Value + 1);
+			for (int32 i = 1; i < NumBits; ++i)
+			{
+				Bit1(false);
+			}
+
+			for (int32 i = NumBits - 1; i >= 0; --i)
+			{
+				Bit1(((Value + 1) >> i) & 1);
+			}
+
+			return *this;
+		}
+
+		// Adds the stop bit and escapes the payload, returning a complete Annex-B NALU
+		TArray<uint8> Finish(uint8 Type)
+		{
+			Bit1(true);
+			while (NumBits % 8 != 0)
+			{
+				Bit1(false);
+			}
+
+			TArray<uint8> Nalu = { 0x00, 0x00, 0x00, 0x01, (uint8)(Type << 1), 0x01 };
+
+			int32 Zeros = 0;
+			for (uint8 const Byte : RBSP)
+			{
+				if (Zeros == 2 && Byte <= 0x03)
+				{
+					Nalu.Add(0x03);
+					Zeros = 0;
+				}
+
+				Nalu.Add(Byte);
+				Zeros = Byte == 0 ? Zeros + 1 : 0;
+			}
+
+			return Nalu;
+		}
+
+	private:
+		void Bit1(bool bValue)
+		{
+			if (NumBits % 8 == 0)
+			{
+				RBSP.Add(0);
+			}
+
+			RBSP.Last() |= (uint8)bValue << (7 - NumBits % 8);
+			++NumBits;
+		}
+
+		TArray<uint8> RBSP;
+		int32 NumBits = 0;
+	};
+
+	// Main profile, level 3.1, single sub layer
+	TCHAR const* ProfileTierLevel = TEXT("00 0 00001 00000000000000000000000000000000 1001 0000000000000000000000000000000000000000000 0 01011101");
+
+	TArray<uint8> MakeVPS()
+	{
+		return FBitPacker()
+			.Bits(TEXT("0000 1 1 000000 000 1 1111111111111111"))
+			.Bits(ProfileTierLevel)
+			.Bits(TEXT("1")).UE(0).UE(0).UE(0)
+			.Bits(TEXT("000000")).UE(0)
+			.Bits(TEXT("0 0"))
+			.Finish(32);
+	}
+
+	TArray<uint8> MakeSPS(uint32 SPSId, uint32 Width, uint32 Height)
+	{
+		return FBitPacker()
+			.Bits(TEXT("0000 000 1"))
+			.Bits(ProfileTierLevel)
+			.UE(SPSId).UE(1).UE(Width).UE(Height)
+			.Bits(TEXT("0")).UE(0).UE(0).UE(4)
+			.Bits(TEXT("1")).UE(0).UE(0).UE(0)
+			.UE(0).UE(1).UE(0).UE(1).UE(0).UE(0)
+			.Bits(TEXT("0 000")).UE(0)
+			.Bits(TEXT("0 000 0"))
+			.Finish(33);
+	}
+
+	TArray<uint8> MakePPS(uint32 SPSId)
+	{
+		return FBitPacker()
+			.UE(0).UE(SPSId)
+			.Bits(TEXT("0 0 000 0 0")).UE(0).UE(0)
+			.Bits(TEXT("1 0 0 0")).Bits(TEXT("1 1"))
+			.Bits(TEXT("000000 0 0 0 0")).UE(0)
+			.Bits(TEXT("0 0"))
+			.Finish(34);
+	}
+} // namespace ParameterSetCacheH265SpecPrivate
+
+void ParameterSetCacheH265Spec::Define()
+{
+	using namespace UE::AVCodecCore::H265;
+	using namespace ParameterSetCacheH265SpecPrivate;
+
+	auto const MakePacket = [](TArray<uint8>& Stream) -> FVideoPacket
+	{
+		// The stream outlives the packet, so don't let the packet free it
+		return FVideoPacket(MakeShareable(Stream.GetData(), [](uint8*) {}), Stream.Num(), 0, 0, 0, true);
+	};
+
+	auto const MakeStream = [](uint32 SPSId, uint32 Width, uint32 Height) -> TArray<uint8>
+	{
+		TArray<uint8> Stream = MakeVPS();
+		Stream.Append(MakeSPS(SPSId, Width, Height));
+		Stream.Append(MakePPS(SPSId));
+
+		return Stream;
+	};
+
+	Describe("Cache", [this, MakePacket, MakeStream]() {
+		It("should reuse parameter sets that have not changed", [this, MakePacket, MakeStream]() {
+			TSharedRef<FAVInstance> Instance = MakeShared<FAVInstance>();
+			FVideoDecoderConfigH265& Config = Instance->Edit<FVideoDecoderConfigH265>();
+
+			TArray<uint8> FirstStream = MakeStream(0, 1280, 720);
+			TArray<TSharedPtr<FNaluH265>> FirstNalus;
+			TestTrue("should", Config.Parse(Instance, MakePacket(FirstStream), FirstNalus).IsSuccess());
+
+			// Parse an identical copy so that the cached parameter sets have to be repointed at the new packet
+			TArray<uint8> SecondStream = FirstStream;
+			TArray<TSharedPtr<FNaluH265>> SecondNalus;
+			TestTrue("should", Config.Parse(Instance, MakePacket(SecondStream), SecondNalus).IsSuccess());
+
+			if (TestEqual("should", SecondNalus.Num(), 3) && TestEqual("should", FirstNalus.Num(), 3))
+			{
+				for (int32 i = 0; i < 3; ++i)
+				{
+					TestTrue("should", FirstNalus[i] == SecondNalus[i]);
+					TestTrue("should", SecondNalus[i]->EBSP >= SecondStream.GetData() && SecondNalus[i]->EBSP < SecondStream.GetData() + SecondStream.Num());
+				}
+			}
+
+			TSharedPtr<FNaluSPS> const* SPS = Config.ParsedSPS.Find(0);
+			if (TestNotNull("should", SPS))
+			{
+				TestEqual("should", (*SPS)->pic_width_in_luma_samples.Value, 1280u);
+				TestEqual("should", (*SPS)->pic_height_in_luma_samples.Value, 720u);
+			}
+		});
+
+		It("should parse parameter sets that have changed", [this, MakePacket, MakeStream]() {
+			TSharedRef<FAVInstance> Instance = MakeShared<FAVInstance>();
+			FVideoDecoderConfigH265& Config = Instance->Edit<FVideoDecoderConfigH265>();
+
+			TArray<uint8> FirstStream = MakeStream(0, 1280, 720);
+			TArray<TSharedPtr<FNaluH265>> FirstNalus;
+			Config.Parse(Instance, MakePacket(FirstStream), FirstNalus);
+
+			TArray<uint8> SecondStream = MakeStream(0, 1920, 1080);
+			TArray<TSharedPtr<FNaluH265>> SecondNalus;
+			Config.Parse(Instance, MakePacket(SecondStream), SecondNalus);
+
+			if (TestEqual("should", SecondNalus.Num(), 3) && TestEqual("should", FirstNalus.Num(), 3))
+			{
+				TestTrue("should", FirstNalus[0] == SecondNalus[0]);
+				TestTrue("should", FirstNalus[1] != SecondNalus[1]);
+				TestTrue("should", FirstNalus[2] == SecondNalus[2]);
+			}
+
+			TSharedPtr<FNaluSPS> const* SPS = Config.ParsedSPS.Find(0);
+			if (TestNotNull("should", SPS))
+			{
+				TestEqual("should", (*SPS)->pic_width_in_luma_samples.Value, 1920u);
+				TestEqual("should", (*SPS)->pic_height_in_luma_samples.Value, 1080u);
+			}
+		});
+
+		It("should key sequence parameter sets by their own id", [this, MakePacket, MakeStream]() {
+			TSharedRef<FAVInstance> Instance = MakeShared<FAVInstance>();
+			FVideoDecoderConfigH265& Config = Instance->Edit<FVideoDecoderConfigH265>();
+
+			TArray<uint8> Stream = MakeStream(2, 1280, 720);
+			TArray<TSharedPtr<FNaluH265>> Nalus;
+			Config.Parse(Instance, MakePacket(Stream), Nalus);
+
+			TestTrue("should", Config.ParsedSPS.Contains(2));
+			TestFalse("should", Config.ParsedSPS.Contains(0));
+		});
+	});
+
+	Describe("Reparsing", [this, MakePacket, MakeStream]() {
+		It("should keep the parsed parameter sets of an unchanged stream", [this, MakePacket, MakeStream]() {
+			TSharedRef<FAVInstance> Instance = MakeShared<FAVInstance>();
+			FVideoDecoderConfigH265& Config = Instance->Edit<FVideoDecoderConfigH265>();
+
+			TArray<uint8> Stream = MakeStream(0, 1280, 720);
+			FVideoPacket const Packet = MakePacket(Stream);
+
+			TArray<TSharedPtr<FNaluH265>> Nalus;
+			Config.Parse(Instance, Packet, Nalus);
+
+			TSharedPtr<FNaluVPS> const VPS = Config.ParsedVPS.FindRef(0);
+			TSharedPtr<FNaluSPS> const SPS = Config.ParsedSPS.FindRef(0);
+			TSharedPtr<FNaluPPS> const PPS = Config.ParsedPPS.FindRef(0);
+			TestTrue("should", VPS.IsValid() && SPS.IsValid() && PPS.IsValid());
+
+			// A parameter set that is parsed again gets a new object, so the same objects mean nothing was reparsed
+			for (int32 i = 0; i < 16; ++i)
+			{
+				Nalus.Reset();
+				Config.Parse(Instance, Packet, Nalus);
+
+				TestTrue("should", Config.ParsedVPS.FindRef(0) == VPS);
+				TestTrue("should", Config.ParsedSPS.FindRef(0) == SPS);
+				TestTrue("should", Config.ParsedPPS.FindRef(0) == PPS);
+			}
+		});
+	});
+}
@@ -0,0 +1,159 @@
+#include "Misc/AutomationTest.h"
+
+#include <Utils/BitstreamWriter.h>
+#include <Video/CodecUtils/CodecUtilsH264.h>
+#include <Video/VideoPacket.h>
+
+DEFINE_SPEC(ParserStateH264Spec, "AVCodecsCore.H264.ParserState", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace ParserStateH264SpecPrivate
+{
+	using namespace UE::AVCodecCore::H264;
+
+	// Constrained baseline 320x240 SPS with picture order count type 2, so slices carry no POC fields
+	void WriteSPS(TArray<uint8>& Stream)
+	{
+		Stream.Append({ 0x00, 0x00, 0x00, 0x01, 0x67 });
+
+		FBitstreamWriter Writer = FBitstreamWriter::ToEBSP(Stream);
+		Writer.Write(FNalu::U<8>(66), FNalu::U<8>(0x40), FNalu::U<8>(30), FNalu::UE(0));
+		Writer.Write(FNalu::UE(0), FNalu::UE(2), FNalu::UE(1), FNalu::U<1>(0));
+		Writer.Write(FNalu::UE(19), FNalu::UE(14), FNalu::U<1>(1), FNalu::U<1>(1), FNalu::U<1>(0), FNalu::U<1>(0));
+		Writer.WriteTrailingBits();
+	}
+
+	void WritePPS(TArray<uint8>& Stream)
+	{
+		Stream.Append({ 0x00, 0x00, 0x00, 0x01, 0x68 });
+
+		FBitstreamWriter Writer = FBitstreamWriter::ToEBSP(Stream);
+		Writer.Write(FNalu::UE(0), FNalu::UE(0), FNalu::U<1>(0), FNalu::U<1>(0), FNalu::UE(0));
+		Writer.Write(FNalu::UE(0), FNalu::UE(0), FNalu::U<1>(0), FNalu::U<2>(0));
+		Writer.Write(FNalu::SE(0), FNalu::SE(0), FNalu::SE(0), FNalu::U<1>(1), FNalu::U<1>(0), FNalu::U<1>(0));
+		Writer.Write(FNalu::U<1>(0), FNalu::U<1>(0), FNalu::SE(0));
+		Writer.WriteTrailingBits();
+	}
+
+	void WriteIdrSlice(TArray<uint8>& Stream)
+	{
+		Stream.Append({ 0x00, 0x00, 0x00, 0x01, 0x65 });
+
+		FBitstreamWriter Writer = FBitstreamWriter::ToEBSP(Stream);
+		Writer.Write(FNalu::UE(0), FNalu::UE(7), FNalu::UE(0), FNalu::U<4>(0), FNalu::UE(0));
+		Writer.Write(FNalu::SE(4), FNalu::UE(0), FNalu::SE(0), FNalu::SE(0));
+		Writer.WriteTrailingBits();
+	}
+
+	void WriteNonIdrSlice(TArray<uint8>& Stream, uint32 FrameNum)
+	{
+		Stream.Append({ 0x00, 0x00, 0x00, 0x01, 0x41 });
+
+		FBitstreamWriter Writer = FBitstreamWriter::ToEBSP(Stream);
+		Writer.Write(FNalu::UE(0), FNalu::UE(5), FNalu::UE(0), FNalu::U<4>(FrameNum));
+		Writer.Write(FNalu::U<1>(0), FNalu::U<1>(0), FNalu::SE(-2), FNalu::UE(1));
+		Writer.WriteTrailingBits();
+	}
+
+	FVideoPacket MakePacket(TArray<uint8> const& Stream)
+	{
+		TSharedPtr<uint8> Data = MakeShareable(new uint8[Stream.Num()]);
+		FMemory::Memcpy(Data.Get(), Stream.GetData(), Stream.Num());
+
+		return FVideoPacket(Data, Stream.Num(), 0, 0, 0, true);
+	}
+
+	FVideoPacket MakeKeyframe()
+	{
+		TArray<uint8> Stream;
+		WriteSPS(Stream);
+		WritePPS(Stream);
+		WriteIdrSlice(Stream);
+		Stream.Add(0x00);
+
+		return MakePacket(Stream);
+	}
+
+	FVideoPacket MakeDeltaFrame(uint32 FrameNum)
+	{
+		TArray<uint8> Stream;
+		WriteNonIdrSlice(Stream, FrameNum);
+		Stream.Add(0x00);
+
+		return MakePacket(Stream);
+	}
+} // namespace ParserStateH264SpecPrivate
+
+void ParserStateH264Spec::Define()
+{
+	using namespace UE::AVCodecCore::H264;
+	using namespace ParserStateH264SpecPrivate;
+
+	Describe("ParsePacket", [this]() {
+		It("should keep parameter sets from a keyframe", [this]() {
+			FParserState ParserState;
+
+			TArray<Slice_t> Slices;
+			TArray<SEI_t> SEI;
+			TestTrue("should", ParserState.ParsePacket(MakeKeyframe(), Slices, SEI).IsSuccess());
+
+			TestEqual("should", ParserState.GetSPS().Num(), 1);
+			TestEqual("should", ParserState.GetPPS().Num(), 1);
+
+			if (TestEqual("should", Slices.Num(), 1))
+			{
+				TestEqual("should", (uint32)Slices[0].slice_type, 7u);
+				TestEqual("should", (int32)Slices[0].slice_qp_delta, 4);
+
+				SPS_t const* const SPS = ParserState.FindSPS(Slices[0]);
+				if (TestNotNull("should", SPS))
+				{
+					TestEqual("should", (uint32)SPS->pic_width_in_mbs_minus1, 19u);
+					TestEqual("should", (uint32)SPS->pic_height_in_map_units_minus1, 14u);
+				}
+			}
+		});
+
+		It("should parse later slices against the parameter sets it holds", [this]() {
+			FParserState ParserState;
+
+			TArray<Slice_t> Slices;
+			TArray<SEI_t> SEI;
+			ParserState.ParsePacket(MakeKeyframe(), Slices, SEI);
+
+			Slices.Reset();
+			TestTrue("should", ParserState.ParsePacket(MakeDeltaFrame(1), Slices, SEI).IsSuccess());
+			TestTrue("should", ParserState.ParsePacket(MakeDeltaFrame(2), Slices, SEI).IsSuccess());
+
+			if (TestEqual("should", Slices.Num(), 2))
+			{
+				TestEqual("should", (uint32)Slices[0].frame_num, 1u);
+				TestEqual("should", (uint32)Slices[1].frame_num, 2u);
+				TestEqual("should", (uint32)Slices[1].slice_type, 5u);
+				TestEqual("should", (int32)Slices[1].slice_qp_delta, -2);
+				TestEqual("should", (uint32)Slices[1].disable_deblocking_filter_idc, 1u);
+			}
+		});
+
+		It("should reject slices that arrive before their parameter sets", [this]() {
+			FParserState ParserState;
+
+			TArray<Slice_t> Slices;
+			TArray<SEI_t> SEI;
+
+			// Handled so the expected error is not logged, which would fail the test
+			TestTrue("should", ParserState.ParsePacket(MakeDeltaFrame(1), Slices, SEI).Handle().IsNotSuccess());
+		});
+
+		It("should forget parameter sets when reset", [this]() {
+			FParserState ParserState;
+
+			TArray<Slice_t> Slices;
+			TArray<SEI_t> SEI;
+			ParserState.ParsePacket(MakeKeyframe(), Slices, SEI);
+			ParserState.Reset();
+
+			TestNull("should", ParserState.FindSPS(0));
+			TestNull("should", ParserState.FindPPS(0));
+		});
+	});
+}
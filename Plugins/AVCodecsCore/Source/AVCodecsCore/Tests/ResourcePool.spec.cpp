@@ -0,0 +1,153 @@
+#include "Misc/AutomationTest.h"
+
+#include <AVDevice.h>
+#include <Audio/Resources/AudioResourceCPU.h>
+#include <Utils/ResourcePool.h>
+#include <Video/Resources/VideoResourceCPU.h>
+
+DEFINE_SPEC(ResourcePoolSpec, "AVCodecsCore.ResourcePool", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace ResourcePoolSpecPrivate
+{
+	using namespace UE::AVCodecCore;
+
+	using FVideoPool = TResourcePool<FVideoResourceCPU, FVideoDescriptor>;
+
+	TSharedPtr<FVideoResourceCPU> MakeVideo(FVideoDescriptor const& Descriptor)
+	{
+		uint32 const Size = Descriptor.GetSizeInBytes();
+
+		return MakeShared<FVideoResourceCPU>(
+			FAVDevice::GetSoftwareDevice(),
+			MakeShareable(new uint8[Size], [](uint8* Data) { delete[] Data; }),
+			FAVLayout(Descriptor.Width * 4, 0, Size),
+			Descriptor);
+	}
+
+	FVideoDescriptor const Small = FVideoDescriptor(EVideoFormat::BGRA, 64, 32);
+	FVideoDescriptor const Large = FVideoDescriptor(EVideoFormat::BGRA, 128, 64);
+} // namespace ResourcePoolSpecPrivate
+
+void ResourcePoolSpec::Define()
+{
+	using namespace ResourcePoolSpecPrivate;
+
+	Describe("Acquire", [this]() {
+		It("should miss on an empty pool", [this]() {
+			FVideoPool Pool;
+
+			TestFalse("should", Pool.Acquire(Small).IsValid());
+			TestEqual("should", Pool.NumMisses(), 1ull);
+			TestEqual("should", Pool.NumHits(), 0ull);
+		});
+
+		It("should hand back a released resource with the same descriptor", [this]() {
+			FVideoPool Pool;
+
+			TSharedPtr<FVideoResourceCPU> const Resource = MakeVideo(Small);
+			Pool.Release(Resource);
+
+			TestTrue("should", Pool.Acquire(Small) == Resource);
+			TestEqual("should", Pool.NumHits(), 1ull);
+			TestEqual("should", Pool.NumFree(), 0);
+		});
+
+		It("should not hand back a resource with a different descriptor", [this]() {
+			FVideoPool Pool;
+			Pool.Release(MakeVideo(Small));
+
+			TestFalse("should", Pool.Acquire(Large).IsValid());
+			TestFalse("should", Pool.Acquire(FVideoDescriptor(EVideoFormat::NV12, 64, 32)).IsValid());
+			TestEqual("should", Pool.NumFree(), 1);
+		});
+
+		It("should prefer the most recently released resource", [this]() {
+			FVideoPool Pool;
+
+			TSharedPtr<FVideoResourceCPU> const Older = MakeVideo(Small);
+			TSharedPtr<FVideoResourceCPU> const Newer = MakeVideo(Small);
+			Pool.Release(Older);
+			Pool.Release(Newer);
+
+			TestTrue("should", Pool.Acquire(Small) == Newer);
+			TestTrue("should", Pool.Acquire(Small) == Older);
+		});
+	});
+
+	Describe("Eviction", [this]() {
+		It("should evict the least recently released resource once full", [this]() {
+			FVideoPool Pool(2);
+
+			TSharedPtr<FVideoResourceCPU> const First = MakeVideo(Small);
+			TSharedPtr<FVideoResourceCPU> const Second = MakeVideo(Large);
+			TSharedPtr<FVideoResourceCPU> const Third = MakeVideo(Small);
+			Pool.Release(First);
+			Pool.Release(Second);
+			Pool.Release(Third);
+
+			TestEqual("should", Pool.NumFree(), 2);
+			TestEqual("should", Pool.NumEvictions(), 1ull);
+			TestEqual("should", Pool.GetHighWaterMark(), 2);
+
+			TestTrue("should", Pool.Acquire(Small) == Third);
+			TestFalse("should", Pool.Acquire(Small).IsValid());
+			TestTrue("should", Pool.Acquire(Large) == Second);
+		});
+
+		It("should drop everything on trim", [this]() {
+			FVideoPool Pool;
+			Pool.Release(MakeVideo(Small));
+			Pool.Release(MakeVideo(Large));
+
+			Pool.Trim();
+
+			TestEqual("should", Pool.NumFree(), 0);
+			TestFalse("should", Pool.Acquire(Small).IsValid());
+			TestEqual("should", Pool.GetHighWaterMark(), 2);
+		});
+	});
+
+	Describe("SteadyState", [this]() {
+		It("should stop creating resources once it has enough in circulation", [this]() {
+			FVideoPool Pool(4);
+
+			int32 NumCreated = 0;
+			TArray<TSharedPtr<FVideoResourceCPU>> InFlight;
+			for (int32 i = 0; i < 64; ++i)
+			{
+				// Alternate sizes as a recorder switching resolution would, with two frames held at a time
+				FVideoDescriptor const& Descriptor = (i / 16) % 2 ? Large : Small;
+				InFlight.Add(Pool.AcquireOrCreate(Descriptor, [&NumCreated, &Descriptor]() {
+					NumCreated++;
+					return MakeVideo(Descriptor);
+				}));
+
+				if (InFlight.Num() > 2)
+				{
+					Pool.Release(InFlight[0]);
+					InFlight.RemoveAt(0);
+				}
+			}
+
+			// At worst three for each of the four runs of one size, as long runs can evict the other size entirely
+			TestTrue("should", NumCreated <= 3 * 4);
+			TestTrue("should", Pool.NumHits() >= 64ull - NumCreated);
+		});
+
+		It("should pool audio resources too", [this]() {
+			TResourcePool<FAudioResourceCPU, FAudioDescriptor> Pool;
+
+			FAudioDescriptor const Descriptor(1024, 1.0f / 48000.0f);
+			TSharedPtr<FAudioResourceCPU> const Resource = MakeShared<FAudioResourceCPU>(
+				FAVDevice::GetSoftwareDevice(),
+				MakeShareable(new float[1024], [](float* Data) { delete[] Data; }),
+				FAVLayout(1024, 0, 1024),
+				Descriptor);
+
+			Pool.Release(Resource);
+
+			TestFalse("should", Pool.Acquire(FAudioDescriptor(512, 1.0f / 48000.0f)).IsValid());
+			TestTrue("should", Pool.Acquire(Descriptor) == Resource);
+		});
+	});
+}
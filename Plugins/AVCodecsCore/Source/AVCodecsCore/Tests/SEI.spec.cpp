@@ -0,0 +1,169 @@
+#include "Misc/AutomationTest.h"
+
+#include <Video/CodecUtils/CodecUtilsH264.h>
+#include <Video/CodecUtils/CodecUtilsH265.h>
+#include <Video/CodecUtils/CodecUtilsSEI.h>
+#include <Video/VideoPacket.h>
+
+DEFINE_SPEC(SEISpec, "AVCodecsCore.SEI", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace SEISpecPrivate
+{
+	using namespace UE::AVCodecCore;
+
+	FVideoPacket MakePacket(TArray<uint8> const& Stream)
+	{
+		TSharedPtr<uint8> Data = MakeShareable(new uint8[Stream.Num()]);
+		FMemory::Memcpy(Data.Get(), Stream.GetData(), Stream.Num());
+
+		return FVideoPacket(Data, Stream.Num(), 0, 0, 0, true);
+	}
+
+	// Zero heavy so that the payload needs emulation prevention once escaped
+	TArray<uint8> MakePayload(int32 Size)
+	{
+		TArray<uint8> Payload;
+		for (int32 i = 0; i < Size; ++i)
+		{
+			Payload.Add(i % 3 == 2 ? (uint8)(i % 4) : 0);
+		}
+
+		return Payload;
+	}
+
+	SEI::FFrameTiming MakeFrameTiming()
+	{
+		SEI::FFrameTiming FrameTiming;
+		FrameTiming.CaptureTimeUs = 1700000000000000;
+		FrameTiming.EncodeStartTimeUs = 1700000000004000;
+		FrameTiming.EncodeEndTimeUs = 1700000000007500;
+
+		return FrameTiming;
+	}
+} // namespace SEISpecPrivate
+
+void SEISpec::Define()
+{
+	using namespace UE::AVCodecCore;
+	using namespace SEISpecPrivate;
+
+	Describe("Messages", [this]() {
+		It("should read back written messages", [this]() {
+			// Types and sizes past 255 need more than one byte to code
+			TArray<uint8> const SmallPayload = MakePayload(7);
+			TArray<uint8> const LargePayload = MakePayload(600);
+
+			TArray<uint8> EBSP;
+			FBitstreamWriter Writer = FBitstreamWriter::ToEBSP(EBSP);
+			SEI::WriteMessage(Writer, SEI::EPayloadType::UserDataUnregistered, SmallPayload);
+			SEI::WriteMessage(Writer, (SEI::EPayloadType)300, LargePayload);
+			Writer.WriteTrailingBits();
+
+			TArray<SEI::FMessage> Messages;
+			FBitstreamReader Reader = FBitstreamReader::FromEBSP(EBSP.GetData(), EBSP.Num());
+			TestTrue("should", SEI::ParseMessages(Reader, Messages).IsSuccess());
+
+			if (TestEqual("should", Messages.Num(), 2))
+			{
+				TestEqual("should", (uint32)Messages[0].PayloadType, (uint32)SEI::EPayloadType::UserDataUnregistered);
+				TestEqual("should", Messages[0].Payload, SmallPayload);
+				TestEqual("should", (uint32)Messages[1].PayloadType, 300u);
+				TestEqual("should", Messages[1].Payload, LargePayload);
+			}
+		});
+
+		It("should reject payloads that run past the end", [this]() {
+			uint8 const RBSP[] = { 0x05, 0x40, 0x00, 0x00, 0x80 };
+
+			TArray<SEI::FMessage> Messages;
+			FBitstreamReader Reader(RBSP, sizeof(RBSP));
+			// Handled so the expected error is not logged, which would fail the test
+			TestTrue("should", SEI::ParseMessages(Reader, Messages).Handle().IsNotSuccess());
+		});
+	});
+
+	Describe("FrameTiming", [this]() {
+		It("should round trip through user data unregistered", [this]() {
+			SEI::FMessage Message;
+			MakeFrameTiming().Serialize(Message.Payload);
+
+			SEI::FFrameTiming FrameTiming;
+			TestTrue("should", FrameTiming.Deserialize({ Message }));
+			TestEqual("should", FrameTiming.CaptureTimeUs, MakeFrameTiming().CaptureTimeUs);
+			TestEqual("should", FrameTiming.EncodeStartTimeUs, MakeFrameTiming().EncodeStartTimeUs);
+			TestEqual("should", FrameTiming.EncodeEndTimeUs, MakeFrameTiming().EncodeEndTimeUs);
+		});
+
+		It("should ignore user data with another UUID", [this]() {
+			SEI::FMessage Message;
+			Message.Payload = MakePayload(40);
+
+			SEI::FFrameTiming FrameTiming;
+			TestFalse("should", FrameTiming.Deserialize({ Message }));
+		});
+	});
+
+	Describe("H264", [this]() {
+		It("should insert SEI in front of the first slice", [this]() {
+			TArray<uint8> const Stream = {
+				0x00, 0x00, 0x00, 0x01, 0x09, 0x10,
+				0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00, 0x21, 0x00
+			};
+
+			FVideoPacket Packet = MakePacket(Stream);
+
+			TArray<uint8> Payload;
+			MakeFrameTiming().Serialize(Payload);
+			TestTrue("should", H264::InsertSEI(Packet, SEI::EPayloadType::UserDataUnregistered, Payload).IsSuccess());
+
+			TArray<H264::FNaluInfo> Nalus;
+			H264::FindNALUs(Packet, Nalus);
+
+			if (TestEqual("should", Nalus.Num(), 3))
+			{
+				TestEqual("should", (uint8)Nalus[0].Type, (uint8)H264::ENaluType::AccessUnitDelimiter);
+				TestEqual("should", (uint8)Nalus[1].Type, (uint8)H264::ENaluType::SupplementalEnhancementInformation);
+				TestEqual("should", (uint8)Nalus[2].Type, (uint8)H264::ENaluType::SliceIdrPicture);
+
+				H264::SEI_t ParsedSEI;
+				FBitstreamReader Bitstream = FBitstreamReader::FromEBSP(Nalus[1].Data, Nalus[1].Size - 1);
+				TestTrue("should", H264::ParseSEI(Bitstream, Nalus[1], ParsedSEI).IsSuccess());
+
+				SEI::FFrameTiming FrameTiming;
+				TestTrue("should", FrameTiming.Deserialize(ParsedSEI.Messages));
+				TestEqual("should", FrameTiming.CaptureTimeUs, MakeFrameTiming().CaptureTimeUs);
+			}
+		});
+	});
+
+	Describe("H265", [this]() {
+		It("should insert a prefix SEI in front of the first slice", [this]() {
+			TArray<uint8> const Stream = {
+				0x00, 0x00, 0x00, 0x01, 0x46, 0x01, 0x10,
+				0x00, 0x00, 0x00, 0x01, 0x26, 0x01, 0xAF, 0x00, 0x21, 0x00
+			};
+
+			FVideoPacket Packet = MakePacket(Stream);
+
+			TArray<uint8> Payload;
+			MakeFrameTiming().Serialize(Payload);
+			TestTrue("should", H265::InsertSEI(Packet, SEI::EPayloadType::UserDataUnregistered, Payload).IsSuccess());
+
+			TArray<H265::FNaluH265> Nalus;
+			H265::FindNALUs(Packet, Nalus);
+
+			if (TestEqual("should", Nalus.Num(), 3))
+			{
+				TestEqual("should", (uint8)Nalus[1].nal_unit_type.Value, (uint8)H265::ENaluType::PREFIX_SEI_NUT);
+				TestEqual("should", (uint8)Nalus[2].nal_unit_type.Value, (uint8)H265::ENaluType::IDR_W_RADL);
+
+				H265::FNaluSEI ParsedSEI(Nalus[1]);
+				TestTrue("should", ParsedSEI.Parse().IsSuccess());
+
+				SEI::FFrameTiming FrameTiming;
+				TestTrue("should", FrameTiming.Deserialize(ParsedSEI.Messages));
+				TestEqual("should", FrameTiming.EncodeEndTimeUs, MakeFrameTiming().EncodeEndTimeUs);
+			}
+		});
+	});
+}
@@ -0,0 +1,244 @@
+#include "Misc/AutomationTest.h"
+
+#include <Utils/BitstreamWriter.h>
+#include <Video/CodecUtils/CodecUtilsH264.h>
+#include <Video/VideoPacket.h>
+
+DEFINE_SPEC(SPSRewriteH264Spec, "AVCodecsCore.H264.SPSRewrite", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace SPSRewriteH264SpecPrivate
+{
+	using namespace UE::AVCodecCore::H264;
+
+	struct FSPSOptions
+	{
+		bool bVUI = false;
+		bool bTiming = false;
+		bool bHRD = false;
+		bool bRestriction = false;
+	};
+
+	// High profile 1080p SPS with three reference frames, optionally carrying the VUI fields hardware encoders tend to emit
+	void WriteSPS(TArray<uint8>& Stream, FSPSOptions const& Options)
+	{
+		Stream.Append({ 0x00, 0x00, 0x00, 0x01, 0x67 });
+
+		FBitstreamWriter Writer = FBitstreamWriter::ToEBSP(Stream);
+		Writer.Write(FNalu::U<8>(100), FNalu::U<8>(0), FNalu::U<8>(40), FNalu::UE(0));
+		Writer.Write(FNalu::UE(1), FNalu::UE(0), FNalu::UE(0), FNalu::U<1>(0), FNalu::U<1>(0));
+		Writer.Write(FNalu::UE(0), FNalu::UE(0), FNalu::UE(0));
+		Writer.Write(FNalu::UE(3), FNalu::U<1>(0), FNalu::UE(119), FNalu::UE(67), FNalu::U<1>(1), FNalu::U<1>(1));
+		Writer.Write(FNalu::U<1>(1), FNalu::UE(0), FNalu::UE(0), FNalu::UE(0), FNalu::UE(4));
+
+		Writer.Write(FNalu::U<1>(Options.bVUI));
+		if (Options.bVUI)
+		{
+			// Extended SAR, no overscan, full range BT.709
+			Writer.Write(FNalu::U<1>(1), FNalu::U<8>(255), FNalu::U<16>(4), FNalu::U<16>(3));
+			Writer.Write(FNalu::U<1>(0));
+			Writer.Write(FNalu::U<1>(1), FNalu::U<3>(5), FNalu::U<1>(1), FNalu::U<1>(1), FNalu::U<8>(1), FNalu::U<8>(1), FNalu::U<8>(1));
+			Writer.Write(FNalu::U<1>(0));
+
+			Writer.Write(FNalu::U<1>(Options.bTiming));
+			if (Options.bTiming)
+			{
+				Writer.Write(FNalu::U<32>(1001), FNalu::U<32>(60000), FNalu::U<1>(1));
+			}
+
+			Writer.Write(FNalu::U<1>(Options.bHRD));
+			if (Options.bHRD)
+			{
+				Writer.Write(FNalu::UE(1), FNalu::U<4>(4), FNalu::U<4>(3));
+				Writer.Write(FNalu::UE(1000), FNalu::UE(2000), FNalu::U<1>(1));
+				Writer.Write(FNalu::UE(1001), FNalu::UE(2001), FNalu::U<1>(1));
+				Writer.Write(FNalu::U<5>(23), FNalu::U<5>(23), FNalu::U<5>(23), FNalu::U<5>(24));
+			}
+
+			Writer.Write(FNalu::U<1>(0));
+			if (Options.bHRD)
+			{
+				Writer.Write(FNalu::U<1>(1));
+			}
+
+			Writer.Write(FNalu::U<1>(1));
+
+			Writer.Write(FNalu::U<1>(Options.bRestriction));
+			if (Options.bRestriction)
+			{
+				Writer.Write(FNalu::U<1>(0), FNalu::UE(3), FNalu::UE(5), FNalu::UE(11), FNalu::UE(12), FNalu::UE(4), FNalu::UE(7));
+			}
+		}
+
+		Writer.WriteTrailingBits();
+	}
+
+	// SPS followed by a stand in PPS and IDR slice, which only need to survive the rewrite untouched
+	TArray<uint8> MakeKeyframe(FSPSOptions const& Options)
+	{
+		TArray<uint8> Stream = { 0x00, 0x00, 0x00, 0x01, 0x09, 0x10 };
+		WriteSPS(Stream, Options);
+		Stream.Append({ 0x00, 0x00, 0x00, 0x01, 0x68, 0xEE, 0x3C, 0x80 });
+		Stream.Append({ 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00, 0x00, 0x03, 0x00, 0x21, 0x00 });
+
+		return Stream;
+	}
+
+	FVideoPacket MakePacket(TArray<uint8> const& Stream)
+	{
+		TSharedPtr<uint8> Data = MakeShareable(new uint8[Stream.Num()]);
+		FMemory::Memcpy(Data.Get(), Stream.GetData(), Stream.Num());
+
+		return FVideoPacket(Data, Stream.Num(), 0, 0, 0, true);
+	}
+
+	bool ParsePacketSPS(FVideoPacket const& Packet, SPS_t& OutSPS)
+	{
+		TArray<FNaluInfo> Nalus;
+		FindNALUs(Packet, Nalus);
+
+		for (FNaluInfo const& NaluInfo : Nalus)
+		{
+			if (NaluInfo.Type == ENaluType::SequenceParameterSet)
+			{
+				TMap<uint32, SPS_t> MapSPS;
+				FBitstreamReader Bitstream = FBitstreamReader::FromEBSP(NaluInfo.Data, NaluInfo.Size - 1);
+				if (ParseSPS(Bitstream, NaluInfo, MapSPS).IsSuccess() && MapSPS.Contains(0))
+				{
+					OutSPS = MapSPS[0];
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+} // namespace SPSRewriteH264SpecPrivate
+
+void SPSRewriteH264Spec::Define()
+{
+	using namespace UE::AVCodecCore::H264;
+	using namespace SPSRewriteH264SpecPrivate;
+
+	auto const Rewrite = [this](FSPSOptions const& Options, FVUIRewrite const& VUIRewrite, SPS_t& OutBefore, SPS_t& OutAfter) -> bool
+	{
+		TArray<uint8> const Stream = MakeKeyframe(Options);
+		FVideoPacket Packet = MakePacket(Stream);
+
+		bool bParsed = TestTrue("should", ParsePacketSPS(Packet, OutBefore));
+		TestTrue("should", RewriteSPS(Packet, VUIRewrite).IsSuccess());
+		bParsed &= TestTrue("should", ParsePacketSPS(Packet, OutAfter));
+
+		// Everything after the SPS is carried over byte for byte
+		TArray<uint8> const Tail(Stream.GetData() + Stream.Num() - 20, 20);
+		TestEqual("should", TArray<uint8>(Packet.DataPtr.Get() + Packet.DataSize - 20, 20), Tail);
+
+		return bParsed;
+	};
+
+	Describe("BitstreamRestriction", [this, Rewrite]() {
+		It("should add a VUI to an SPS without one", [this, Rewrite]() {
+			SPS_t Before, After;
+			if (Rewrite(FSPSOptions(), FVUIRewrite(), Before, After))
+			{
+				TestFalse("should", (bool)Before.vui_parameters_present_flag);
+				TestTrue("should", (bool)After.vui_parameters_present_flag);
+				TestTrue("should", (bool)After.bitstream_restriction_flag);
+				TestEqual("should", (uint32)After.max_num_reorder_frames, 0u);
+				TestEqual("should", (uint32)After.max_dec_frame_buffering, 3u);
+				TestFalse("should", (bool)After.timing_info_present_flag);
+			}
+		});
+
+		It("should preserve the rest of the SPS and VUI", [this, Rewrite]() {
+			FSPSOptions Options;
+			Options.bVUI = true;
+			Options.bTiming = true;
+			Options.bHRD = true;
+
+			SPS_t Before, After;
+			if (Rewrite(Options, FVUIRewrite(), Before, After))
+			{
+				TestEqual("should", (uint32)After.level_idc, (uint32)Before.level_idc);
+				TestEqual("should", (uint32)After.pic_width_in_mbs_minus1, 119u);
+				TestEqual("should", (uint32)After.frame_crop_bottom_offset, 4u);
+				TestEqual("should", (uint32)After.sar_width, 4u);
+				TestEqual("should", (uint32)After.sar_height, 3u);
+				TestEqual("should", (uint32)After.video_full_range_flag, 1u);
+				TestEqual("should", (uint32)After.colour_primaries, 1u);
+				TestEqual("should", (uint32)After.time_scale, 60000u);
+				TestEqual("should", (uint32)After.num_units_in_tick, 1001u);
+				TestEqual("should", (uint32)After.cpb_cnt_minus1, 1u);
+				TestEqual("should", (uint32)After.bit_rate_value_minus1[1], 1001u);
+				TestEqual("should", (uint32)After.low_delay_hrd_flag, 1u);
+				TestEqual("should", (uint32)After.pic_struct_present_flag, 1u);
+				TestTrue("should", (bool)After.bitstream_restriction_flag);
+				TestEqual("should", (uint32)After.max_num_reorder_frames, 0u);
+				TestEqual("should", (uint32)After.max_dec_frame_buffering, 3u);
+			}
+		});
+
+		It("should keep existing limits other than reordering", [this, Rewrite]() {
+			FSPSOptions Options;
+			Options.bVUI = true;
+			Options.bRestriction = true;
+
+			SPS_t Before, After;
+			if (Rewrite(Options, FVUIRewrite(), Before, After))
+			{
+				TestEqual("should", (uint32)Before.max_num_reorder_frames, 4u);
+				TestEqual("should", (uint32)After.max_num_reorder_frames, 0u);
+				TestEqual("should", (uint32)After.max_dec_frame_buffering, 3u);
+				TestEqual("should", (uint32)After.max_bits_per_mb_denom, 5u);
+				TestEqual("should", (uint32)After.log2_max_mv_length_vertical, 12u);
+			}
+		});
+	});
+
+	Describe("Timing", [this, Rewrite]() {
+		It("should replace timing info when a time scale is given", [this, Rewrite]() {
+			FSPSOptions Options;
+			Options.bVUI = true;
+			Options.bTiming = true;
+
+			FVUIRewrite VUIRewrite;
+			VUIRewrite.TimeScale = 90000;
+			VUIRewrite.NumUnitsInTick = 1500;
+			VUIRewrite.bFixedFrameRate = true;
+
+			SPS_t Before, After;
+			if (Rewrite(Options, VUIRewrite, Before, After))
+			{
+				TestTrue("should", (bool)After.timing_info_present_flag);
+				TestEqual("should", (uint32)After.time_scale, 90000u);
+				TestEqual("should", (uint32)After.num_units_in_tick, 1500u);
+				TestTrue("should", (bool)After.fixed_frame_rate_flag);
+				TestEqual("should", (uint32)After.sar_width, 4u);
+			}
+		});
+	});
+
+	Describe("Idempotence", [this]() {
+		It("should produce the same packet when rewritten twice", [this]() {
+			FSPSOptions Options;
+			Options.bVUI = true;
+			Options.bHRD = true;
+
+			FVideoPacket Packet = MakePacket(MakeKeyframe(Options));
+			RewriteSPS(Packet, FVUIRewrite());
+
+			TArray<uint8> const Once(Packet.DataPtr.Get(), Packet.DataSize);
+			RewriteSPS(Packet, FVUIRewrite());
+
+			TestEqual("should", TArray<uint8>(Packet.DataPtr.Get(), Packet.DataSize), Once);
+		});
+
+		It("should leave packets without an SPS alone", [this]() {
+			TArray<uint8> const Stream = { 0x00, 0x00, 0x00, 0x01, 0x41, 0x9A, 0x02, 0x00 };
+			FVideoPacket Packet = MakePacket(Stream);
+			uint8 const* const Data = Packet.DataPtr.Get();
+
+			TestTrue("should", RewriteSPS(Packet, FVUIRewrite()).IsSuccess());
+			TestTrue("should", Packet.DataPtr.Get() == Data);
+		});
+	});
+}
@@ -0,0 +1,172 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include <Utils/StartCodeScanner.h>
+
+DEFINE_SPEC(StartCodeScannerSpec, "AVCodecsCore.StartCodeScanner", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace StartCodeScannerSpecPrivate
+{
+	// Random payload with start codes, emulation prevention bytes and long zero runs sprinkled in at arbitrary alignments
+	TArray<uint8> MakeAnnexBStream(int32 Seed, int32 Size)
+	{
+		FRandomStream Random(Seed);
+
+		TArray<uint8> Stream;
+		Stream.Reserve(Size);
+		while (Stream.Num() < Size)
+		{
+			int32 const Choice = Random.RandRange(0, 99);
+			if (Choice < 2)
+			{
+				Stream.Append({ 0, 0, 0, 1 });
+			}
+			else if (Choice < 4)
+			{
+				Stream.Append({ 0, 0, 1 });
+			}
+			else if (Choice < 6)
+			{
+				Stream.Append({ 0, 0, 3 });
+			}
+			else if (Choice < 8)
+			{
+				Stream.AddZeroed(Random.RandRange(1, 40));
+			}
+			else
+			{
+				Stream.Add((uint8)Random.RandRange(0, 255));
+			}
+		}
+
+		Stream.SetNum(Size);
+
+		return Stream;
+	}
+
+	TArray<int64> FindAll(TArray<uint8> const& Stream, TFunctionRef<int64(uint8 const*, int64, int64)> Find)
+	{
+		TArray<int64> Found;
+		for (int64 i = Find(Stream.GetData(), Stream.Num(), 0); i != INDEX_NONE; i = Find(Stream.GetData(), Stream.Num(), i + 3))
+		{
+			Found.Add(i);
+		}
+
+		return Found;
+	}
+} // namespace StartCodeScannerSpecPrivate
+
+void StartCodeScannerSpec::Define()
+{
+	using namespace UE::AVCodecCore;
+	using namespace StartCodeScannerSpecPrivate;
+
+	Describe("Positive", [this]() {
+		It("should find start codes at every alignment", [this]() {
+			for (int32 Size = 3; Size < 100; ++Size)
+			{
+				for (int32 Position = 0; Position + 3 <= Size; ++Position)
+				{
+					TArray<uint8> Stream;
+					Stream.Init(0xFF, Size);
+					Stream[Position + 0] = 0;
+					Stream[Position + 1] = 0;
+					Stream[Position + 2] = 1;
+
+					TestEqual("should", FindStartCode(Stream.GetData(), Stream.Num()), (int64)Position);
+				}
+			}
+		});
+
+		It("should match the scalar scanner on synthetic streams", [this]() {
+			for (int32 Seed = 0; Seed < 64; ++Seed)
+			{
+				TArray<uint8> const Stream = MakeAnnexBStream(Seed, 1 + Seed * 257);
+
+				TestEqual("should", FindAll(Stream, FindStartCode), FindAll(Stream, FindStartCodeScalar));
+			}
+		});
+
+		It("should match the scalar scanner on recorded Annex-B dumps", [this]() {
+			// Drop raw .h264/.h265 dumps (eg. from FAVPacket::WriteToFile) into this folder to include them in the comparison
+			FString const DumpDir = FPaths::Combine(FPaths::ProjectDir(), "Test", "UnitTest", "AVCodecsCore", "AnnexB");
+
+			TArray<FString> DumpFiles;
+			IFileManager::Get().FindFiles(DumpFiles, *DumpDir, TEXT("*.h26*"));
+			if (DumpFiles.IsEmpty())
+			{
+				AddWarning(FString::Printf(TEXT("No Annex-B dumps found in %s, nothing was compared"), *DumpDir));
+				return;
+			}
+
+			for (FString const& DumpFile : DumpFiles)
+			{
+				TArray<uint8> Stream;
+				if (FFileHelper::LoadFileToArray(Stream, *FPaths::Combine(DumpDir, DumpFile)))
+				{
+					TestEqual(*DumpFile, FindAll(Stream, FindStartCode), FindAll(Stream, FindStartCodeScalar));
+				}
+			}
+		});
+	});
+
+	Describe("Negative", [this]() {
+		It("should not find start codes in short or empty streams", [this]() {
+			uint8 const Stream[] = { 0, 0, 1 };
+
+			TestEqual("should", FindStartCode(Stream, 0), (int64)INDEX_NONE);
+			TestEqual("should", FindStartCode(Stream, 2), (int64)INDEX_NONE);
+			TestEqual("should", FindStartCode(Stream, 3, 1), (int64)INDEX_NONE);
+		});
+
+		It("should not treat emulation prevention bytes as start codes", [this]() {
+			TArray<uint8> Stream;
+			for (int32 i = 0; i < 64; ++i)
+			{
+				Stream.Append({ 0, 0, 3, 0xAB });
+			}
+
+			TestEqual("should", FindStartCode(Stream.GetData(), Stream.Num()), (int64)INDEX_NONE);
+		});
+	});
+
+	Describe("Benchmark", [this]() {
+		It("should report scan throughput against the scalar scanner", [this]() {
+			TArray<uint8> Stream;
+			FRandomStream Random(0x4B);
+			Stream.SetNumUninitialized(8 * 1024 * 1024);
+			for (uint8& Byte : Stream)
+			{
+				// Keep start codes rare, like a 4K slice payload
+				Byte = (uint8)Random.RandRange(2, 255);
+			}
+
+			// Timings depend on the machine, so they are only reported. The scanners must still agree on what they find.
+			auto const Measure = [&Stream](TFunctionRef<int64(uint8 const*, int64, int64)> Find, int64& OutChecksum) -> double
+			{
+				OutChecksum = 0;
+
+				double const Start = FPlatformTime::Seconds();
+				for (int32 Iteration = 0; Iteration < 16; ++Iteration)
+				{
+					OutChecksum += Find(Stream.GetData(), Stream.Num(), 0);
+				}
+
+				return FPlatformTime::Seconds() - Start;
+			};
+
+			int64 ScalarChecksum = 0;
+			int64 VectorChecksum = 0;
+			double const ScalarSeconds = Measure(FindStartCodeScalar, ScalarChecksum);
+			double const VectorSeconds = Measure(FindStartCode, VectorChecksum);
+
+			AddInfo(FString::Printf(TEXT("Scalar %.2f GB/s, vectorized %.2f GB/s"), 16 * Stream.Num() / ScalarSeconds / 1e9, 16 * Stream.Num() / VectorSeconds / 1e9));
+			TestEqual("should", VectorChecksum, ScalarChecksum);
+		});
+	});
+}
@@ -0,0 +1,46 @@
+#include "Misc/AutomationTest.h"
+
+#include <Video/VideoResource.h>
+
+DEFINE_SPEC(VideoDescriptorSpec, "AVCodecsCore.VideoDescriptor", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+void VideoDescriptorSpec::Define()
+{
+	Describe("RawDescriptor", [this]() {
+		It("should share one raw descriptor between copies", [this]() {
+			FVideoDescriptor const Descriptor(EVideoFormat::NV12, 1920, 1080, FVideoDescriptor(EVideoFormat::R8, 1920, 1620));
+			FVideoDescriptor const Copy = Descriptor;
+
+			FVideoDescriptor Assigned;
+			Assigned = Copy;
+
+			TestTrue("should", Descriptor.RawDescriptor != nullptr);
+			TestTrue("should", Copy.RawDescriptor == Descriptor.RawDescriptor);
+			TestTrue("should", Assigned.RawDescriptor == Descriptor.RawDescriptor);
+		});
+
+		It("should intern equal raw descriptors to the same copy", [this]() {
+			FVideoDescriptor const First(EVideoFormat::P010, 1280, 720, FVideoDescriptor(EVideoFormat::G16, 1280, 1080));
+			FVideoDescriptor const Second(EVideoFormat::P010, 1280, 720, FVideoDescriptor(EVideoFormat::G16, 1280, 1080));
+			FVideoDescriptor const Other(EVideoFormat::NV12, 1280, 720, FVideoDescriptor(EVideoFormat::R8, 1280, 1080));
+
+			TestTrue("should", First.RawDescriptor == Second.RawDescriptor);
+			TestTrue("should", First.RawDescriptor != Other.RawDescriptor);
+
+			TestTrue("should", First.RawDescriptor->Format == EVideoFormat::G16);
+			TestEqual("should", First.RawDescriptor->Width, 1280u);
+			TestEqual("should", First.RawDescriptor->Height, 1080u);
+			TestTrue("should", First.RawDescriptor->RawDescriptor == nullptr);
+		});
+
+		It("should outlive the descriptors that refer to it", [this]() {
+			FVideoDescriptor const* Raw = nullptr;
+			{
+				FVideoDescriptor const Descriptor(EVideoFormat::YUV444, 640, 480, FVideoDescriptor(EVideoFormat::R8, 1920, 480));
+				Raw = Descriptor.RawDescriptor;
+			}
+
+			TestTrue("should", FVideoDescriptor::Intern(FVideoDescriptor(EVideoFormat::R8, 1920, 480)) == Raw);
+		});
+	});
+}
@@ -0,0 +1,175 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+
+#include <Video/Encoders/VideoEncodeAdmission.h>
+#include <Video/Encoders/VideoEncodePipeline.h>
+
+DEFINE_SPEC(VideoEncodeAdmissionSpec, "AVCodecsCore.VideoEncodeAdmission", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace VideoEncodeAdmissionSpecPrivate
+{
+	constexpr double FrameInterval = 1.0 / 60.0;
+
+	constexpr int32 NumFrames = 48;
+	constexpr int32 KeyframeInterval = 16;
+
+	// A capture rate the encoder below cannot keep up with
+	constexpr float CaptureSeconds = 0.005f;
+	constexpr float EncodeSeconds = 0.015f;
+
+	// Give the admission a few frames of history, each taking EncodeSeconds
+	void Prime(FVideoEncodeAdmission& Admission, double Seconds, int32 NumPrimed = 4)
+	{
+		for (int32 i = 0; i < NumPrimed; ++i)
+		{
+			Admission.Admit(true, FrameInterval);
+			Admission.OnEncodeFinished(Seconds);
+		}
+	}
+
+	struct FRunResult
+	{
+		double MaxLatency = 0.0;
+		int32 NumDelivered = 0;
+		int32 NumKeyframesDelivered = 0;
+	};
+
+	// Feed frames faster than a fake slow encoder can take them, optionally through an admission
+	FRunResult Run(FVideoEncodeAdmission* Admission)
+	{
+		FRunResult Result;
+
+		{
+			FVideoEncodePipeline Pipeline(4, TEXT("Encode Admission Spec"));
+
+			for (int32 i = 0; i < NumFrames; ++i)
+			{
+				FPlatformProcess::Sleep(CaptureSeconds);
+
+				bool const bKeyframe = i % KeyframeInterval == 0;
+				if (Admission != nullptr && !Admission->Admit(bKeyframe, CaptureSeconds))
+				{
+					continue;
+				}
+
+				double const SubmitTime = FPlatformTime::Seconds();
+				Pipeline.Submit([Admission, &Result, SubmitTime, bKeyframe]() -> FVideoEncodePipeline::FCompleteFunc {
+					double const StartTime = FPlatformTime::Seconds();
+					FPlatformProcess::Sleep(EncodeSeconds);
+
+					if (Admission != nullptr)
+					{
+						Admission->OnEncodeFinished(FPlatformTime::Seconds() - StartTime);
+					}
+
+					return [&Result, SubmitTime, bKeyframe]() {
+						Result.MaxLatency = FMath::Max(Result.MaxLatency, FPlatformTime::Seconds() - SubmitTime);
+						Result.NumDelivered++;
+						Result.NumKeyframesDelivered += bKeyframe ? 1 : 0;
+					};
+				});
+			}
+		}
+
+		return Result;
+	}
+} // namespace VideoEncodeAdmissionSpecPrivate
+
+void VideoEncodeAdmissionSpec::Define()
+{
+	using namespace VideoEncodeAdmissionSpecPrivate;
+
+	Describe("Admit", [this]() {
+		It("should admit frames while the encoder keeps up", [this]() {
+			FVideoEncodeAdmission Admission(4);
+			Prime(Admission, 0.002);
+
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+			TestEqual("should", Admission.NumFramesInFlight(), 2);
+			TestEqual("should", Admission.NumDropped(), 0ull);
+		});
+
+		It("should admit a frame when nothing else is in flight", [this]() {
+			FVideoEncodeAdmission Admission(4);
+			Prime(Admission, FrameInterval * 3.0);
+
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+		});
+
+		It("should drop delta frames that would finish after the next frame is due", [this]() {
+			FVideoEncodeAdmission Admission(4);
+			Prime(Admission, FrameInterval * 0.75);
+
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+			TestFalse("should", Admission.Admit(false, FrameInterval));
+			TestEqual("should", Admission.NumDropped(), 1ull);
+			TestEqual("should", Admission.NumFramesInFlight(), 1);
+		});
+
+		It("should always admit keyframes", [this]() {
+			FVideoEncodeAdmission Admission(1);
+			Prime(Admission, FrameInterval * 3.0);
+
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+			TestTrue("should", Admission.Admit(true, FrameInterval));
+			TestEqual("should", Admission.NumDropped(), 0ull);
+		});
+
+		It("should keep to its limit on frames in flight", [this]() {
+			FVideoEncodeAdmission Admission(2);
+			Prime(Admission, 0.0001);
+
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+			TestFalse("should", Admission.Admit(false, FrameInterval));
+
+			Admission.OnEncodeFinished(0.0001);
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+		});
+
+		It("should free the place of an abandoned frame", [this]() {
+			FVideoEncodeAdmission Admission(1);
+			Prime(Admission, 0.0001);
+
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+			Admission.OnEncodeAbandoned();
+
+			TestEqual("should", Admission.NumFramesInFlight(), 0);
+			TestTrue("should", Admission.Admit(false, FrameInterval));
+			TestTrue("should", FMath::IsNearlyEqual(Admission.GetAverageEncodeSeconds(), 0.0001));
+		});
+	});
+
+	Describe("History", [this]() {
+		It("should average only the most recent encodes", [this]() {
+			FVideoEncodeAdmission Admission(0, 4);
+			Prime(Admission, 1.0, 4);
+			Prime(Admission, 0.5, 4);
+
+			TestTrue("should", FMath::IsNearlyEqual(Admission.GetAverageEncodeSeconds(), 0.5));
+		});
+	});
+
+	Describe("SlowEncoder", [this]() {
+		It("should keep latency down by dropping delta frames", [this]() {
+			FRunResult const Unlimited = Run(nullptr);
+
+			FVideoEncodeAdmission Admission(4);
+			FRunResult const Admitted = Run(&Admission);
+
+			AddInfo(FString::Printf(TEXT("Worst latency %.1fms delivering every frame, %.1fms dropping %llu of %d"), Unlimited.MaxLatency * 1000.0, Admitted.MaxLatency * 1000.0, Admission.NumDropped(), NumFrames));
+
+			TestEqual("should", Unlimited.NumDelivered, NumFrames);
+			TestTrue("should", Admission.NumDropped() > 0ull);
+			TestEqual("should", Admitted.NumDelivered, NumFrames - static_cast<int32>(Admission.NumDropped()));
+			TestEqual("should", Admitted.NumKeyframesDelivered, NumFrames / KeyframeInterval);
+
+			// Without admission frames wait behind the whole pipeline, with it at worst behind a keyframe let in over the top
+			TestTrue("should", Admitted.MaxLatency < Unlimited.MaxLatency);
+			TestTrue("should", Admitted.MaxLatency < EncodeSeconds * 3.0);
+		});
+	});
+}
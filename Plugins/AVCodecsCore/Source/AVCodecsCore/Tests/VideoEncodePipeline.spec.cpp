@@ -0,0 +1,131 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadSafeCounter.h"
+
+#include <Video/Encoders/VideoEncodePipeline.h>
+
+DEFINE_SPEC(VideoEncodePipelineSpec, "AVCodecsCore.VideoEncodePipeline", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace VideoEncodePipelineSpecPrivate
+{
+	constexpr int32 NumFrames = 24;
+
+	// Stand ins for the time spent capturing a frame and for a hardware encoder busy with it
+	constexpr float CaptureSeconds = 0.008f;
+	constexpr float EncodeSeconds = 0.008f;
+
+	struct FDelayedEncoder
+	{
+		FThreadSafeCounter NumEncoded;
+		TArray<int32> Delivered;
+
+		FVideoEncodePipeline::FEncodeFunc MakeEncode(int32 FrameIndex)
+		{
+			return [this, FrameIndex]() -> FVideoEncodePipeline::FCompleteFunc {
+				FPlatformProcess::Sleep(EncodeSeconds);
+				NumEncoded.Increment();
+
+				return [this, FrameIndex]() {
+					Delivered.Add(FrameIndex);
+				};
+			};
+		}
+	};
+
+	double RunSynchronous()
+	{
+		FDelayedEncoder Encoder;
+
+		double const StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumFrames; ++i)
+		{
+			FPlatformProcess::Sleep(CaptureSeconds);
+			Encoder.MakeEncode(i)()();
+		}
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	double RunPipelined(int32 MaxFramesInFlight, FDelayedEncoder& Encoder)
+	{
+		FVideoEncodePipeline Pipeline(MaxFramesInFlight, TEXT("Encode Pipeline Spec"));
+
+		double const StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumFrames; ++i)
+		{
+			FPlatformProcess::Sleep(CaptureSeconds);
+			Pipeline.Submit(Encoder.MakeEncode(i));
+		}
+
+		Pipeline.Flush();
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+} // namespace VideoEncodePipelineSpecPrivate
+
+void VideoEncodePipelineSpec::Define()
+{
+	using namespace VideoEncodePipelineSpecPrivate;
+
+	Describe("Ordering", [this]() {
+		It("should deliver frames in the order they were submitted", [this]() {
+			FDelayedEncoder Encoder;
+			RunPipelined(3, Encoder);
+
+			TArray<int32> Expected;
+			for (int32 i = 0; i < NumFrames; ++i)
+			{
+				Expected.Add(i);
+			}
+
+			TestEqual("should", Encoder.Delivered, Expected);
+		});
+
+		It("should deliver everything submitted before it is destroyed", [this]() {
+			FDelayedEncoder Encoder;
+			{
+				FVideoEncodePipeline Pipeline(4, TEXT("Encode Pipeline Spec"));
+				for (int32 i = 0; i < 4; ++i)
+				{
+					Pipeline.Submit(Encoder.MakeEncode(i));
+				}
+			}
+
+			TestEqual("should", Encoder.Delivered.Num(), 4);
+		});
+	});
+
+	Describe("Backpressure", [this]() {
+		It("should never have more frames in flight than allowed", [this]() {
+			FDelayedEncoder Encoder;
+			FVideoEncodePipeline Pipeline(2, TEXT("Encode Pipeline Spec"));
+
+			int32 MostInFlight = 0;
+			for (int32 i = 0; i < 8; ++i)
+			{
+				Pipeline.Submit(Encoder.MakeEncode(i));
+				MostInFlight = FMath::Max(MostInFlight, Pipeline.NumFramesInFlight());
+			}
+
+			Pipeline.Flush();
+
+			TestTrue("should", MostInFlight <= 2);
+			TestEqual("should", Pipeline.NumFramesInFlight(), 0);
+			TestEqual("should", Encoder.NumEncoded.GetValue(), 8);
+		});
+	});
+
+	Describe("Throughput", [this]() {
+		It("should overlap encoding with capturing the next frame", [this]() {
+			double const SynchronousSeconds = RunSynchronous();
+
+			FDelayedEncoder Encoder;
+			double const PipelinedSeconds = RunPipelined(2, Encoder);
+
+			// Ideally close to half, the margin keeps a busy test machine from failing it
+			TestTrue("should", PipelinedSeconds < SynchronousSeconds * 0.8);
+		});
+	});
+}
@@ -0,0 +1,229 @@
+#include "Misc/AutomationTest.h"
+
+#include <Video/Encoders/VideoEncodeSession.h>
+
+DEFINE_SPEC(VideoEncodeSessionSpec, "AVCodecsCore.VideoEncodeSession", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace VideoEncodeSessionSpecPrivate
+{
+	// Stand in for peers subscribed to the session
+	int32 PeerA = 0;
+	int32 PeerB = 0;
+	int32 PeerC = 0;
+} // namespace VideoEncodeSessionSpecPrivate
+
+void VideoEncodeSessionSpec::Define()
+{
+	using namespace VideoEncodeSessionSpecPrivate;
+
+	Describe("ClaimFrame", [this]() {
+		It("should let only the first subscriber encode each frame", [this]() {
+			FVideoEncodeSession Session;
+			Session.Subscribe(&PeerA);
+			Session.Subscribe(&PeerB);
+			Session.Subscribe(&PeerC);
+
+			int32 NumEncoded = 0;
+			for (uint64 Frame = 1; Frame <= 10; ++Frame)
+			{
+				for (int32 Peer = 0; Peer < Session.NumSubscribers(); ++Peer)
+				{
+					NumEncoded += Session.ClaimFrame(Frame) ? 1 : 0;
+				}
+			}
+
+			TestEqual("should", NumEncoded, 10);
+			TestEqual("should", Session.NumFramesClaimed(), 10ull);
+			TestEqual("should", Session.NumFramesShared(), 20ull);
+		});
+
+		It("should recognise a frame offered slightly out of step", [this]() {
+			FVideoEncodeSession Session;
+
+			TestTrue("should", Session.ClaimFrame(1));
+			TestTrue("should", Session.ClaimFrame(2));
+			TestTrue("should", Session.ClaimFrame(3));
+			TestFalse("should", Session.ClaimFrame(1));
+			TestFalse("should", Session.ClaimFrame(2));
+		});
+	});
+
+	Describe("Rate", [this]() {
+		It("should be unset until a subscriber asks for one", [this]() {
+			FVideoEncodeSession Session;
+			Session.Subscribe(&PeerA);
+
+			TestFalse("should", Session.GetRate().IsSet());
+			TestFalse("should", Session.TakeRateChange().IsSet());
+		});
+
+		It("should run at the lowest rate asked for", [this]() {
+			FVideoEncodeSession Session(EVideoEncodeRatePolicy::Minimum);
+			Session.SetRate(&PeerA, { 4000000, 60.0 });
+			Session.SetRate(&PeerB, { 1000000, 30.0 });
+
+			TOptional<FVideoEncodeSession::FRate> const Rate = Session.GetRate();
+			TestTrue("should", Rate.IsSet() && *Rate == FVideoEncodeSession::FRate{ 1000000, 30.0 });
+		});
+
+		It("should run at the mean rate asked for", [this]() {
+			FVideoEncodeSession Session(EVideoEncodeRatePolicy::Average);
+			Session.SetRate(&PeerA, { 4000000, 60.0 });
+			Session.SetRate(&PeerB, { 1000000, 30.0 });
+
+			TOptional<FVideoEncodeSession::FRate> const Rate = Session.GetRate();
+			TestTrue("should", Rate.IsSet() && *Rate == FVideoEncodeSession::FRate{ 2500000, 45.0 });
+		});
+
+		It("should leave out subscribers that have paused", [this]() {
+			FVideoEncodeSession Session;
+			Session.SetRate(&PeerA, { 4000000, 60.0 });
+			Session.SetRate(&PeerB, { 0, 0.0 });
+
+			TOptional<FVideoEncodeSession::FRate> const Rate = Session.GetRate();
+			TestTrue("should", Rate.IsSet() && Rate->Bitrate == 4000000);
+		});
+
+		It("should only hand out a rate change once", [this]() {
+			FVideoEncodeSession Session;
+			Session.SetRate(&PeerA, { 4000000, 60.0 });
+
+			TestTrue("should", Session.TakeRateChange().IsSet());
+			TestFalse("should", Session.TakeRateChange().IsSet());
+
+			// Raising a rate above the minimum changes nothing for the encoder
+			Session.SetRate(&PeerB, { 1000000, 30.0 });
+			TestTrue("should", Session.TakeRateChange().IsSet());
+			Session.SetRate(&PeerA, { 8000000, 60.0 });
+			TestFalse("should", Session.TakeRateChange().IsSet());
+		});
+
+		It("should hand out a restored rate change again", [this]() {
+			FVideoEncodeSession Session;
+			Session.SetRate(&PeerA, { 4000000, 60.0 });
+
+			TOptional<FVideoEncodeSession::FRate> const Taken = Session.TakeRateChange();
+			if (TestTrue("should", Taken.IsSet()))
+			{
+				Session.RestoreRateChange(*Taken);
+
+				TOptional<FVideoEncodeSession::FRate> const Retaken = Session.TakeRateChange();
+				TestTrue("should", Retaken.IsSet() && *Retaken == *Taken);
+			}
+		});
+
+		It("should keep the rate applied whoever seeds it afterwards", [this]() {
+			FVideoEncodeSession Session;
+			TestFalse("should", Session.GetAppliedRate().IsSet());
+
+			Session.SeedAppliedRate({ 5000000, 60.0 });
+			Session.SetRate(&PeerA, { 1000000, 30.0 });
+			Session.SetAppliedRate(*Session.TakeRateChange());
+
+			// A later subscriber's start rate must not replace what the encoder was settled on
+			Session.SeedAppliedRate({ 5000000, 60.0 });
+
+			TOptional<FVideoEncodeSession::FRate> const Applied = Session.GetAppliedRate();
+			TestTrue("should", Applied.IsSet() && Applied->Bitrate == 1000000);
+		});
+
+		It("should change when the slowest subscriber leaves", [this]() {
+			FVideoEncodeSession Session;
+			Session.SetRate(&PeerA, { 4000000, 60.0 });
+			Session.SetRate(&PeerB, { 1000000, 30.0 });
+			Session.TakeRateChange();
+
+			Session.Unsubscribe(&PeerB);
+
+			TOptional<FVideoEncodeSession::FRate> const Rate = Session.TakeRateChange();
+			TestTrue("should", Rate.IsSet() && Rate->Bitrate == 4000000);
+			TestEqual("should", Session.NumSubscribers(), 1);
+		});
+	});
+
+	Describe("Admission", [this]() {
+		It("should be left out unless given", [this]() {
+			FVideoEncodeSession Session;
+
+			TestTrue("should", Session.GetAdmission() == nullptr);
+		});
+
+		It("should count frames in flight for every subscriber together", [this]() {
+			FVideoEncodeSession Session(EVideoEncodeRatePolicy::Minimum, FVideoKeyframeArbiter(), MakeUnique<FVideoEncodeAdmission>(1));
+			FVideoEncodeAdmission* const Admission = Session.GetAdmission();
+			if (!TestNotNull("should", Admission))
+			{
+				return;
+			}
+
+			// PeerA's frame is still in the encoder when PeerB claims the next one, and there is room for only one between them
+			TestTrue("should", Admission->Admit(false, 1.0));
+			TestFalse("should", Admission->Admit(false, 1.0));
+
+			Admission->OnEncodeFinished(0.001);
+			TestTrue("should", Admission->Admit(false, 1.0));
+		});
+	});
+
+	Describe("Keyframe", [this]() {
+		It("should coalesce requests into one keyframe", [this]() {
+			FVideoEncodeSession Session;
+			Session.RequestKeyframe();
+			Session.RequestKeyframe();
+			Session.RequestKeyframe();
+
+			TestTrue("should", Session.IsKeyframeRequested());
+			TestTrue("should", Session.TakeKeyframeRequest() == EVideoKeyframeDecision::Keyframe);
+			TestTrue("should", Session.TakeKeyframeRequest() == EVideoKeyframeDecision::None);
+			TestEqual("should", Session.NumKeyframeRequests(), 3ull);
+			TestEqual("should", Session.NumKeyframesTaken(), 1ull);
+		});
+
+		It("should be taken by whoever encodes the next frame", [this]() {
+			FVideoEncodeSession Session;
+
+			TestTrue("should", Session.ClaimFrame(1));
+			Session.RequestKeyframe();
+
+			// Another subscriber asks for a keyframe on a frame already claimed, so it lands on the next one
+			TestFalse("should", Session.ClaimFrame(1));
+			TestTrue("should", Session.IsKeyframeRequested());
+
+			TestTrue("should", Session.ClaimFrame(2));
+			TestTrue("should", Session.TakeKeyframeRequest() == EVideoKeyframeDecision::Keyframe);
+		});
+
+		It("should send a late joiner inside the window a keyframe of its own", [this]() {
+			FVideoEncodeSession Session(EVideoEncodeRatePolicy::Minimum, FVideoKeyframeArbiter(60.0, 0.0));
+			Session.Subscribe(&PeerA);
+
+			Session.RequestKeyframe(&PeerA);
+			TestTrue("should", Session.TakeKeyframeRequest() == EVideoKeyframeDecision::Keyframe);
+			Session.OnKeyframeEncoded();
+
+			// Well inside the window, but PeerB was not there for the keyframe that just went out
+			Session.Subscribe(&PeerB);
+			Session.RequestKeyframe(&PeerB);
+			TestTrue("should", Session.TakeKeyframeRequest() == EVideoKeyframeDecision::Keyframe);
+
+			// Whereas PeerA was, so asking again inside the window gets nothing new
+			Session.OnKeyframeEncoded();
+			Session.RequestKeyframe(&PeerA);
+			TestTrue("should", Session.TakeKeyframeRequest() == EVideoKeyframeDecision::None);
+		});
+
+		It("should only answer with intra refresh subscribers that have had a keyframe", [this]() {
+			FVideoEncodeSession Session(EVideoEncodeRatePolicy::Minimum, FVideoKeyframeArbiter(0.0, 0.0, true));
+			Session.Subscribe(&PeerA);
+			Session.OnKeyframeEncoded();
+			Session.Subscribe(&PeerB);
+
+			Session.RequestKeyframe(&PeerA);
+			TestTrue("should", Session.TakeKeyframeRequest() == EVideoKeyframeDecision::IntraRefresh);
+
+			Session.RequestKeyframe(&PeerB);
+			TestTrue("should", Session.TakeKeyframeRequest() == EVideoKeyframeDecision::Keyframe);
+			TestEqual("should", Session.NumIntraRefreshesTaken(), 1ull);
+		});
+	});
+}
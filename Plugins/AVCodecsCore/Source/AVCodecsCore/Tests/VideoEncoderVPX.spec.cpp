@@ -0,0 +1,198 @@
+#include "Misc/AutomationTest.h"
+
+#include <AVDevice.h>
+#include <Video/Encoders/VideoEncoderVPX.h>
+
+DEFINE_SPEC(VideoEncoderVPXSpec, "AVCodecsCore.VideoEncoderVPX", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace VideoEncoderVPXSpecPrivate
+{
+	constexpr uint32 Width = 320;
+	constexpr uint32 Height = 240;
+	constexpr int32 NumFrames = 30;
+
+	// A gradient that moves each frame with some noise on top, so there is something for rate control to trade off
+	TSharedPtr<FVideoResourceCPU> MakeFrame(int32 FrameIndex, uint32 FrameWidth = Width, uint32 FrameHeight = Height)
+	{
+		uint32 const Stride = FrameWidth * 4;
+		TSharedPtr<uint8> Raw = MakeShareable(new uint8[Stride * FrameHeight], [](uint8* Data) { delete[] Data; });
+
+		uint32 Noise = 0x9E3779B9u * (FrameIndex + 1);
+		for (uint32 y = 0; y < FrameHeight; ++y)
+		{
+			for (uint32 x = 0; x < FrameWidth; ++x)
+			{
+				Noise = Noise * 1664525u + 1013904223u;
+
+				uint8* Pixel = Raw.Get() + y * Stride + x * 4;
+				Pixel[0] = (uint8)(x + FrameIndex * 4 + (Noise >> 28));
+				Pixel[1] = (uint8)(y + FrameIndex * 2 + (Noise >> 29));
+				Pixel[2] = (uint8)(x + y + (Noise >> 27));
+				Pixel[3] = 0xFF;
+			}
+		}
+
+		return MakeShared<FVideoResourceCPU>(
+			FAVDevice::GetSoftwareDevice(),
+			Raw,
+			FAVLayout(Stride, 0, Stride * FrameHeight),
+			FVideoDescriptor(EVideoFormat::BGRA, FrameWidth, FrameHeight));
+	}
+
+	FVideoEncoderConfigVPX MakeConfig(ERateControlMode RateControlMode, int32 TargetBitrate)
+	{
+		FVideoEncoderConfigVPX Config;
+		Config.Width = Width;
+		Config.Height = Height;
+		Config.TargetFramerate = 30;
+		Config.TargetBitrate = TargetBitrate;
+		Config.MaxBitrate = TargetBitrate * 2;
+		Config.RateControlMode = RateControlMode;
+
+		return Config;
+	}
+
+	TSharedPtr<TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>> MakeEncoder(FVideoEncoderConfigVPX const& Config)
+	{
+		return FVideoEncoder::Create<FVideoResourceCPU, FVideoEncoderConfigVPX>(FAVDevice::GetSoftwareDevice(), Config);
+	}
+
+	// Total encoded size of NumFrames frames, with every packet appended to OutPackets
+	uint64 EncodeFrames(TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>& Encoder, TArray<FVideoPacket>& OutPackets, TFunction<bool(int32)> ShouldForceKeyframe = nullptr)
+	{
+		uint64 TotalSize = 0;
+		for (int32 i = 0; i < NumFrames; ++i)
+		{
+			Encoder.SendFrame(MakeFrame(i), i, ShouldForceKeyframe && ShouldForceKeyframe(i));
+
+			FVideoPacket Packet;
+			while (Encoder.ReceivePacket(Packet).IsSuccess())
+			{
+				TotalSize += Packet.DataSize;
+				OutPackets.Add(Packet);
+			}
+		}
+
+		return TotalSize;
+	}
+} // namespace VideoEncoderVPXSpecPrivate
+
+void VideoEncoderVPXSpec::Define()
+{
+	using namespace VideoEncoderVPXSpecPrivate;
+
+	Describe("Factory", [this]() {
+		It("should create a software encoder for CPU frames", [this]() {
+			TestTrue("should", FVideoEncoder::IsSupported<FVideoResourceCPU, FVideoEncoderConfigVPX>());
+			TestTrue("should", MakeEncoder(MakeConfig(ERateControlMode::CBR, 500000)).IsValid());
+		});
+	});
+
+	Describe("Keyframes", [this]() {
+		It("should start with a keyframe and follow with delta frames", [this]() {
+			TSharedPtr<TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>> Encoder = MakeEncoder(MakeConfig(ERateControlMode::CBR, 500000));
+			if (TestTrue("should", Encoder.IsValid()))
+			{
+				TArray<FVideoPacket> Packets;
+				EncodeFrames(*Encoder, Packets);
+
+				if (TestEqual("should", Packets.Num(), NumFrames))
+				{
+					TestTrue("should", Packets[0].bIsKeyframe != 0);
+
+					int32 NumKeyframes = 0;
+					for (FVideoPacket const& Packet : Packets)
+					{
+						NumKeyframes += Packet.bIsKeyframe ? 1 : 0;
+					}
+
+					TestEqual("should", NumKeyframes, 1);
+				}
+			}
+		});
+
+		It("should encode a keyframe when one is forced", [this]() {
+			TSharedPtr<TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>> Encoder = MakeEncoder(MakeConfig(ERateControlMode::CBR, 500000));
+			if (TestTrue("should", Encoder.IsValid()))
+			{
+				TArray<FVideoPacket> Packets;
+				EncodeFrames(*Encoder, Packets, [](int32 FrameIndex) { return FrameIndex == 10; });
+
+				if (TestEqual("should", Packets.Num(), NumFrames))
+				{
+					TestTrue("should", Packets[10].bIsKeyframe != 0);
+					TestTrue("should", Packets[11].bIsKeyframe == 0);
+				}
+			}
+		});
+	});
+
+	Describe("RateControl", [this]() {
+		It("should spend more bits when given a higher CBR target", [this]() {
+			TArray<FVideoPacket> Packets;
+
+			TSharedPtr<TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>> Low = MakeEncoder(MakeConfig(ERateControlMode::CBR, 100000));
+			TSharedPtr<TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>> High = MakeEncoder(MakeConfig(ERateControlMode::CBR, 2000000));
+			if (TestTrue("should", Low.IsValid() && High.IsValid()))
+			{
+				TestTrue("should", EncodeFrames(*High, Packets) > EncodeFrames(*Low, Packets));
+			}
+		});
+
+		It("should spend more bits at a lower constant QP", [this]() {
+			TArray<FVideoPacket> Packets;
+
+			FVideoEncoderConfigVPX Coarse = MakeConfig(ERateControlMode::ConstQP, 0);
+			Coarse.MinQP = Coarse.MaxQP = 45;
+
+			FVideoEncoderConfigVPX Fine = MakeConfig(ERateControlMode::ConstQP, 0);
+			Fine.MinQP = Fine.MaxQP = 10;
+
+			TSharedPtr<TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>> CoarseEncoder = MakeEncoder(Coarse);
+			TSharedPtr<TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>> FineEncoder = MakeEncoder(Fine);
+			if (TestTrue("should", CoarseEncoder.IsValid() && FineEncoder.IsValid()))
+			{
+				TestTrue("should", EncodeFrames(*FineEncoder, Packets) > EncodeFrames(*CoarseEncoder, Packets));
+			}
+		});
+
+		It("should follow the size of the frames it is sent", [this]() {
+			TSharedPtr<TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>> Encoder = MakeEncoder(MakeConfig(ERateControlMode::CBR, 500000));
+			if (TestTrue("should", Encoder.IsValid()))
+			{
+				TestTrue("should", Encoder->SendFrame(MakeFrame(0, 160, 120), 0).IsSuccess());
+				TestEqual("should", Encoder->GetAppliedConfig().Width, 160u);
+				TestEqual("should", Encoder->GetAppliedConfig().Height, 120u);
+
+				FVideoPacket Packet;
+				TestTrue("should", Encoder->ReceivePacket(Packet).IsSuccess() && Packet.bIsKeyframe);
+			}
+		});
+	});
+
+	Describe("Metadata", [this]() {
+		It("should carry microsecond timestamps and user data through to its packets", [this]() {
+			TSharedPtr<TVideoEncoder<FVideoResourceCPU, FVideoEncoderConfigVPX>> Encoder = MakeEncoder(MakeConfig(ERateControlMode::CBR, 500000));
+			if (TestTrue("should", Encoder.IsValid()))
+			{
+				// Well past where a 32 bit millisecond timestamp would have wrapped
+				uint64 const StartTimestamp = 0x1234567890ull;
+
+				for (int32 i = 0; i < 4; ++i)
+				{
+					uint64 const Timestamp = StartTimestamp + i * 33333;
+					uint64 const UserData = 0xC0FFEE0000000000ull | i;
+
+					Encoder->SendFrame(MakeFrame(i), Timestamp, false, UserData);
+
+					FVideoPacket Packet;
+					if (TestTrue("should", Encoder->ReceivePacket(Packet).IsSuccess()))
+					{
+						TestEqual("should", Packet.Timestamp, Timestamp);
+						TestEqual("should", Packet.UserData, UserData);
+					}
+				}
+			}
+		});
+	});
+}
@@ -0,0 +1,202 @@
+#include "Misc/AutomationTest.h"
+
+#include <Video/Encoders/VideoKeyframeArbiter.h>
+
+DEFINE_SPEC(VideoKeyframeArbiterSpec, "AVCodecsCore.VideoKeyframeArbiter", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace VideoKeyframeArbiterSpecPrivate
+{
+	constexpr double FrameInterval = 1.0 / 60.0;
+
+	constexpr double CoalesceWindow = 0.1;
+	constexpr double MinKeyframeSpacing = 0.5;
+
+	struct FRunResult
+	{
+		int32 NumKeyframes = 0;
+		int32 NumIntraRefreshes = 0;
+		double MinKeyframeSpacing = TNumericLimits<double>::Max();
+	};
+
+	/*
+	 * Encode NumFrames frames at 60fps, with RequestsPerFrame(Frame) keyframe requests arriving just before each one.
+	 * Time is synthetic, so the outcome is the same on every run.
+	 */
+	template <typename FRequestsFunc>
+	FRunResult Run(FVideoKeyframeArbiter& Arbiter, int32 NumFrames, FRequestsFunc&& RequestsPerFrame)
+	{
+		FRunResult Result;
+		TOptional<double> LastKeyframeTime;
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			double const Now = Frame * FrameInterval;
+
+			int32 const NumRequests = RequestsPerFrame(Frame);
+			for (int32 i = 0; i < NumRequests; ++i)
+			{
+				Arbiter.Request(Now - FrameInterval * 0.5 + i * 0.0001);
+			}
+
+			switch (Arbiter.Decide(Now))
+			{
+				case EVideoKeyframeDecision::Keyframe:
+					if (LastKeyframeTime.IsSet())
+					{
+						Result.MinKeyframeSpacing = FMath::Min(Result.MinKeyframeSpacing, Now - *LastKeyframeTime);
+					}
+
+					LastKeyframeTime = Now;
+					Result.NumKeyframes++;
+					break;
+				case EVideoKeyframeDecision::IntraRefresh:
+					Result.NumIntraRefreshes++;
+					break;
+				default:
+					break;
+			}
+		}
+
+		return Result;
+	}
+} // namespace VideoKeyframeArbiterSpecPrivate
+
+void VideoKeyframeArbiterSpec::Define()
+{
+	using namespace VideoKeyframeArbiterSpecPrivate;
+
+	Describe("Decide", [this]() {
+		It("should answer nothing when nothing was requested", [this]() {
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing);
+
+			TestTrue("should", Arbiter.Decide(0.0) == EVideoKeyframeDecision::None);
+		});
+
+		It("should answer the first request straight away", [this]() {
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing);
+			Arbiter.Request(0.0);
+
+			TestTrue("should", Arbiter.Decide(0.0) == EVideoKeyframeDecision::Keyframe);
+			TestTrue("should", Arbiter.Decide(FrameInterval) == EVideoKeyframeDecision::None);
+		});
+
+		It("should take requests just after a keyframe to be answered by it", [this]() {
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing);
+			Arbiter.Request(0.0);
+			Arbiter.Decide(0.0);
+
+			Arbiter.Request(CoalesceWindow * 0.5);
+
+			TestFalse("should", Arbiter.HasPendingRequest());
+			TestEqual("should", Arbiter.NumCoalesced(), 1ull);
+		});
+
+		It("should answer a late joiner inside the window with another keyframe", [this]() {
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, 0.0);
+			Arbiter.Request(0.0, true);
+			Arbiter.Decide(0.0);
+
+			// Started receiving after that keyframe went out, so it has nothing to decode from however recent it was
+			Arbiter.Request(CoalesceWindow * 0.5, true, true);
+
+			TestTrue("should", Arbiter.HasPendingRequest());
+			TestEqual("should", Arbiter.NumCoalesced(), 0ull);
+			TestTrue("should", Arbiter.Decide(CoalesceWindow * 0.5) == EVideoKeyframeDecision::Keyframe);
+		});
+
+		It("should hold requests until another keyframe is allowed", [this]() {
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing);
+			Arbiter.Request(0.0);
+			Arbiter.Decide(0.0);
+
+			Arbiter.Request(0.2);
+			Arbiter.Request(0.3);
+
+			TestTrue("should", Arbiter.Decide(0.3) == EVideoKeyframeDecision::None);
+			TestTrue("should", Arbiter.HasPendingRequest());
+			TestTrue("should", Arbiter.Decide(MinKeyframeSpacing) == EVideoKeyframeDecision::Keyframe);
+			TestEqual("should", Arbiter.NumKeyframes(), 2ull);
+		});
+
+		It("should count keyframes the encoder produced itself towards spacing", [this]() {
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing);
+			Arbiter.OnKeyframe(0.0);
+
+			Arbiter.Request(0.2);
+
+			TestTrue("should", Arbiter.Decide(0.2) == EVideoKeyframeDecision::None);
+			TestTrue("should", Arbiter.Decide(MinKeyframeSpacing) == EVideoKeyframeDecision::Keyframe);
+		});
+	});
+
+	Describe("IntraRefresh", [this]() {
+		It("should start the stream with a full keyframe", [this]() {
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing, true);
+			Arbiter.Request(0.0);
+
+			TestTrue("should", Arbiter.Decide(0.0) == EVideoKeyframeDecision::Keyframe);
+		});
+
+		It("should prefer intra refresh once the stream has started", [this]() {
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing, true);
+			Arbiter.OnKeyframe(0.0);
+
+			Arbiter.Request(0.2);
+
+			TestTrue("should", Arbiter.Decide(0.2) == EVideoKeyframeDecision::IntraRefresh);
+			TestEqual("should", Arbiter.NumKeyframes(), 0ull);
+		});
+
+		It("should still send a full keyframe to whoever needs one", [this]() {
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing, true);
+			Arbiter.OnKeyframe(0.0);
+			Arbiter.Request(0.2);
+			Arbiter.Decide(0.2);
+
+			// Intra refresh does not answer a full request, however soon after it comes
+			Arbiter.Request(0.25, true);
+
+			TestTrue("should", Arbiter.HasPendingRequest());
+			TestTrue("should", Arbiter.Decide(MinKeyframeSpacing) == EVideoKeyframeDecision::Keyframe);
+		});
+	});
+
+	Describe("Burst", [this]() {
+		It("should turn a storm of requests into few, well spaced keyframes", [this]() {
+			constexpr int32 NumFrames = 330;
+
+			// A dozen players joining every other frame for the first second, then one lossy player asking every ten frames for four seconds
+			auto const Requests = [](int32 Frame) {
+				return Frame < 60 ? (Frame % 2 == 0 ? 12 : 0) : (Frame % 10 == 0 && Frame < 300 ? 1 : 0);
+			};
+
+			FVideoKeyframeArbiter Unarbitrated;
+			FRunResult const Before = Run(Unarbitrated, NumFrames, Requests);
+
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing);
+			FRunResult const After = Run(Arbiter, NumFrames, Requests);
+
+			AddInfo(FString::Printf(TEXT("%d keyframes without arbitration, %d with it from %llu requests"), Before.NumKeyframes, After.NumKeyframes, Arbiter.NumRequests()));
+
+			TestEqual("should", Before.NumKeyframes, 54);
+			TestEqual("should", After.NumKeyframes, 11);
+			TestTrue("should", After.MinKeyframeSpacing >= MinKeyframeSpacing - UE_KINDA_SMALL_NUMBER);
+			TestFalse("should", Arbiter.HasPendingRequest());
+		});
+
+		It("should answer a storm with intra refresh when it can", [this]() {
+			constexpr int32 NumFrames = 120;
+
+			auto const Requests = [](int32 Frame) {
+				return Frame % 3 == 0 ? 4 : 0;
+			};
+
+			FVideoKeyframeArbiter Arbiter(CoalesceWindow, MinKeyframeSpacing, true);
+			FRunResult const Result = Run(Arbiter, NumFrames, Requests);
+
+			TestEqual("should", Result.NumKeyframes, 1);
+			TestTrue("should", Result.NumIntraRefreshes > 0);
+			TestTrue("should", Result.NumIntraRefreshes < NumFrames / 3);
+		});
+	});
+}
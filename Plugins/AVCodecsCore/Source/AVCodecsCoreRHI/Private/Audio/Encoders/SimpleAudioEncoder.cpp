@@ -5,35 +5,10 @@
 #include "Audio/Encoders/Configs/AudioEncoderConfigAAC.h"
 #include "Audio/Resources/AudioResourceCPU.h"
 
-#include "HAL/RunnableThread.h"
-
-uint32 USimpleAudioEncoder::Run()
-{
-	while (IsOpen() && IsAsync())
-	{
-		FAsyncFrame Frame;
-		if (AsyncQueue.Dequeue(Frame))
-		{
-			this->Child->SendFrame(Frame.Resource, Frame.Timestamp);
-
-			AsyncPool.Enqueue(Frame.Resource);
-		}
-	}
-
-	return 0;
-}
-
-void USimpleAudioEncoder::Exit()
-{
-	AsyncThread = nullptr;
-
-	AsyncQueue.Empty();
-	AsyncPool.Empty();
-}
 
 bool USimpleAudioEncoder::IsAsync() const
 {
-	return AsyncThread != nullptr;
+	return AsyncWorker.IsValid();
 }
 
 bool USimpleAudioEncoder::IsOpen() const
@@ -63,7 +38,16 @@ bool USimpleAudioEncoder::Open(ESimpleAudioCodec Codec, FSimpleAudioEncoderConfi
 
 	if (IsOpen() && bAsynchronous && FPlatformProcess::SupportsMultithreading())
 	{
-		AsyncThread = FRunnableThread::Create(this, TEXT("Simple Audio"));
+		AsyncWorker = MakeUnique<UE::AVCodecCore::FAsyncWorker>(TEXT("Simple Audio"), AsyncQueueDepth, USimpleAVHelper::ConvertQueuePolicy(AsyncQueuePolicy));
+		if (AsyncWorker->IsRunning())
+		{
+			// One being filled, one being encoded and a full queue between them
+			AsyncPool = MakeUnique<UE::AVCodecCore::TResourcePool<FAudioResourceCPU, FAudioDescriptor>>(AsyncWorker->GetMaxQueued() + 2);
+		}
+		else
+		{
+			AsyncWorker.Reset();
+		}
 	}
 
 	return IsOpen();
@@ -73,16 +57,12 @@ void USimpleAudioEncoder::Close()
 {
 	if (IsOpen())
 	{
-		if (AsyncThread != nullptr)
-		{
-			AsyncThread->Kill();
-			AsyncThread = nullptr;
-		}
+		// Sends whatever is still queued and waits for the thread, so nothing touches the child once it is gone
+		AsyncWorker.Reset();
 
 		Child.Reset();
 
-		AsyncQueue.Empty();
-		AsyncPool.Empty();
+		AsyncPool.Reset();
 	}
 }
 
@@ -128,32 +108,23 @@ bool USimpleAudioEncoder::SendFrame(float const* ResourceData, double Timestamp,
 	
 	if (IsAsync())
 	{
-		TSharedPtr<FAudioResourceCPU> ResourceCPU = nullptr;
-		while (!ResourceCPU.IsValid() && AsyncPool.Dequeue(ResourceCPU))
-		{
-			if (ResourceCPU->GetLayout() != ResourceLayout || ResourceCPU->GetDescriptor() != ResourceDescriptor)
-			{
-				ResourceCPU.Reset();
-			}
-		}
-
-		if (!ResourceCPU.IsValid())
-		{
-			ResourceCPU = MakeShared<FAudioResourceCPU>(
+		// The layout follows from the descriptor, so matching the descriptor is enough
+		TSharedPtr<FAudioResourceCPU> const ResourceCPU = AsyncPool->AcquireOrCreate(ResourceDescriptor, [this, &ResourceLayout, &ResourceDescriptor]() {
+			return MakeShared<FAudioResourceCPU>(
 				Child->GetDevice().ToSharedRef(),
 				MakeShareable(new float[ResourceLayout.Size]),
 				ResourceLayout,
 				ResourceDescriptor);
-		}
+		});
 
 		FMemory::Memcpy(ResourceCPU->GetRaw().Get(), ResourceData, ResourceLayout.Size);
 
-		AsyncQueue.Enqueue(
-			FAsyncFrame(
-				ResourceCPU,
-				Timestamp * 1000));
+		// A frame dropped to make room takes its resource with it, the pool simply allocates another when it runs dry
+		return AsyncWorker->Enqueue([this, ResourceCPU, EncodeTimestamp = uint32(Timestamp * 1000)]() {
+			Child->SendFrame(ResourceCPU, EncodeTimestamp);
 
-		return true;
+			AsyncPool->Release(ResourceCPU);
+		});
 	}
 	else
 	{
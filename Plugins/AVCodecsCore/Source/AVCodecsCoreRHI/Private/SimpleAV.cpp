@@ -18,3 +18,14 @@ EAVPreset USimpleAVHelper::ConvertPreset(ESimpleAVPreset From)
 		return EAVPreset::Default;
 	}
 }
+
+UE::AVCodecCore::EAsyncWorkerOverflow USimpleAVHelper::ConvertQueuePolicy(ESimpleAVQueuePolicy From)
+{
+	switch (From)
+	{
+	case ESimpleAVQueuePolicy::DropOldest:
+		return UE::AVCodecCore::EAsyncWorkerOverflow::DropOldest;
+	default:
+		return UE::AVCodecCore::EAsyncWorkerOverflow::Block;
+	}
+}
@@ -6,40 +6,53 @@
 #include "Engine/Texture2D.h"
 #include "TextureResource.h"
 #include "RHI.h"
-#include "HAL/RunnableThread.h"
 
 #include "Video/Encoders/Configs/VideoEncoderConfigH264.h"
 #include "Video/Encoders/Configs/VideoEncoderConfigH265.h"
 #include "Video/Resources/VideoResourceRHI.h"
 
-
-uint32 USimpleVideoEncoder::Run()
+namespace SimpleVideoEncoderPrivate
 {
-	while (IsOpen() && IsAsync())
+	// Travels with a queued frame that asked for a keyframe, and hands the request on if the frame is dropped before it is encoded
+	class FKeyframeRequest
 	{
-		FAsyncFrame Frame;
-		if (AsyncQueue.Dequeue(Frame))
+	public:
+		FKeyframeRequest(std::atomic<bool>* InCarried)
+			: Carried(InCarried)
 		{
-			this->Child->SendFrame(Frame.Resource, Frame.Timestamp, Frame.bForceKeyframe);
+		}
 
-			AsyncPool.Enqueue(Frame.Resource);
+		FKeyframeRequest(FKeyframeRequest&& Other)
+			: Carried(Other.Carried)
+		{
+			Other.Carried = nullptr;
 		}
-	}
 
-	return 0;
-}
+		~FKeyframeRequest()
+		{
+			if (Carried != nullptr)
+			{
+				Carried->store(true);
+			}
+		}
 
-void USimpleVideoEncoder::Exit()
-{
-	AsyncThread = nullptr;
+		// The frame is being encoded, so it answers the request itself
+		bool Consume()
+		{
+			std::atomic<bool>* const Consumed = Carried;
+			Carried = nullptr;
 
-	AsyncQueue.Empty();
-	AsyncPool.Empty();
-}
+			return Consumed != nullptr;
+		}
+
+	private:
+		std::atomic<bool>* Carried;
+	};
+} // namespace SimpleVideoEncoderPrivate
 
 bool USimpleVideoEncoder::IsAsync() const
 {
-	return AsyncThread != nullptr;
+	return AsyncWorker.IsValid();
 }
 
 bool USimpleVideoEncoder::IsOpen() const
@@ -78,7 +91,16 @@ bool USimpleVideoEncoder::Open(ESimpleVideoCodec Codec, FSimpleVideoEncoderConfi
 
 	if (IsOpen() && bAsynchronous && FPlatformProcess::SupportsMultithreading())
 	{
-		AsyncThread = FRunnableThread::Create(this, TEXT("Simple Video"));
+		AsyncWorker = MakeUnique<UE::AVCodecCore::FAsyncWorker>(TEXT("Simple Video"), AsyncQueueDepth, USimpleAVHelper::ConvertQueuePolicy(AsyncQueuePolicy));
+		if (AsyncWorker->IsRunning())
+		{
+			// One being filled, one being encoded and a full queue between them
+			AsyncPool = MakeUnique<UE::AVCodecCore::TResourcePool<FVideoResourceRHI, FVideoDescriptor>>(AsyncWorker->GetMaxQueued() + 2);
+		}
+		else
+		{
+			AsyncWorker.Reset();
+		}
 	}
 
 	return IsOpen();
@@ -88,16 +110,13 @@ void USimpleVideoEncoder::Close()
 {
 	if (IsOpen())
 	{
-		if (AsyncThread != nullptr)
-		{
-			AsyncThread->Kill();
-			AsyncThread = nullptr;
-		}
+		// Sends whatever is still queued and waits for the thread, so nothing touches the child once it is gone
+		AsyncWorker.Reset();
+		bKeyframeCarried = false;
 
 		Child.Reset();
 
-		AsyncQueue.Empty();
-		AsyncPool.Empty();
+		AsyncPool.Reset();
 	}
 }
 
@@ -142,28 +161,26 @@ bool USimpleVideoEncoder::SendFrame(FTextureRHIRef const& Resource, double Times
 
 	if (IsAsync())
 	{
-		FAVLayout const ResourceLayout = FVideoResourceRHI::GetLayoutFrom(Child->GetDevice().ToSharedRef(), Resource);
 		FVideoDescriptor const ResourceDescriptor = FVideoResourceRHI::GetDescriptorFrom(Child->GetDevice().ToSharedRef(), Resource);
 
-		TSharedPtr<FVideoResourceRHI> ResourceRHI = nullptr;
-		while (!ResourceRHI.IsValid() && AsyncPool.Dequeue(ResourceRHI))
-		{
-			if (ResourceRHI->GetLayout() != ResourceLayout || ResourceRHI->GetDescriptor() != ResourceDescriptor)
-			{
-				ResourceRHI.Reset();
-			}
-		}
-
-		if (!ResourceRHI.IsValid())
-		{
-			ResourceRHI = FVideoResourceRHI::Create(Child->GetDevice().ToSharedRef(), ResourceDescriptor);
-		}
+		// Pooled resources are all created from a descriptor alone, so their layout always matches too
+		TSharedPtr<FVideoResourceRHI> const ResourceRHI = AsyncPool->AcquireOrCreate(ResourceDescriptor, [this, &ResourceDescriptor]() {
+			return FVideoResourceRHI::Create(Child->GetDevice().ToSharedRef(), ResourceDescriptor);
+		});
 
 		ResourceRHI->CopyFrom(Resource);
 
-		AsyncQueue.Enqueue(FAsyncFrame(ResourceRHI, Timestamp * 1000, bForceKeyframe));
+		// A frame dropped to make room takes its resource with it, the pool simply allocates another when it runs dry.
+		// Its keyframe request does not go with it, the next frame to be encoded picks that up instead.
+		SimpleVideoEncoderPrivate::FKeyframeRequest KeyframeRequest(bForceKeyframe ? &bKeyframeCarried : nullptr);
+
+		return AsyncWorker->Enqueue([this, ResourceRHI, EncodeTimestamp = uint64(Timestamp * 1000000), KeyframeRequest = MoveTemp(KeyframeRequest)]() mutable {
+			bool const bKeyframe = KeyframeRequest.Consume() | bKeyframeCarried.exchange(false);
+
+			Child->SendFrame(ResourceRHI, EncodeTimestamp, bKeyframe);
 
-		return true;
+			AsyncPool->Release(ResourceRHI);
+		});
 	}
 	else
 	{
@@ -172,7 +189,7 @@ bool USimpleVideoEncoder::SendFrame(FTextureRHIRef const& Resource, double Times
 			Child->GetDevice().ToSharedRef(),
 			FVideoResourceRHI::FRawData{ Resource, nullptr, 0 });
 
-		return this->Child->SendFrame(ResourceRHI, Timestamp * 1000, bForceKeyframe);
+		return this->Child->SendFrame(ResourceRHI, uint64(Timestamp * 1000000), bForceKeyframe);
 	}
 }
 
@@ -139,23 +139,23 @@ TSharedPtr<FVideoResourceRHI> FVideoResourceRHI::Create(TSharedPtr<FAVDevice> co
 		case EVideoFormat::NV12:
 			TextureDesc.Format = EPixelFormat::PF_R8;
 			TextureDesc.Extent.Y *= 1.5;
-			Descriptor.RawDescriptor = new FVideoDescriptor(EVideoFormat::R8, TextureDesc.Extent.X, TextureDesc.Extent.Y);
+			Descriptor.RawDescriptor = FVideoDescriptor::Intern(FVideoDescriptor(EVideoFormat::R8, TextureDesc.Extent.X, TextureDesc.Extent.Y));
 			break;
 		case EVideoFormat::P010:
 			TextureDesc.Format = EPixelFormat::PF_G16;
 			TextureDesc.Extent.Y *= 1.5;
-			Descriptor.RawDescriptor = new FVideoDescriptor(EVideoFormat::G16, TextureDesc.Extent.X, TextureDesc.Extent.Y);
+			Descriptor.RawDescriptor = FVideoDescriptor::Intern(FVideoDescriptor(EVideoFormat::G16, TextureDesc.Extent.X, TextureDesc.Extent.Y));
 			break;
 		// 444 sampled planar so: 1 x Y for every sample, 1 x U for every sample, 1 x V for every sample = 3x X axis
 		case EVideoFormat::YUV444:
 			TextureDesc.Format = EPixelFormat::PF_R8;
 			TextureDesc.Extent.X *= 3;
-			Descriptor.RawDescriptor = new FVideoDescriptor(EVideoFormat::R8, TextureDesc.Extent.X, TextureDesc.Extent.Y);
+			Descriptor.RawDescriptor = FVideoDescriptor::Intern(FVideoDescriptor(EVideoFormat::R8, TextureDesc.Extent.X, TextureDesc.Extent.Y));
 			break;
 		case EVideoFormat::YUV444_16:
 			TextureDesc.Format = EPixelFormat::PF_G16;
 			TextureDesc.Extent.X *= 3;
-			Descriptor.RawDescriptor = new FVideoDescriptor(EVideoFormat::G16, TextureDesc.Extent.X, TextureDesc.Extent.Y);
+			Descriptor.RawDescriptor = FVideoDescriptor::Intern(FVideoDescriptor(EVideoFormat::G16, TextureDesc.Extent.X, TextureDesc.Extent.Y));
 			break;
 		default:
 			break;
@@ -9,7 +9,8 @@
 
 #include "CoreMinimal.h"
 #include "Containers/Queue.h"
-#include "HAL/Runnable.h"
+#include "Utils/AsyncWorker.h"
+#include "Utils/ResourcePool.h"
 
 #include "SimpleAudioEncoder.generated.h"
 
@@ -52,34 +53,27 @@ public:
 };
 
 UCLASS(Blueprintable)
-class AVCODECSCORERHI_API USimpleAudioEncoder : public UObject, public FRunnable
+class AVCODECSCORERHI_API USimpleAudioEncoder : public UObject
 {
 	GENERATED_BODY()
 
 private:
 	TSharedPtr<TAudioEncoder<class FAudioResourceCPU>> Child;
 
-	struct FAsyncFrame
-	{
-		TSharedPtr<FAudioResourceCPU> Resource;
-		uint32 Timestamp;
-
-		FAsyncFrame() = default;
-		FAsyncFrame(TSharedPtr<FAudioResourceCPU> const& Resource, uint32 Timestamp)
-			: Resource(Resource)
-			, Timestamp(Timestamp)
-		{
-		}
-	};
+	// Sends frames to the child encoder when opened asynchronously, and hands their resources back to the pool once done
+	TUniquePtr<UE::AVCodecCore::FAsyncWorker> AsyncWorker;
+	// Resources free to copy the next frame into, sized on open to cover every frame the worker can hold
+	TUniquePtr<UE::AVCodecCore::TResourcePool<FAudioResourceCPU, FAudioDescriptor>> AsyncPool;
 
-	FRunnableThread* AsyncThread = nullptr;
-	TQueue<FAsyncFrame> AsyncQueue;
-	TQueue<TSharedPtr<FAudioResourceCPU>> AsyncPool;
+public:
+	// Frames that may wait for the asynchronous encoder before AsyncQueuePolicy applies, read when the encoder is opened
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
+	int32 AsyncQueueDepth = 8;
 
-	virtual uint32 Run() override;
-	virtual void Exit() override;
+	// What sending a frame does when AsyncQueueDepth frames are already waiting, read when the encoder is opened
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
+	ESimpleAVQueuePolicy AsyncQueuePolicy = ESimpleAVQueuePolicy::Block;
 
-public:
 	UFUNCTION(BlueprintCallable, Category = "Audio")
 	bool IsAsync() const;
 
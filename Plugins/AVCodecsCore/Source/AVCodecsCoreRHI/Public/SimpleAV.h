@@ -3,6 +3,7 @@
 #pragma once
 
 #include "AVConfig.h"
+#include "Utils/AsyncWorker.h"
 
 #include "SimpleAV.generated.h"
 
@@ -17,6 +18,16 @@ enum class ESimpleAVPreset : uint8
 	Lossless,
 };
 
+UENUM(BlueprintType)
+enum class ESimpleAVQueuePolicy : uint8
+{
+	// Wait for the encoder to catch up, nothing is lost but sending can stall
+	Block,
+
+	// Throw away the oldest frame still waiting, so a live source never falls behind
+	DropOldest,
+};
+
 UCLASS(Abstract)
 class AVCODECSCORERHI_API USimpleAVHelper : public UObject
 {
@@ -24,4 +35,5 @@ class AVCODECSCORERHI_API USimpleAVHelper : public UObject
 
 public:
 	static EAVPreset ConvertPreset(ESimpleAVPreset From);
+	static UE::AVCodecCore::EAsyncWorkerOverflow ConvertQueuePolicy(ESimpleAVQueuePolicy From);
 };
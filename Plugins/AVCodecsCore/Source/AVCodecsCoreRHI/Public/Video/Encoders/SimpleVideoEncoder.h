@@ -7,10 +7,13 @@
 
 #include "CoreMinimal.h"
 #include "Containers/Queue.h"
-#include "HAL/Runnable.h"
+#include "Utils/AsyncWorker.h"
+#include "Utils/ResourcePool.h"
 #include "HAL/Platform.h"
 #include "RHIFwd.h"
 
+#include <atomic>
+
 #include "SimpleVideoEncoder.generated.h"
 
 USTRUCT(BlueprintType)
@@ -62,36 +65,29 @@ public:
 };
 
 UCLASS(Blueprintable)
-class AVCODECSCORERHI_API USimpleVideoEncoder : public UObject, public FRunnable
+class AVCODECSCORERHI_API USimpleVideoEncoder : public UObject
 {
 	GENERATED_BODY()
 
 private:
 	TSharedPtr<TVideoEncoder<class FVideoResourceRHI>> Child;
 
-	struct FAsyncFrame
-	{
-		TSharedPtr<FVideoResourceRHI> Resource;
-		uint32 Timestamp;
-		bool bForceKeyframe;
-
-		FAsyncFrame() = default;
-		FAsyncFrame(TSharedPtr<FVideoResourceRHI> const& Resource, uint32 Timestamp, bool bForceKeyframe)
-			: Resource(Resource)
-			, Timestamp(Timestamp)
-			, bForceKeyframe(bForceKeyframe)
-		{
-		}
-	};
-
-	FRunnableThread* AsyncThread = nullptr;
-	TQueue<FAsyncFrame> AsyncQueue;
-	TQueue<TSharedPtr<FVideoResourceRHI>> AsyncPool;
-
-	virtual uint32 Run() override;
-	virtual void Exit() override;
+	// Sends frames to the child encoder when opened asynchronously, and hands their resources back to the pool once done
+	TUniquePtr<UE::AVCodecCore::FAsyncWorker> AsyncWorker;
+	// Resources free to copy the next frame into, sized on open to cover every frame the worker can hold
+	TUniquePtr<UE::AVCodecCore::TResourcePool<FVideoResourceRHI, FVideoDescriptor>> AsyncPool;
+	// Set when a frame that asked for a keyframe is dropped from the async queue, so the next frame to be encoded asks for it instead
+	std::atomic<bool> bKeyframeCarried = false;
 
 public:
+	// Frames that may wait for the asynchronous encoder before AsyncQueuePolicy applies, read when the encoder is opened
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video")
+	int32 AsyncQueueDepth = 4;
+
+	// What sending a frame does when AsyncQueueDepth frames are already waiting, read when the encoder is opened
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video")
+	ESimpleAVQueuePolicy AsyncQueuePolicy = ESimpleAVQueuePolicy::Block;
+
 	UFUNCTION(BlueprintCallable, Category = "Video")
 	bool IsAsync() const;
 
@@ -96,7 +96,7 @@ public:
 		return EAVResult::Success;
 	}
 
-	virtual FAVResult SendFrame(TSharedPtr<FVideoResourceRHI> const& Resource, uint32 Timestamp, bool bForceKeyframe) override
+	virtual FAVResult SendFrame(TSharedPtr<FVideoResourceRHI> const& Resource, uint64 Timestamp, bool bForceKeyframe = false, uint64 UserData = 0) override
 	{
 		if (!this->IsOpen())
 		{
@@ -109,7 +109,7 @@ public:
 			return Result;
 		}
 
-		return Child->SendFrame(Resource, Timestamp, bForceKeyframe);
+		return Child->SendFrame(Resource, Timestamp, bForceKeyframe, UserData);
 	}
 
 	virtual FAVResult ReceivePacket(FVideoPacket& OutPacket) override
@@ -121,4 +121,14 @@ public:
 
 		return Child->ReceivePacket(OutPacket);
 	}
+
+	virtual FAVResult WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime) override
+	{
+		if (!this->IsOpen())
+		{
+			return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"), TEXT("RHI"));
+		}
+
+		return Child->WaitForPacket(OutPacket, WaitTime);
+	}
 };
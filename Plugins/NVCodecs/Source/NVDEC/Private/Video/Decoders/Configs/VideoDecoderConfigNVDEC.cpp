@@ -30,10 +30,10 @@ FAVResult FVideoDecoderConfigNVDEC::Parse(TSharedRef<FAVInstance> const& Instanc
 					CUVIDH264PICPARAMS& OutPictureH264 = OutPicture.CodecSpecific.h264;
 
 					// PPS
-					if (PPS_t const* const PPS = H264.PPS.Find(Slice.pic_parameter_set_id))
+					if (PPS_t const* const PPS = H264.ParserState.FindPPS(Slice))
 					{
 						// SPS
-						if (SPS_t const* const SPS = H264.SPS.Find(PPS->seq_parameter_set_id))
+						if (SPS_t const* const SPS = H264.ParserState.FindSPS(PPS->seq_parameter_set_id))
 						{
 							OutPicture.DecodeCreateInfo.ulWidth = OutPicture.DecodeCreateInfo.ulTargetWidth = (SPS->pic_width_in_mbs_minus1 + 1) * 16;
 							OutPicture.DecodeCreateInfo.ulHeight = OutPicture.DecodeCreateInfo.ulTargetHeight = (SPS->pic_height_in_map_units_minus1 + 1) * 16;
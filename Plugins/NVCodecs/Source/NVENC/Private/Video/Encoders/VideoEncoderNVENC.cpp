@@ -2,6 +2,8 @@
 
 #include "Video/Encoders/VideoEncoderNVENC.h"
 
+#include "Utils/PacketBufferPool.h"
+
 FEncoderNVENC::~FEncoderNVENC()
 {
 	Close();
@@ -149,7 +151,7 @@ int FEncoderNVENC::GetCapability(GUID EncodeGUID, NV_ENC_CAPS CapsToQuery) const
 	return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"), TEXT("NVENC"));
 }
 
-FAVResult FEncoderNVENC::SendFrame(TSharedPtr<FVideoResource> const& Resource, uint32 Timestamp, bool bForceKeyframe, TFunction<FAVResult()> ApplyConfigFunc, TFunction<void(NV_ENC_REGISTER_RESOURCE&)> SetResourceToRegisterFunc)
+FAVResult FEncoderNVENC::SendFrame(TSharedPtr<FVideoResource> const& Resource, uint64 Timestamp, bool bForceKeyframe, uint64 UserData, TFunction<FAVResult()> ApplyConfigFunc, TFunction<void(NV_ENC_REGISTER_RESOURCE&)> SetResourceToRegisterFunc)
 {
 	if (IsOpen())
 	{
@@ -179,7 +181,7 @@ FAVResult FEncoderNVENC::SendFrame(TSharedPtr<FVideoResource> const& Resource, u
 
 				Resource->ReadData(OutData);
 
-				FString SaveName = FString::Printf(TEXT("%s/DumpInput/image%05d.%s"), *FPaths::ProjectSavedDir(), Timestamp, ConvertedPixelFormat == NV_ENC_BUFFER_FORMAT_NV12 ? TEXT("nv12") : TEXT("p016"));
+				FString SaveName = FString::Printf(TEXT("%s/DumpInput/image%05llu.%s"), *FPaths::ProjectSavedDir(), Timestamp, ConvertedPixelFormat == NV_ENC_BUFFER_FORMAT_NV12 ? TEXT("nv12") : TEXT("p016"));
 
 				FFileHelper::SaveArrayToFile(OutData, *SaveName);
 			}
@@ -230,7 +232,7 @@ FAVResult FEncoderNVENC::SendFrame(TSharedPtr<FVideoResource> const& Resource, u
 			Resource->Lock();
 		}
 
-		AVResult = SendFrame(Picture);
+		AVResult = SendFrame(Picture, UserData);
 
 		if (Resource.IsValid())
 		{
@@ -269,7 +271,7 @@ FAVResult FEncoderNVENC::SendFrame(TSharedPtr<FVideoResource> const& Resource, u
 	return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"), TEXT("NVENC"));
 }
 
-FAVResult FEncoderNVENC::SendFrame(NV_ENC_PIC_PARAMS Input)
+FAVResult FEncoderNVENC::SendFrame(NV_ENC_PIC_PARAMS Input, uint64 UserData)
 {
 	if (IsOpen())
 	{
@@ -305,17 +307,18 @@ FAVResult FEncoderNVENC::SendFrame(NV_ENC_PIC_PARAMS Input)
 				return FAVResult(EAVResult::ErrorLocking, TEXT("Failed to lock output bitstream"), TEXT("NVENC"), Result);
 			}
 
-			TSharedPtr<uint8> const CopiedData = MakeShareable(new uint8[BitstreamLock.bitstreamSizeInBytes]);
+			TSharedPtr<uint8> const CopiedData = UE::AVCodecCore::FPacketBufferPool::Get().Allocate(BitstreamLock.bitstreamSizeInBytes);
 			FMemory::BigBlockMemcpy(CopiedData.Get(), BitstreamLock.bitstreamBufferPtr, BitstreamLock.bitstreamSizeInBytes);
 
-			Packets.Enqueue(
+			Packets.Push(
 				FVideoPacket(
 					CopiedData,
 					BitstreamLock.bitstreamSizeInBytes,
 					BitstreamLock.outputTimeStamp,
 					BitstreamLock.frameIdx,
 					BitstreamLock.frameAvgQP,
-					(BitstreamLock.pictureType & NV_ENC_PIC_TYPE_IDR) != 0));
+					(BitstreamLock.pictureType & NV_ENC_PIC_TYPE_IDR) != 0,
+					UserData));
 
 			Result = FAPI::Get<FNVENC>().nvEncUnlockBitstream(Encoder, BitstreamLock.outputBitstream);
 			if (Result != NV_ENC_SUCCESS)
@@ -331,7 +334,7 @@ FAVResult FEncoderNVENC::SendFrame(NV_ENC_PIC_PARAMS Input)
 }
 
 #if PLATFORM_WINDOWS
-FAVResult FEncoderNVENC::SendFrameD3D11(TRefCountPtr<ID3D11Device> Device, TSharedPtr<FVideoResourceD3D11> const& Resource, uint32 Timestamp, bool bForceKeyframe, TFunction<FAVResult()> ApplyConfigFunc)
+FAVResult FEncoderNVENC::SendFrameD3D11(TRefCountPtr<ID3D11Device> Device, TSharedPtr<FVideoResourceD3D11> const& Resource, uint64 Timestamp, bool bForceKeyframe, uint64 UserData, TFunction<FAVResult()> ApplyConfigFunc)
 {
 	TRefCountPtr<ID3D11Texture2D>& Tex = const_cast<TRefCountPtr<ID3D11Texture2D>&>(Resource->GetRaw());
 
@@ -342,7 +345,7 @@ FAVResult FEncoderNVENC::SendFrameD3D11(TRefCountPtr<ID3D11Device> Device, TShar
 		return FAVResult(EAVResult::Fatal, TEXT("Failed to open shared handle."), TEXT("NVENC"), Result);
 	}
 
-	return SendFrame(Resource, Timestamp, bForceKeyframe, ApplyConfigFunc, [Resource](NV_ENC_REGISTER_RESOURCE& RegisterResource) {
+	return SendFrame(Resource, Timestamp, bForceKeyframe, UserData, ApplyConfigFunc, [Resource](NV_ENC_REGISTER_RESOURCE& RegisterResource) {
 		RegisterResource.resourceType = NV_ENC_INPUT_RESOURCE_TYPE_DIRECTX;
 		RegisterResource.resourceToRegister = Resource->GetRaw();
 	});
@@ -418,9 +421,9 @@ FAVResult FEncoderNVENC::CreateD3D11Device(TSharedRef<FAVDevice> const& InDevice
 
 #endif // PLATFORM_WINDOWS
 
-FAVResult FEncoderNVENC::SendFrameCUDA(TSharedPtr<FVideoResourceCUDA> const& Resource, uint32 Timestamp, bool bForceKeyframe, TFunction<FAVResult()> ApplyConfigFunc)
+FAVResult FEncoderNVENC::SendFrameCUDA(TSharedPtr<FVideoResourceCUDA> const& Resource, uint64 Timestamp, bool bForceKeyframe, uint64 UserData, TFunction<FAVResult()> ApplyConfigFunc)
 {
-	return SendFrame(Resource, Timestamp, bForceKeyframe, ApplyConfigFunc, [Resource](NV_ENC_REGISTER_RESOURCE& RegisterResource) {
+	return SendFrame(Resource, Timestamp, bForceKeyframe, UserData, ApplyConfigFunc, [Resource](NV_ENC_REGISTER_RESOURCE& RegisterResource) {
 		RegisterResource.resourceType = NV_ENC_INPUT_RESOURCE_TYPE_CUDAARRAY;
 		RegisterResource.resourceToRegister = Resource->GetRaw();
 	});
@@ -430,7 +433,22 @@ FAVResult FEncoderNVENC::ReceivePacket(FVideoPacket& OutPacket)
 {
 	if (IsOpen())
 	{
-		if (Packets.Dequeue(OutPacket))
+		if (Packets.Pop(OutPacket))
+		{
+			return EAVResult::Success;
+		}
+
+		return EAVResult::PendingInput;
+	}
+
+	return FAVResult(EAVResult::ErrorInvalidState, TEXT("Encoder not open"), TEXT("NVENC"));
+}
+
+FAVResult FEncoderNVENC::WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime)
+{
+	if (IsOpen())
+	{
+		if (Packets.WaitPop(OutPacket, WaitTime))
 		{
 			return EAVResult::Success;
 		}
@@ -8,7 +8,7 @@
 #include "NVENC.h"
 #include "Video/Encoders/Configs/VideoEncoderConfigNVENC.h"
 #include "Templates/RefCounting.h"
-#include "Containers/Queue.h"
+#include "Utils/PacketRing.h"
 
 #if PLATFORM_WINDOWS
 	#include "Video/Resources/Windows/VideoResourceD3D.h"
@@ -23,7 +23,7 @@ class NVENC_API FEncoderNVENC
 private:
 	void* Encoder = nullptr;
 	NV_ENC_OUTPUT_PTR Buffer = nullptr;
-	TQueue<FVideoPacket> Packets;
+	UE::AVCodecCore::TPacketRing<FVideoPacket> Packets;
 
 public:
 	// Begin matching the TVideoEncoder interface
@@ -34,15 +34,16 @@ public:
 	virtual FAVResult ApplyConfig(FVideoEncoderConfigNVENC const& AppliedConfig, FVideoEncoderConfigNVENC const& PendingConfig, TFunction<FAVResult()> ApplyConfigFunc);
 #if PLATFORM_WINDOWS
 	virtual FAVResult CreateD3D11Device(TSharedRef<FAVDevice> const& InDevice, TRefCountPtr<ID3D11Device>& OutEncoderDevice, TRefCountPtr<ID3D11DeviceContext>& OutEncoderDeviceContext);
-	virtual FAVResult SendFrameD3D11(TRefCountPtr<ID3D11Device> Device, TSharedPtr<FVideoResourceD3D11> const& Resource, uint32 Timestamp, bool bForceKeyframe, TFunction<FAVResult()> ApplyConfigFunc);
+	virtual FAVResult SendFrameD3D11(TRefCountPtr<ID3D11Device> Device, TSharedPtr<FVideoResourceD3D11> const& Resource, uint64 Timestamp, bool bForceKeyframe, uint64 UserData, TFunction<FAVResult()> ApplyConfigFunc);
 #endif // PLATFORM_WINDOWS
-	virtual FAVResult SendFrameCUDA(TSharedPtr<FVideoResourceCUDA> const& Resource, uint32 Timestamp, bool bForceKeyframe, TFunction<FAVResult()> ApplyConfigFunc);
-	virtual FAVResult SendFrame(TSharedPtr<FVideoResource> const& Resource, uint32 Timestamp, bool bForceKeyframe, TFunction<FAVResult()> ApplyConfigFunc, TFunction<void(NV_ENC_REGISTER_RESOURCE&)> SetResourceToRegisterFunc);
+	virtual FAVResult SendFrameCUDA(TSharedPtr<FVideoResourceCUDA> const& Resource, uint64 Timestamp, bool bForceKeyframe, uint64 UserData, TFunction<FAVResult()> ApplyConfigFunc);
+	virtual FAVResult SendFrame(TSharedPtr<FVideoResource> const& Resource, uint64 Timestamp, bool bForceKeyframe, uint64 UserData, TFunction<FAVResult()> ApplyConfigFunc, TFunction<void(NV_ENC_REGISTER_RESOURCE&)> SetResourceToRegisterFunc);
 	virtual FAVResult ReceivePacket(FVideoPacket& OutPacket);
+	virtual FAVResult WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime);
 	// End matching the TVideoEncoder interface
 
 	bool IsInitialized() const;
-	FAVResult SendFrame(NV_ENC_PIC_PARAMS Input);
+	FAVResult SendFrame(NV_ENC_PIC_PARAMS Input, uint64 UserData = 0);
 	int GetCapability(GUID EncodeGUID, NV_ENC_CAPS CapsToQuery) const;
 };
 
@@ -63,6 +64,7 @@ public:
 	virtual bool IsOpen() const override { return Base->IsOpen(); }
 	virtual void Close() override { Base->Close(); };
 	virtual FAVResult ReceivePacket(FVideoPacket& OutPacket) override { return Base->ReceivePacket(OutPacket); }
+	virtual FAVResult WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime) override { return Base->WaitForPacket(OutPacket, WaitTime); }
 
 	virtual FAVResult ApplyConfig() override
 	{
@@ -80,9 +82,9 @@ public:
 		});
 	}
 
-	virtual FAVResult SendFrame(TSharedPtr<FVideoResourceCUDA> const& Resource, uint32 Timestamp, bool bForceKeyframe = false) override
+	virtual FAVResult SendFrame(TSharedPtr<FVideoResourceCUDA> const& Resource, uint64 Timestamp, bool bForceKeyframe = false, uint64 UserData = 0) override
 	{
-		return Base->SendFrameCUDA(Resource, Timestamp, bForceKeyframe, [this]() {
+		return Base->SendFrameCUDA(Resource, Timestamp, bForceKeyframe, UserData, [this]() {
 			return ApplyConfig();
 		});
 	}
@@ -110,6 +112,7 @@ public:
 	virtual bool IsOpen() const override { return Base->IsOpen(); }
 	virtual void Close() override { Base->Close(); };
 	virtual FAVResult ReceivePacket(FVideoPacket& OutPacket) override { return Base->ReceivePacket(OutPacket); }
+	virtual FAVResult WaitForPacket(FVideoPacket& OutPacket, FTimespan WaitTime) override { return Base->WaitForPacket(OutPacket, WaitTime); }
 
 	virtual FAVResult ApplyConfig() override
 	{
@@ -140,9 +143,9 @@ public:
 		});
 	}
 
-	virtual FAVResult SendFrame(TSharedPtr<FVideoResourceD3D11> const& Resource, uint32 Timestamp, bool bForceKeyframe = false)
+	virtual FAVResult SendFrame(TSharedPtr<FVideoResourceD3D11> const& Resource, uint64 Timestamp, bool bForceKeyframe = false, uint64 UserData = 0) override
 	{
-		return Base->SendFrameD3D11(EncoderDevice, Resource, Timestamp, bForceKeyframe, [this]() {
+		return Base->SendFrameD3D11(EncoderDevice, Resource, Timestamp, bForceKeyframe, UserData, [this]() {
 			return ApplyConfig();
 		});
 	}
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "WebRTCIncludes.h"
+#include "AVPacket.h"
+
+namespace UE::PixelStreaming
+{
+	/**
+	 * An encoded image buffer that shares the data of an encoded packet instead of copying it.
+	 * The packet data stays alive for as long as WebRTC holds on to the image.
+	 */
+	class FEncodedImageBufferPacket : public webrtc::EncodedImageBufferInterface
+	{
+	public:
+		FEncodedImageBufferPacket(FAVPacket const& Packet) : DataPtr(Packet.DataPtr), DataSize(Packet.DataSize) {}
+
+		virtual ~FEncodedImageBufferPacket() = default;
+
+		virtual const uint8_t* data() const override { return DataPtr.Get(); }
+		virtual uint8_t* data() override { return DataPtr.Get(); }
+		virtual size_t size() const override { return DataSize; }
+
+	private:
+		TSharedPtr<uint8> DataPtr;
+		size_t DataSize;
+	};
+} // namespace UE::PixelStreaming
@@ -5,6 +5,39 @@
 #include "PixelStreamingPrivate.h"
 #include "Utils.h"
 
+namespace
+{
+	// 16MB (WebRTC Data Channel buffer size)
+	constexpr uint64 MaxBufferedBytes = 16 * 1024 * 1024;
+} // namespace
+
+class FPixelStreamingDataChannel::FSendChannelObserver : public webrtc::DataChannelObserver
+{
+public:
+	explicit FSendChannelObserver(const FPixelStreamingDataChannel& InOwner)
+		: Owner(InOwner)
+	{
+	}
+
+	virtual void OnStateChange() override
+	{
+		if (Owner.SendChannel->state() == webrtc::DataChannelInterface::DataState::kClosed)
+		{
+			Owner.FailPendingSends();
+		}
+	}
+
+	virtual void OnMessage(const webrtc::DataBuffer& Buffer) override {}
+
+	virtual void OnBufferedAmountChange(uint64_t SentDataSize) override
+	{
+		Owner.PumpSendQueue();
+	}
+
+private:
+	const FPixelStreamingDataChannel& Owner;
+};
+
 TSharedPtr<FPixelStreamingDataChannel> FPixelStreamingDataChannel::Create(rtc::scoped_refptr<webrtc::DataChannelInterface> InChannel)
 {
 	return TSharedPtr<FPixelStreamingDataChannel>(new FPixelStreamingDataChannel(InChannel));
@@ -52,6 +85,13 @@ FPixelStreamingDataChannel::FPixelStreamingDataChannel(FPixelStreamingPeerConnec
 	checkf(SendChannel, TEXT("Send channel cannot be null"));
 	checkf(RecvChannel, TEXT("Recv channel cannot be null"));
 
+	// The receive channel's observer only hears about its own buffer, so the send queue needs to watch the send channel itself
+	if (SendChannel && SendChannel != RecvChannel)
+	{
+		SendChannelObserver = MakeUnique<FSendChannelObserver>(*this);
+		SendChannel->RegisterObserver(SendChannelObserver.Get());
+	}
+
 	/* PSExt add start */
 	if (RecvChannel)
 	{
@@ -70,18 +110,87 @@ FPixelStreamingDataChannel::~FPixelStreamingDataChannel()
 		RecvChannel->UnregisterObserver();
 	}
 	/* PSExt add end */
+
+	if (SendChannelObserver)
+	{
+		SendChannel->UnregisterObserver();
+	}
+
+	// Nothing can pump the queue any more, so let whoever is waiting on it know
+	FailPendingSends();
+}
+
+bool FPixelStreamingDataChannel::SendBuffer(const rtc::CopyOnWriteBuffer& Buffer) const
+{
+	if (SendChannel->state() != webrtc::DataChannelInterface::DataState::kOpen)
+	{
+		return false;
+	}
+
+	FPendingSend PendingSend;
+	PendingSend.Message = Buffer;
+	EnqueueSend(MoveTemp(PendingSend));
+	return true;
+}
+
+TFuture<bool> FPixelStreamingDataChannel::SendBufferAsync(const rtc::CopyOnWriteBuffer& Buffer) const
+{
+	if (SendChannel->state() != webrtc::DataChannelInterface::DataState::kOpen)
+	{
+		return MakeFulfilledPromise<bool>(false).GetFuture();
+	}
+
+	FPendingSend PendingSend;
+	PendingSend.Message = Buffer;
+	PendingSend.Promise = MakeShared<TPromise<bool>, ESPMode::ThreadSafe>();
+	TFuture<bool> Future = PendingSend.Promise->GetFuture();
+
+	EnqueueSend(MoveTemp(PendingSend));
+	return Future;
 }
 
 bool FPixelStreamingDataChannel::SendArbitraryData(uint8 Type, const TArray64<uint8>& DataBytes) const
 {
-	using namespace UE::PixelStreaming;
+	return SendArbitraryDataAsync(Type, DataBytes).Get();
+}
 
+TFuture<bool> FPixelStreamingDataChannel::SendArbitraryDataAsync(uint8 Type, const TArray64<uint8>& DataBytes) const
+{
 	if (!SendChannel)
 	{
 		UE_LOG(LogPixelStreaming, Error, TEXT("Cannot send arbitrary data when data channel is null."));
-		return false;
+		return MakeFulfilledPromise<bool>(false).GetFuture();
+	}
+
+	return SendArbitraryDataAsync(MakeShared<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe>(BuildArbitraryData(Type, DataBytes)));
+}
+
+TFuture<bool> FPixelStreamingDataChannel::SendArbitraryDataAsync(TSharedRef<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe> Chunks) const
+{
+	if (!SendChannel)
+	{
+		UE_LOG(LogPixelStreaming, Error, TEXT("Cannot send arbitrary data when data channel is null."));
+		return MakeFulfilledPromise<bool>(false).GetFuture();
 	}
 
+	if (Chunks->IsEmpty())
+	{
+		return MakeFulfilledPromise<bool>(true).GetFuture();
+	}
+
+	FPendingSend PendingSend;
+	PendingSend.Chunks = Chunks;
+	PendingSend.Promise = MakeShared<TPromise<bool>, ESPMode::ThreadSafe>();
+	TFuture<bool> Future = PendingSend.Promise->GetFuture();
+
+	EnqueueSend(MoveTemp(PendingSend));
+	return Future;
+}
+
+TArray<rtc::CopyOnWriteBuffer> FPixelStreamingDataChannel::BuildArbitraryData(uint8 Type, const TArray64<uint8>& DataBytes)
+{
+	using namespace UE::PixelStreaming;
+
 	// int32 results in a maximum 4GB file (4,294,967,296 bytes)
 	const int32 DataSize = DataBytes.Num();
 
@@ -90,6 +199,9 @@ bool FPixelStreamingDataChannel::SendArbitraryData(uint8 Type, const TArray64<ui
 	const int32 MessageHeader = sizeof(Type) + sizeof(DataSize);
 	const int32 MaxDataBytesPerMsg = MaxBufferBytes - MessageHeader;
 
+	TArray<rtc::CopyOnWriteBuffer> Chunks;
+	Chunks.Reserve(FMath::DivideAndRoundUp(DataSize, MaxDataBytesPerMsg));
+
 	int32 BytesTransmitted = 0;
 
 	while (BytesTransmitted < DataSize)
@@ -110,28 +222,135 @@ bool FPixelStreamingDataChannel::SendArbitraryData(uint8 Type, const TArray64<ui
 		// Write the data bytes payload
 		Pos = SerializeToBuffer(Buffer, Pos, DataBytes.GetData() + BytesTransmitted, BytesToTransmit);
 
-		uint64_t BufferBefore = SendChannel->buffered_amount();
-		while (BufferBefore + BytesToTransmit >= 16 * 1024 * 1024) // 16MB (WebRTC Data Channel buffer size)
-		{
-			// As per UE docs a Sleep of 0.0 simply lets other threads take CPU cycles while this is happening.
-			FPlatformProcess::Sleep(0.0);
-			BufferBefore = SendChannel->buffered_amount();
-		}
+		Chunks.Add(MoveTemp(Buffer));
+
+		// Increment the number of bytes transmitted
+		BytesTransmitted += BytesToTransmit;
+	}
+	return Chunks;
+}
+
+void FPixelStreamingDataChannel::EnqueueSend(FPendingSend&& PendingSend) const
+{
+	{
+		FScopeLock Lock(&SendQueueCS);
+		SendQueue.EmplaceLast(MoveTemp(PendingSend));
+	}
 
-		if (!SendChannel->Send(webrtc::DataBuffer(Buffer, true)))
+	PumpSendQueue();
+}
+
+void FPixelStreamingDataChannel::PumpSendQueue() const
+{
+	// Whoever is already pumping goes round again instead, so sends are never made from two threads at once.
+	// It also means the queue lock is never held while calling into the channel, which may wait on the signalling thread.
+	if (PumpRequests.fetch_add(1) > 0)
+	{
+		return;
+	}
+
+	using FPromisePtr = TSharedPtr<TPromise<bool>, ESPMode::ThreadSafe>;
+	TArray<TPair<FPromisePtr, bool>, TInlineAllocator<4>> Completed;
+
+	do
+	{
+		uint64 BufferedAmount = SendChannel->buffered_amount();
+
+		while (true)
 		{
+			rtc::CopyOnWriteBuffer Buffer;
+			FPromisePtr Promise;
+			bool bLast = true;
+			{
+				FScopeLock Lock(&SendQueueCS);
+				if (SendQueue.IsEmpty())
+				{
+					break;
+				}
+
+				FPendingSend& PendingSend = SendQueue.First();
+				Buffer = PendingSend.Chunks ? (*PendingSend.Chunks)[PendingSend.NextChunk] : PendingSend.Message;
+
+				// Leave it queued until the channel drains, OnBufferedAmountChange pumps again as it does
+				if (BufferedAmount + Buffer.size() >= MaxBufferedBytes)
+				{
+					break;
+				}
+
+				Promise = PendingSend.Promise;
+				bLast = !PendingSend.Chunks || ++PendingSend.NextChunk == PendingSend.Chunks->Num();
+				if (bLast)
+				{
+					SendQueue.PopFirst();
+				}
+			}
+
+			// DataBuffer takes another reference to the buffer rather than copying it
+			if (SendChannel->Send(webrtc::DataBuffer(Buffer, true)))
+			{
+				BufferedAmount += Buffer.size();
+				if (bLast && Promise)
+				{
+					Completed.Emplace(Promise, true);
+				}
+				continue;
+			}
+
 			UE_LOG(LogPixelStreaming, Error, TEXT("Failed to send data channel packet"));
-			return false;
+
+			// Give up on the rest of a transfer that failed part way. Only whoever takes it off the queue answers its promise,
+			// FailPendingSends may have got there first while the chunk was being sent.
+			bool bRemoved = bLast;
+			if (!bLast)
+			{
+				FScopeLock Lock(&SendQueueCS);
+				if (!SendQueue.IsEmpty() && SendQueue.First().Promise == Promise)
+				{
+					SendQueue.PopFirst();
+					bRemoved = true;
+				}
+			}
+
+			if (Promise && bRemoved)
+			{
+				Completed.Emplace(Promise, false);
+			}
 		}
+	} while (PumpRequests.fetch_sub(1) > 1);
 
-		// Increment the number of bytes transmitted
-		BytesTransmitted += BytesToTransmit;
+	// Outside the lock, continuations run inline and may well send more
+	for (TPair<FPromisePtr, bool>& Completion : Completed)
+	{
+		Completion.Key->SetValue(Completion.Value);
+	}
+}
+
+void FPixelStreamingDataChannel::FailPendingSends() const
+{
+	TDeque<FPendingSend> Failed;
+	{
+		FScopeLock Lock(&SendQueueCS);
+		Swap(Failed, SendQueue);
+	}
+
+	while (!Failed.IsEmpty())
+	{
+		if (Failed.First().Promise)
+		{
+			Failed.First().Promise->SetValue(false);
+		}
+		Failed.PopFirst();
 	}
-	return true;
 }
 
 void FPixelStreamingDataChannel::OnStateChange()
 {
+	// Nothing queued can go out once the channel has closed
+	if (SendChannel == RecvChannel && RecvChannel->state() == webrtc::DataChannelInterface::DataState::kClosed)
+	{
+		FailPendingSends();
+	}
+
 	// ideally we use AsShared() here so we either get a shared ptr to this or it fails
 	// (because the destructor is being called in another thread) and we do nothing. If
 	// it succeeds then we know we wont get destructed while in the block.
@@ -185,28 +404,29 @@ void FPixelStreamingDataChannel::OnMessage(const webrtc::DataBuffer& Buffer)
 			// the signalling thread or block it with mutexes etc.
 			TWeakPtr<FPixelStreamingDataChannel> WeakChannel = SharedThis;
 
-			if (GFirstFrameIntraFrameDebugging || GIntraFrameDebuggingGameThread)
-			{
-				// If we're streaming the editor and we hit a BP breakpoint, the gamethread is no longer able to respond to input
-				// in that case we post this task to the Main Queue as we know that that will still be running
-				AsyncTask(ENamedThreads::MainQueue, [WeakChannel, Buffer = Buffer]() {
-					if (TSharedPtr<FPixelStreamingDataChannel> DataChannel = WeakChannel.Pin())
-					{
-						const uint8 MsgType = static_cast<uint8>(Buffer.data.data()[0]);
-						DataChannel->OnMessageReceived.Broadcast(MsgType, Buffer);
-					}
-				});
-			}
-			else
-			{
-				AsyncTask(ENamedThreads::GameThread, [WeakChannel, Buffer = Buffer]() {
-					if (TSharedPtr<FPixelStreamingDataChannel> DataChannel = WeakChannel.Pin())
-					{
-						const uint8 MsgType = static_cast<uint8>(Buffer.data.data()[0]);
-						DataChannel->OnMessageReceived.Broadcast(MsgType, Buffer);
-					}
-				});
-			}
+			// If we're streaming the editor and we hit a BP breakpoint, the gamethread is no longer able to respond to input
+			// in that case we post this task to the Main Queue as we know that that will still be running
+			const ENamedThreads::Type Thread = (GFirstFrameIntraFrameDebugging || GIntraFrameDebuggingGameThread) ? ENamedThreads::MainQueue : ENamedThreads::GameThread;
+
+			// Copying the DataBuffer only adds a reference to the payload WebRTC received, which then travels as is to whoever handles it
+			AsyncTask(Thread, [WeakChannel, Buffer = Buffer]() {
+				if (Buffer.size() == 0)
+				{
+					return;
+				}
+
+				if (TSharedPtr<FPixelStreamingDataChannel> DataChannel = WeakChannel.Pin())
+				{
+					const uint8 MsgType = static_cast<uint8>(Buffer.data.data()[0]);
+					DataChannel->OnMessageReceived.Broadcast(MsgType, Buffer);
+				}
+			});
 		}
 	}
 }
+
+void FPixelStreamingDataChannel::OnBufferedAmountChange(uint64_t SentDataSize)
+{
+	// The channel has drained some, so send whatever is waiting for room
+	PumpSendQueue();
+}
@@ -546,7 +546,7 @@ namespace UE::PixelStreaming
 
 	// PluginExt: START
 	// Hander の引数に PlayerId を追加しました。
-	void FPixelStreamingModule::RegisterMessage(EPixelStreamingMessageDirection MessageDirection, const FString& MessageType, FPixelStreamingInputMessage Message, const TFunction<void(FString, FMemoryReader)>& Handler)
+	void FPixelStreamingModule::RegisterMessage(EPixelStreamingMessageDirection MessageDirection, const FString& MessageType, FPixelStreamingInputMessage Message, const TFunction<void(const FString&, FMemoryReader)>& Handler)
 	{
 		if (MessageDirection == EPixelStreamingMessageDirection::ToStreamer)
 		{
@@ -565,13 +565,13 @@ namespace UE::PixelStreaming
 
 	// PluginExt: START
 	// Hander の引数に PlayerId を追加しました。
-	TFunction<void(FString, FMemoryReader)> FPixelStreamingModule::FindMessageHandler(const FString& MessageType)
+	TFunction<void(const FString&, FMemoryReader)> FPixelStreamingModule::FindMessageHandler(const FString& MessageType)
 	{
 		if (TSharedPtr<IPixelStreamingInputHandler> InputHandler = DefaultStreamer->GetInputHandler().Pin())
 		{
 			return InputHandler->FindMessageHandler(MessageType);
 		}
-		return [](FString, FMemoryReader Ar) {};
+		return [](const FString&, FMemoryReader Ar) {};
 	}
 	// PluginExt: END
 	/**
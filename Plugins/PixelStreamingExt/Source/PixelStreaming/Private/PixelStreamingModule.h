@@ -64,8 +64,8 @@ namespace UE::PixelStreaming
 		const FPixelStreamingInputProtocol GetProtocol() override;
 		// PluginExt: START
 		// Handler の引数に PlayerId を追加しました。
-		void RegisterMessage(EPixelStreamingMessageDirection MessageDirection, const FString& MessageType, FPixelStreamingInputMessage Message, const TFunction<void(FString, FMemoryReader)>& Handler) override;
-		TFunction<void(FString, FMemoryReader)> FindMessageHandler(const FString& MessageType) override;
+		void RegisterMessage(EPixelStreamingMessageDirection MessageDirection, const FString& MessageType, FPixelStreamingInputMessage Message, const TFunction<void(const FString&, FMemoryReader)>& Handler) override;
+		TFunction<void(const FString&, FMemoryReader)> FindMessageHandler(const FString& MessageType) override;
 		// PluginExt: END
 		/** End deprecated methods */
 
@@ -13,5 +13,7 @@ namespace UE::PixelStreaming
 		FPixelStreamingPlayerConfig Config;
 		TSharedPtr<FPixelStreamingPeerConnection> PeerConnection;
 		TSharedPtr<FPixelStreamingDataChannel> DataChannel;
+		// Made once and handed to the input handler with every message from this player
+		TSharedPtr<const FString, ESPMode::ThreadSafe> PlayerIdHandle;
 	};
 }
@@ -56,6 +56,48 @@ namespace UE::PixelStreaming::Settings
 		TEXT("Maintains constant bitrate by filling with junk data. Note: Should not be required with CBR and MinQP = -1. Default: false."),
 		ECVF_Default);
 
+	TAutoConsoleVariable<bool> CVarPixelStreamingEncoderDisableVUIRewrite(
+		TEXT("PixelStreaming.Encoder.DisableVUIRewrite"),
+		false,
+		TEXT("Disables rewriting the H.264 SPS on keyframes to signal that no frames are reordered, which lets decoders output each frame as soon as it arrives. Default: false."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<bool> CVarPixelStreamingEncoderEmbedFrameTiming(
+		TEXT("PixelStreaming.Encoder.EmbedFrameTiming"),
+		false,
+		TEXT("Embeds the capture, encode start and encode end time of each H.264/H.265 frame in an SEI message so receivers can measure glass to glass latency. Copies every encoded frame to make room for the SEI, so only enable it while measuring. Default: false."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int32> CVarPixelStreamingEncoderFramesInFlight(
+		TEXT("PixelStreaming.Encoder.FramesInFlight"),
+		0,
+		TEXT("How many frames the H.264/H.265 encoder may have queued or encoding at once. Values > 0 encode on a separate thread so WebRTC can move on to the next frame, values <= 0 encode synchronously. Only applies to encoders created after it is changed. Default: 0."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<bool> CVarPixelStreamingEncoderDropLateFrames(
+		TEXT("PixelStreaming.Encoder.DropLateFrames"),
+		true,
+		TEXT("When frames are encoded on a separate thread (see PixelStreaming.Encoder.FramesInFlight), skip delta frames the encoder would only finish after the next frame is due, rather than let latency build up behind them. Only applies to encoders created after it is changed. Default: true."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<FString> CVarPixelStreamingEncoderSharedRatePolicy(
+		TEXT("PixelStreaming.Encoder.SharedRatePolicy"),
+		TEXT("MINIMUM"),
+		TEXT("How the bitrates and framerates WebRTC asks for on behalf of each peer watching the same stream are combined, as the H.264/H.265 encoder for a stream is shared by all of them. Supported modes are `MINIMUM`, `AVERAGE`. Only applies to streams started after it is changed. Default: MINIMUM."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int32> CVarPixelStreamingEncoderKeyframeCoalesceWindowMs(
+		TEXT("PixelStreaming.Encoder.KeyframeCoalesceWindowMs"),
+		100,
+		TEXT("Keyframe requests from peers arriving within this many milliseconds of a keyframe are taken to be answered by it. Only applies to streams started after it is changed. Default: 100."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int32> CVarPixelStreamingEncoderMinKeyframeSpacingMs(
+		TEXT("PixelStreaming.Encoder.MinKeyframeSpacingMs"),
+		500,
+		TEXT("Least number of milliseconds between two keyframes sent in answer to peers, requests arriving sooner are held and answered together. When intra refresh is enabled (see PixelStreaming.Encoder.IntraRefreshPeriodFrames) peers that have already started decoding are left to it instead. Only applies to streams started after it is changed. Default: 500."),
+		ECVF_Default);
+
 	TAutoConsoleVariable<FString> CVarPixelStreamingEncoderMultipass(
 		TEXT("PixelStreaming.Encoder.Multipass"),
 		TEXT("FULL"),
@@ -358,6 +400,11 @@ namespace UE::PixelStreaming::Settings
 		{ "FULL", EMultipassMode::Full },
 	};
 
+	std::map<FString, EVideoEncodeRatePolicy> const SharedRatePolicyCVarMap{
+		{ "MINIMUM", EVideoEncodeRatePolicy::Minimum },
+		{ "AVERAGE", EVideoEncodeRatePolicy::Average },
+	};
+
 	std::map<FString, EH264Profile> const H264ProfileMap{
 		{ "AUTO", EH264Profile::Auto },
 		{ "BASELINE", EH264Profile::Baseline },
@@ -400,6 +447,15 @@ namespace UE::PixelStreaming::Settings
 		return Iter->second;
 	}
 
+	EVideoEncodeRatePolicy GetSharedRatePolicy()
+	{
+		const FString SharedRatePolicy = CVarPixelStreamingEncoderSharedRatePolicy.GetValueOnAnyThread();
+		auto const Iter = SharedRatePolicyCVarMap.find(SharedRatePolicy);
+		if (Iter == std::end(SharedRatePolicyCVarMap))
+			return EVideoEncodeRatePolicy::Minimum;
+		return Iter->second;
+	}
+
 	webrtc::DegradationPreference GetDegradationPreference()
 	{
 		FString DegradationPreference = CVarPixelStreamingDegradationPreference.GetValueOnAnyThread();
@@ -661,6 +717,10 @@ namespace UE::PixelStreaming::Settings
 		CommandLineParseValue(TEXT("PixelStreamingEncoderMultipass="), CVarPixelStreamingEncoderMultipass);
 		CommandLineParseValue(TEXT("PixelStreamingEncoderCodec="), CVarPixelStreamingEncoderCodec);
 		CommandLineParseValue(TEXT("PixelStreamingEncoderMaxSessions="), CVarPixelStreamingEncoderMaxSessions);
+		CommandLineParseValue(TEXT("PixelStreamingEncoderFramesInFlight="), CVarPixelStreamingEncoderFramesInFlight);
+		CommandLineParseValue(TEXT("PixelStreamingEncoderSharedRatePolicy="), CVarPixelStreamingEncoderSharedRatePolicy);
+		CommandLineParseValue(TEXT("PixelStreamingEncoderKeyframeCoalesceWindowMs="), CVarPixelStreamingEncoderKeyframeCoalesceWindowMs);
+		CommandLineParseValue(TEXT("PixelStreamingEncoderMinKeyframeSpacingMs="), CVarPixelStreamingEncoderMinKeyframeSpacingMs);
 		CommandLineParseValue(TEXT("PixelStreamingH264Profile="), CVarPixelStreamingH264Profile);
 		CommandLineParseValue(TEXT("PixelStreamingH265Profile="), CVarPixelStreamingH265Profile);
 		CommandLineParseValue(TEXT("PixelStreamingEncoderPreset="), CVarPixelStreamingEncoderPreset);
@@ -684,6 +744,9 @@ namespace UE::PixelStreaming::Settings
 		CommandLineParseOption(TEXT("PixelStreamingHudStats"), CVarPixelStreamingOnScreenStats);
 		CommandLineParseOption(TEXT("PixelStreamingDebugDumpFrame"), CVarPixelStreamingDebugDumpFrame);
 		CommandLineParseOption(TEXT("PixelStreamingEnableFillerData"), CVarPixelStreamingEnableFillerData);
+		CommandLineParseOption(TEXT("PixelStreamingEncoderDisableVUIRewrite"), CVarPixelStreamingEncoderDisableVUIRewrite);
+		CommandLineParseOption(TEXT("PixelStreamingEncoderEmbedFrameTiming"), CVarPixelStreamingEncoderEmbedFrameTiming);
+		CommandLineParseOption(TEXT("PixelStreamingEncoderDropLateFrames"), CVarPixelStreamingEncoderDropLateFrames);
 		CommandLineParseOption(TEXT("PixelStreamingWebRTCDisableStats"), CVarPixelStreamingWebRTCDisableStats);
 		CommandLineParseOption(TEXT("PixelStreamingWebRTCDisableReceiveAudio"), CVarPixelStreamingWebRTCDisableReceiveAudio);
 		CommandLineParseOption(TEXT("PixelStreamingWebRTCDisableTransmitAudio"), CVarPixelStreamingWebRTCDisableTransmitAudio);
@@ -9,6 +9,7 @@
 #include "InputCoreTypes.h"
 #include "Video/Encoders/Configs/VideoEncoderConfigH264.h"
 #include "Video/Encoders/Configs/VideoEncoderConfigH265.h"
+#include "Video/Encoders/VideoEncodeSession.h"
 #include "WebRTCIncludes.h"
 #include "PixelStreamingCodec.h"
 
@@ -24,6 +25,13 @@ namespace UE::PixelStreaming::Settings
 	extern TAutoConsoleVariable<int32> CVarPixelStreamingEncoderMaxQP;
 	extern TAutoConsoleVariable<FString> CVarPixelStreamingEncoderRateControl;
 	extern TAutoConsoleVariable<bool> CVarPixelStreamingEnableFillerData;
+	extern TAutoConsoleVariable<bool> CVarPixelStreamingEncoderDisableVUIRewrite;
+	extern TAutoConsoleVariable<bool> CVarPixelStreamingEncoderEmbedFrameTiming;
+	extern TAutoConsoleVariable<int32> CVarPixelStreamingEncoderFramesInFlight;
+	extern TAutoConsoleVariable<bool> CVarPixelStreamingEncoderDropLateFrames;
+	extern TAutoConsoleVariable<FString> CVarPixelStreamingEncoderSharedRatePolicy;
+	extern TAutoConsoleVariable<int32> CVarPixelStreamingEncoderKeyframeCoalesceWindowMs;
+	extern TAutoConsoleVariable<int32> CVarPixelStreamingEncoderMinKeyframeSpacingMs;
 	extern TAutoConsoleVariable<FString> CVarPixelStreamingEncoderMultipass;
 	extern TAutoConsoleVariable<FString> CVarPixelStreamingH264Profile;
 	extern TAutoConsoleVariable<FString> CVarPixelStreamingH265Profile;
@@ -87,6 +95,7 @@ namespace UE::PixelStreaming::Settings
 	EPixelStreamingCodec GetSelectedCodec();
 	ERateControlMode GetRateControlCVar();
 	EMultipassMode GetMultipassCVar();
+	EVideoEncodeRatePolicy GetSharedRatePolicy();
 	webrtc::DegradationPreference GetDegradationPreference();
 	EH264Profile GetH264Profile();
 	EH265Profile GetH265Profile();
@@ -0,0 +1,153 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Map.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/SharedPointer.h"
+
+namespace UE::PixelStreaming
+{
+	/**
+	 * A map that is read far more often than it is changed, such as the players of a streamer.
+	 * Writers publish a new immutable snapshot of the whole map whenever they change it, and readers
+	 * work on whichever snapshot was current when they started, so iterating never copies the map or
+	 * holds a lock while visiting.
+	 */
+	template <typename KeyType, typename ValueType>
+	class TSnapshotMap
+	{
+	private:
+		// We add a level of indirection here so when the map changes the location of the ValueType
+		// does not change. This allows Find to return a pointer to the ValueType and every snapshot
+		// to share the same values.
+		using InternalElementType = TSharedPtr<ValueType, ESPMode::ThreadSafe>;
+		using SnapshotType = TMap<KeyType, InternalElementType>;
+		using SnapshotRef = TSharedRef<const SnapshotType, ESPMode::ThreadSafe>;
+
+		// Only ever replaced, never modified once published
+		SnapshotRef Snapshot = MakeShared<const SnapshotType, ESPMode::ThreadSafe>();
+
+		// Held just long enough to copy or swap the snapshot reference, there is no atomic shared reference to do it with
+		mutable FRWLock SnapshotLock;
+
+		// Serialises writers, so one cannot publish over a change another is still making
+		FCriticalSection WriterMutex;
+
+		SnapshotRef GetSnapshot() const
+		{
+			FReadScopeLock Lock(SnapshotLock);
+			return Snapshot;
+		}
+
+		void Publish(SnapshotType&& NewSnapshot)
+		{
+			SnapshotRef NewRef = MakeShared<const SnapshotType, ESPMode::ThreadSafe>(MoveTemp(NewSnapshot));
+
+			// Let the old snapshot go outside the lock, readers may still be holding on to it
+			{
+				FWriteScopeLock Lock(SnapshotLock);
+				Swap(Snapshot, NewRef);
+			}
+		}
+
+	public:
+		bool Add(KeyType Key, const ValueType& Value)
+		{
+			FScopeLock Lock(&WriterMutex);
+			SnapshotRef Current = GetSnapshot();
+			if (Current->Contains(Key))
+			{
+				return false;
+			}
+
+			SnapshotType NewSnapshot = *Current;
+			NewSnapshot.Add(Key, MakeShared<ValueType, ESPMode::ThreadSafe>(Value));
+			Publish(MoveTemp(NewSnapshot));
+			return true;
+		}
+
+		bool Remove(KeyType Key)
+		{
+			FScopeLock Lock(&WriterMutex);
+			SnapshotRef Current = GetSnapshot();
+			if (!Current->Contains(Key))
+			{
+				return false;
+			}
+
+			SnapshotType NewSnapshot = *Current;
+			NewSnapshot.Remove(Key);
+			Publish(MoveTemp(NewSnapshot));
+			return true;
+		}
+
+		ValueType& GetOrAdd(KeyType Key)
+		{
+			FScopeLock Lock(&WriterMutex);
+			SnapshotRef Current = GetSnapshot();
+			if (const InternalElementType* Found = Current->Find(Key))
+			{
+				return **Found;
+			}
+
+			InternalElementType NewElement = MakeShared<ValueType, ESPMode::ThreadSafe>();
+			SnapshotType NewSnapshot = *Current;
+			NewSnapshot.Add(Key, NewElement);
+			Publish(MoveTemp(NewSnapshot));
+			return *NewElement;
+		}
+
+		ValueType* Find(KeyType Key) const
+		{
+			if (const InternalElementType* Found = GetSnapshot()->Find(Key))
+			{
+				return Found->Get();
+			}
+			return nullptr;
+		}
+
+		void Empty()
+		{
+			FScopeLock Lock(&WriterMutex);
+			Publish(SnapshotType());
+		}
+
+		bool IsEmpty() const
+		{
+			return GetSnapshot()->IsEmpty();
+		}
+
+		int32 Num() const
+		{
+			return GetSnapshot()->Num();
+		}
+
+		// Visits the map as it was when called, so the visitor may change the map without affecting the visit
+		template <typename T>
+		void Apply(T&& Visitor) const
+		{
+			SnapshotRef Current = GetSnapshot();
+			for (const auto& [Key, Element] : *Current)
+			{
+				Visitor(Key, *Element);
+			}
+		}
+
+		// Visits the map as it was when called until the visitor returns true
+		template <typename T>
+		void ApplyUntil(T&& Visitor) const
+		{
+			SnapshotRef Current = GetSnapshot();
+			for (const auto& [Key, Element] : *Current)
+			{
+				if (Visitor(Key, *Element))
+				{
+					break;
+				}
+			}
+		}
+	};
+} // namespace UE::PixelStreaming
@@ -64,14 +64,42 @@ namespace UE::PixelStreaming
 		StopStreaming();
 	}
 
-	void FStreamer::OnProtocolUpdated()
+	namespace
 	{
-		Players.Apply([this](FPixelStreamingPlayerId DataPlayerId, FPlayerContext& PlayerContext) {
-			if (PlayerContext.DataChannel)
+		bool IsSFU(FPixelStreamingPlayerId PlayerId)
+		{
+			return PlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive);
+		}
+
+		// Queues the message, following it through the send queue only when someone wants to hear that it failed.
+		// Returns whether it was queued, which is always the case when it is followed as any failure goes to OnFailed instead.
+		bool SendBufferTo(const FPixelStreamingDataChannel& DataChannel, FPixelStreamingPlayerId PlayerId, const rtc::CopyOnWriteBuffer& Buffer, const TFunction<void(FPixelStreamingPlayerId)>& OnFailed)
+		{
+			if (!OnFailed)
 			{
-				SendProtocol(DataPlayerId);
+				return DataChannel.SendBuffer(Buffer);
 			}
-		});
+
+			DataChannel.SendBufferAsync(Buffer).Next([PlayerId, OnFailed](bool bSent) {
+				if (!bSent)
+				{
+					OnFailed(PlayerId);
+				}
+			});
+			return true;
+		}
+	} // namespace
+
+	void FStreamer::OnProtocolUpdated()
+	{
+		// Serialize once for everyone. The SFU forwards nothing itself, the players behind it are sent to directly.
+		for (const rtc::CopyOnWriteBuffer& Message : BuildProtocolMessages())
+		{
+			BroadcastMessage(
+				Message,
+				[](FPixelStreamingPlayerId DataPlayerId, const FPlayerContext& PlayerContext) { return !IsSFU(DataPlayerId); },
+				[](FPixelStreamingPlayerId DataPlayerId) { UE_LOG(LogPixelStreaming, Warning, TEXT("Failed to send Pixel Streaming protocol to player %s. This player will use the default protocol specified in the front end"), *DataPlayerId); });
+		}
 	}
 
 	void FStreamer::SetStreamFPS(int32 InFramesPerSecond)
@@ -320,46 +348,39 @@ namespace UE::PixelStreaming
 		// Force a keyframe so when stream unfreezes if player has never received a h.264 frame before they can still connect.
 		ForceKeyFrame();
 
-		Players.Apply([this](FPixelStreamingPlayerId PlayerId, FPlayerContext& PlayerContext) {
-			if (PlayerContext.DataChannel)
-			{
-				PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("UnfreezeFrame")->GetID());
-			}
-		});
+		BroadcastMessage(FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.UnfreezeFrame.GetID()), [](FPixelStreamingPlayerId PlayerId, const FPlayerContext& PlayerContext) { return true; });
 
 		CachedJpegBytes.Empty();
 	}
 
 	void FStreamer::SendPlayerMessage(uint8 Type, const FString& Descriptor)
 	{
-		Players.Apply([&Type, &Descriptor](FPixelStreamingPlayerId PlayerId, FPlayerContext& PlayerContext) {
-			if (PlayerContext.DataChannel)
-			{
-				PlayerContext.DataChannel->SendMessage(Type, Descriptor);
-			}
-		});
+		BroadcastMessage(FPixelStreamingDataChannel::BuildMessage(Type, Descriptor), [](FPixelStreamingPlayerId PlayerId, const FPlayerContext& PlayerContext) { return true; });
 	}
 
 	void FStreamer::SendFileData(const TArray64<uint8>& ByteData, FString& MimeType, FString& FileExtension)
 	{
-		// TODO this should be dispatched as an async task, but because we lock when we visit the data
-		// channels it might be a bad idea. At some point it would be good to take a snapshot of the
-		// keys in the map when we start, then one by one get the channel and send the data
+		// Serialize once, every player is sent the same buffers
+		const rtc::CopyOnWriteBuffer MimeTypeMessage = FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.FileMimeType.GetID(), MimeType);
+		const rtc::CopyOnWriteBuffer FileExtensionMessage = FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.FileExtension.GetID(), FileExtension);
+		const TSharedRef<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe> FileContentsChunks = MakeShared<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe>(FPixelStreamingDataChannel::BuildArbitraryData(FromStreamerMessages.FileContents.GetID(), ByteData));
 
-		Players.Apply([&ByteData, &MimeType, &FileExtension, this](FPixelStreamingPlayerId PlayerId, FPlayerContext& PlayerContext) {
+		Players.Apply([&MimeTypeMessage, &FileExtensionMessage, &FileContentsChunks](FPixelStreamingPlayerId PlayerId, FPlayerContext& PlayerContext) {
 			if (PlayerContext.DataChannel)
 			{
 				// Send the mime type first
-				PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("FileMimeType")->GetID(), MimeType);
+				PlayerContext.DataChannel->SendBuffer(MimeTypeMessage);
 
 				// Send the extension next
-				PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("FileExtension")->GetID(), FileExtension);
+				PlayerContext.DataChannel->SendBuffer(FileExtensionMessage);
 
-				// Send the contents of the file. Note to callers: consider running this on its own thread, it can take a while if the file is big.
-				if (!PlayerContext.DataChannel->SendArbitraryData(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("FileContents")->GetID(), ByteData))
-				{
-					UE_LOG(LogPixelStreaming, Error, TEXT("Unable to send file data over the data channel for player %s."), *PlayerId);
-				}
+				// Queue the contents of the file, which go out as the data channel drains rather than holding up the caller
+				PlayerContext.DataChannel->SendArbitraryDataAsync(FileContentsChunks).Next([PlayerId](bool bSent) {
+					if (!bSent)
+					{
+						UE_LOG(LogPixelStreaming, Error, TEXT("Unable to send file data over the data channel for player %s."), *PlayerId);
+					}
+				});
 			}
 		});
 	}
@@ -611,30 +632,7 @@ namespace UE::PixelStreaming
 	{
 		if (StatName == PixelStreamingStatNames::MeanQPPerSecond)
 		{
-            ////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // PluginExt: START
-            // PlayerId が SFU の場合、Players 登録の全ての PlayerId に対して送信するようにします。
-            //
-            if (PlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive))
-            {
-                Players.Apply([&StatValue, this](FPixelStreamingPlayerId DataPlayerId, FPlayerContext& PlayerContext) {
-                    if (!DataPlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive) && PlayerContext.DataChannel)
-                    {
-                        PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("VideoEncoderAvgQP")->GetID(), FString::FromInt((int)StatValue));
-                    }
-                });
-            }
-            else
-            // PluginExt: END
-            ////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-			if (FPlayerContext* PlayerContext = Players.Find(PlayerId))
-			{
-				if (PlayerContext->DataChannel)
-				{
-					PlayerContext->DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("VideoEncoderAvgQP")->GetID(), FString::FromInt((int)StatValue));
-				}
-			}
+			SendOrFanOut(PlayerId, FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.VideoEncoderAvgQP.GetID(), FString::FromInt((int)StatValue)));
 		}
 	}
 
@@ -807,11 +805,15 @@ namespace UE::PixelStreaming
 			}
 		});
 
-		PlayerContext.DataChannel->OnMessageReceived.AddLambda([WeakStreamer, PlayerId](uint8 Type, const webrtc::DataBuffer& RawBuffer) {
+		if (!PlayerContext.PlayerIdHandle)
+		{
+			PlayerContext.PlayerIdHandle = MakeShared<const FString, ESPMode::ThreadSafe>(PlayerId);
+		}
+
+		PlayerContext.DataChannel->OnMessageReceived.AddLambda([WeakStreamer, PlayerIdHandle = PlayerContext.PlayerIdHandle.ToSharedRef()](uint8 Type, const webrtc::DataBuffer& RawBuffer) {
 			if (TSharedPtr<FStreamer> Streamer = WeakStreamer.Pin())
 			{
-
-				Streamer->OnDataChannelMessage(PlayerId, Type, RawBuffer);
+				Streamer->OnDataChannelMessage(PlayerIdHandle, Type, RawBuffer);
 			}
 		});
 	}
@@ -869,56 +871,32 @@ namespace UE::PixelStreaming
 		}
 	}
 
-	void FStreamer::OnDataChannelMessage(FPixelStreamingPlayerId PlayerId, uint8 Type, const webrtc::DataBuffer& RawBuffer)
+	void FStreamer::OnDataChannelMessage(const IPixelStreamingInputHandler::FPlayerIdHandle& PlayerIdHandle, uint8 Type, const webrtc::DataBuffer& RawBuffer)
 	{
-		if (Type == FPixelStreamingInputProtocol::ToStreamerProtocol.Find("RequestQualityControl")->GetID())
+		const FPixelStreamingPlayerId& PlayerId = *PlayerIdHandle;
+		if (Type == ToStreamerMessages.RequestQualityControl.GetID())
 		{
 			UE_LOG(LogPixelStreaming, Log, TEXT("Player %s has requested quality control through the data channel."), *PlayerId);
 			SetQualityController(PlayerId);
 		}
-		else if (Type == FPixelStreamingInputProtocol::ToStreamerProtocol.Find("LatencyTest")->GetID())
+		else if (Type == ToStreamerMessages.LatencyTest.GetID())
 		{
 			SendLatencyReport(PlayerId);
 		}
-		else if (Type == FPixelStreamingInputProtocol::ToStreamerProtocol.Find("RequestInitialSettings")->GetID())
+		else if (Type == ToStreamerMessages.RequestInitialSettings.GetID())
 		{
 			SendInitialSettings(PlayerId);
 		}
-		else if (Type == FPixelStreamingInputProtocol::ToStreamerProtocol.Find("IFrameRequest")->GetID())
+		else if (Type == ToStreamerMessages.IFrameRequest.GetID())
 		{
 			ForceKeyFrame();
 		}
-		else if (Type == FPixelStreamingInputProtocol::ToStreamerProtocol.Find("TestEcho")->GetID())
+		else if (Type == ToStreamerMessages.TestEcho.GetID())
 		{
-			////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			// PluginExt: START
-			// PlayerId が SFU の場合、Players 登録の全ての PlayerId に対して送信するようにします。
-			//
-			if (PlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive))
-			{
-				Players.Apply([&RawBuffer, this](FPixelStreamingPlayerId DataPlayerId, FPlayerContext& PlayerContext) {
-					if (!DataPlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive) && PlayerContext.DataChannel)
-					{
-						const size_t DescriptorSize = (RawBuffer.data.size() - 1) / sizeof(TCHAR);
-						const TCHAR* DescPtr = reinterpret_cast<const TCHAR*>(RawBuffer.data.data() + 1);
-						const FString Message(DescriptorSize, DescPtr);
-						PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("TestEcho")->GetID(), Message);
-					}
-				});
-			}
-			else
-			// PluginExt: END
-			////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			if (FPlayerContext* PlayerContext = Players.Find(PlayerId))
-			{
-				if (PlayerContext->DataChannel)
-				{
-					const size_t DescriptorSize = (RawBuffer.data.size() - 1) / sizeof(TCHAR);
-					const TCHAR* DescPtr = reinterpret_cast<const TCHAR*>(RawBuffer.data.data() + 1);
-					const FString Message(DescriptorSize, DescPtr);
-					PlayerContext->DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("TestEcho")->GetID(), Message);
-				}
-			}
+			const size_t DescriptorSize = (RawBuffer.data.size() - 1) / sizeof(TCHAR);
+			const TCHAR* DescPtr = reinterpret_cast<const TCHAR*>(RawBuffer.data.data() + 1);
+			const FString Message(DescriptorSize, DescPtr);
+			SendOrFanOut(PlayerId, FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.TestEcho.GetID(), Message));
 		}
 		else if (!IsEngineExitRequested())
 		{
@@ -931,15 +909,21 @@ namespace UE::PixelStreaming
 				}
 			}
 
-			TArray<uint8> MessageData(RawBuffer.data.data(), RawBuffer.data.size());
-			OnInputReceived.Broadcast(PlayerId, Type, MessageData);
+			const rtc::CopyOnWriteBuffer& MessageData = RawBuffer.data;
+			if (OnInputReceived.IsBound())
+			{
+				OnInputReceived.Broadcast(PlayerId, Type, TArray<uint8>(MessageData.data(), MessageData.size()));
+			}
 
 			if (InputHandler)
 			{
+				// The input handler shares the buffer WebRTC received the message into, holding a reference to it until dispatched
+				FSharedBuffer Message = FSharedBuffer::TakeOwnership(MessageData.data(), MessageData.size(), [Owner = MessageData](void*) {});
+
 				//////////////////////////////////////////////////////////////////////
 				// PluginExt: START
 				// 引数に PlayerId を追加しました。
-				InputHandler->OnMessage(PlayerId, MessageData);
+				InputHandler->OnMessage(PlayerIdHandle, MoveTemp(Message));
 				// PluginExt: END
 				//////////////////////////////////////////////////////////////////////
 			}
@@ -985,40 +969,15 @@ namespace UE::PixelStreaming
 
 		const FString FullPayload = FString::Printf(TEXT("{ \"PixelStreaming\": %s, \"Encoder\": %s, \"WebRTC\": %s, \"ConfigOptions\": %s }"), *PixelStreamingPayload, *EncoderPayload, *WebRTCPayload, *ConfigPayload);
 
-        ////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        // PluginExt: START
-        // PlayerId が SFU の場合、Players 登録の全ての PlayerId に対して送信するようにします。
-        //
-        if (PlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive))
-        {
-            const_cast<TThreadSafeMap<FPixelStreamingPlayerId,UE::PixelStreaming::FPlayerContext> &>(Players).Apply([&FullPayload, this](FPixelStreamingPlayerId DataPlayerId, FPlayerContext& PlayerContext) {
-                if (!DataPlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive) && PlayerContext.DataChannel)
-                {
-                    if (!PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("InitialSettings")->GetID(), FullPayload))
-                    {
-                        UE_LOG(LogPixelStreaming, Log, TEXT("Failed to send initial Pixel Streaming settings to player %s."), *DataPlayerId);
-                    }
-                }
-            });
-        }
-        else
-        // PluginExt: END
-        ////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-		if (const FPlayerContext* PlayerContext = Players.Find(PlayerId))
-		{
-			if (PlayerContext->DataChannel)
-			{
-				if (!PlayerContext->DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("InitialSettings")->GetID(), FullPayload))
-				{
-					UE_LOG(LogPixelStreaming, Log, TEXT("Failed to send initial Pixel Streaming settings to player %s."), *PlayerId);
-				}
-			}
-		}
+		SendOrFanOut(PlayerId, FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.InitialSettings.GetID(), FullPayload), [](FPixelStreamingPlayerId DataPlayerId) {
+			UE_LOG(LogPixelStreaming, Log, TEXT("Failed to send initial Pixel Streaming settings to player %s."), *DataPlayerId);
+		});
 	}
 
-	void FStreamer::SendProtocol(FPixelStreamingPlayerId PlayerId) const
+	TArray<rtc::CopyOnWriteBuffer> FStreamer::BuildProtocolMessages() const
 	{
+		TArray<rtc::CopyOnWriteBuffer> Messages;
+
 		const TArray<EPixelStreamingMessageDirection> PixelStreamingMessageDirections = { EPixelStreamingMessageDirection::ToStreamer, EPixelStreamingMessageDirection::FromStreamer };
 		for (EPixelStreamingMessageDirection MessageDirection : PixelStreamingMessageDirections)
 		{
@@ -1028,59 +987,56 @@ namespace UE::PixelStreaming
 			if (!ensure(FJsonSerializer::Serialize(ProtocolJson.ToSharedRef(), JsonWriter)))
 			{
 				UE_LOG(LogPixelStreaming, Warning, TEXT("Cannot serialize protocol json object"));
-				return;
+				break;
 			}
 
-			////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			// PluginExt: START
-			// PlayerId が SFU の場合、Players 登録の全ての PlayerId に対して送信するようにします。
-			//
-			if (PlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive))
-			{
-				const_cast<TThreadSafeMap<FPixelStreamingPlayerId,UE::PixelStreaming::FPlayerContext> &>(Players).Apply([&body, this](FPixelStreamingPlayerId DataPlayerId, FPlayerContext& PlayerContext) {
-					if (!DataPlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive) && PlayerContext.DataChannel)
-					{
-						// Log a warning if we are unable to send our updated protocol
-						if (!PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("Protocol")->GetID(), body))
-						{
-							UE_LOG(LogPixelStreaming, Warning, TEXT("Failed to send Pixel Streaming protocol to player %s. This player will use the default protocol specified in the front end"), *DataPlayerId);
-						}
-					}
-				});
-			}
-			else
-			// PluginExt: END
-			////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			if (const FPlayerContext* PlayerContext = Players.Find(PlayerId))
-			{
-				if (PlayerContext->DataChannel)
-				{
-					// Log a warning if we are unable to send our updated protocol
-					if (!PlayerContext->DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("Protocol")->GetID(), body))
-					{
-						UE_LOG(LogPixelStreaming, Warning, TEXT("Failed to send Pixel Streaming protocol to player %s. This player will use the default protocol specified in the front end"), *PlayerId);
-					}
-				}
-			}
+			Messages.Add(FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.Protocol.GetID(), body));
+		}
+
+		return Messages;
+	}
+
+	void FStreamer::SendProtocol(FPixelStreamingPlayerId PlayerId) const
+	{
+		for (const rtc::CopyOnWriteBuffer& Message : BuildProtocolMessages())
+		{
+			SendOrFanOut(PlayerId, Message, [](FPixelStreamingPlayerId DataPlayerId) {
+				// Log a warning if we are unable to send our updated protocol
+				UE_LOG(LogPixelStreaming, Warning, TEXT("Failed to send Pixel Streaming protocol to player %s. This player will use the default protocol specified in the front end"), *DataPlayerId);
+			});
 		}
 	}
 
 	void FStreamer::SendPeerControllerMessages(FPixelStreamingPlayerId PlayerId) const
 	{
+		// A player either holds control or does not, so two messages of each kind cover every player however many there are
+		const rtc::CopyOnWriteBuffer InputControlMessages[] = {
+			FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.InputControlOwnership.GetID(), static_cast<uint8>(0)),
+			FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.InputControlOwnership.GetID(), static_cast<uint8>(1))
+		};
+		const rtc::CopyOnWriteBuffer QualityControlMessages[] = {
+			FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.QualityControlOwnership.GetID(), static_cast<uint8>(0)),
+			FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.QualityControlOwnership.GetID(), static_cast<uint8>(1))
+		};
+
+		const bool bHostMode = Settings::GetInputControllerMode() == Settings::EInputControllerMode::Host;
+		auto SendTo = [&](FPixelStreamingPlayerId DataPlayerId, const FPlayerContext& PlayerContext) {
+			const uint8 ControlsInput = bHostMode ? (DataPlayerId == InputControllingId) : 1;
+			const uint8 ControlsQuality = DataPlayerId == QualityControllingId ? 1 : 0;
+			PlayerContext.DataChannel->SendBuffer(InputControlMessages[ControlsInput]);
+			PlayerContext.DataChannel->SendBuffer(QualityControlMessages[ControlsQuality]);
+		};
 
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		// PluginExt: START
 		// PlayerId が SFU の場合、Players 登録の全ての PlayerId に対して送信するようにします。
 		//
-		if (PlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive))
+		if (IsSFU(PlayerId))
 		{
-			const_cast<TThreadSafeMap<FPixelStreamingPlayerId,UE::PixelStreaming::FPlayerContext> &>(Players).Apply([this](FPixelStreamingPlayerId DataPlayerId, FPlayerContext& PlayerContext) {
-				if (!DataPlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive) && PlayerContext.DataChannel)
+			Players.Apply([&SendTo](FPixelStreamingPlayerId DataPlayerId, const FPlayerContext& PlayerContext) {
+				if (!IsSFU(DataPlayerId) && PlayerContext.DataChannel)
 				{
-					const uint8 ControlsInput = (Settings::GetInputControllerMode() == Settings::EInputControllerMode::Host) ? (DataPlayerId == InputControllingId) : 1;
-					const uint8 ControlsQuality = DataPlayerId == QualityControllingId ? 1 : 0;
-					PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("InputControlOwnership")->GetID(), ControlsInput);
-					PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("QualityControlOwnership")->GetID(), ControlsQuality);
+					SendTo(DataPlayerId, PlayerContext);
 				}
 			});
 		}
@@ -1092,10 +1048,7 @@ namespace UE::PixelStreaming
 		{
 			if (PlayerContext->DataChannel)
 			{
-				const uint8 ControlsInput = (Settings::GetInputControllerMode() == Settings::EInputControllerMode::Host) ? (PlayerId == InputControllingId) : 1;
-				const uint8 ControlsQuality = PlayerId == QualityControllingId ? 1 : 0;
-				PlayerContext->DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("InputControlOwnership")->GetID(), ControlsInput);
-				PlayerContext->DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("QualityControlOwnership")->GetID(), ControlsQuality);
+				SendTo(PlayerId, *PlayerContext);
 			}
 		}
 	}
@@ -1142,29 +1095,7 @@ namespace UE::PixelStreaming
 					TransmissionTimeMs);
 			}
 
-			////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			// PluginExt: START
-			// PlayerId が SFU の場合、Players 登録の全ての PlayerId に対して送信するようにします。
-			//
-			if (PlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive))
-			{
-				const_cast<TThreadSafeMap<FPixelStreamingPlayerId,UE::PixelStreaming::FPlayerContext> &>(Players).Apply([&ReportToTransmitJSON, this](FPixelStreamingPlayerId DataPlayerId, FPlayerContext& PlayerContext) {
-					if (!DataPlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive) && PlayerContext.DataChannel)
-					{
-						PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("LatencyTest")->GetID(), ReportToTransmitJSON);
-					}
-				});
-			}
-			else
-			// PluginExt: END
-			////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			if (const FPlayerContext* PlayerContext = Players.Find(PlayerId))
-			{
-				if (PlayerContext->DataChannel)
-				{
-					PlayerContext->DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("LatencyTest")->GetID(), ReportToTransmitJSON);
-				}
-			}
+			SendOrFanOut(PlayerId, FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.LatencyTest.GetID(), ReportToTransmitJSON));
 		});
 	}
 
@@ -1178,12 +1109,9 @@ namespace UE::PixelStreaming
 			// Compress to a JPEG of the maximum possible quality.
 			int32 Quality = Settings::CVarPixelStreamingFreezeFrameQuality.GetValueOnAnyThread();
 			const TArray64<uint8>& JpegBytes = ImageWrapper->GetCompressed(Quality);
-			Players.Apply([&JpegBytes, this](FPixelStreamingPlayerId PlayerId, FPlayerContext& PlayerContext) {
-				if (PlayerContext.DataChannel)
-				{
-					PlayerContext.DataChannel->SendArbitraryData(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("FreezeFrame")->GetID(), JpegBytes);
-				}
-			});
+			BroadcastArbitraryData(
+				MakeShared<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe>(FPixelStreamingDataChannel::BuildArbitraryData(FromStreamerMessages.FreezeFrame.GetID(), JpegBytes)),
+				[](FPixelStreamingPlayerId PlayerId, const FPlayerContext& PlayerContext) { return true; });
 			CachedJpegBytes = JpegBytes;
 		}
 		else
@@ -1196,19 +1124,15 @@ namespace UE::PixelStreaming
 	{
 		if (CachedJpegBytes.Num() > 0)
 		{
+			const TSharedRef<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe> Chunks = MakeShared<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe>(FPixelStreamingDataChannel::BuildArbitraryData(FromStreamerMessages.FreezeFrame.GetID(), CachedJpegBytes));
+
 			////////////////////////////////////////////////////////////////////////////////////////////////////////////
 			// PluginExt: START
 			// PlayerId が SFU の場合、Players 登録の全ての PlayerId に対して送信するようにします。
 			//
-			if (PlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive))
+			if (IsSFU(PlayerId))
 			{
-				const TArray64<uint8>& CopiedCachedJpegBytes = CachedJpegBytes;
-				const_cast<TThreadSafeMap<FPixelStreamingPlayerId, UE::PixelStreaming::FPlayerContext>&>(Players).Apply([&CopiedCachedJpegBytes, this](FPixelStreamingPlayerId DataPlayerId, FPlayerContext& PlayerContext) {
-					if (!DataPlayerId.Equals(TEXT("SFU"), ESearchCase::CaseSensitive) && PlayerContext.DataChannel)
-					{
-						PlayerContext.DataChannel->SendArbitraryData(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("FreezeFrame")->GetID(), CopiedCachedJpegBytes);
-					}
-				});
+				BroadcastArbitraryData(Chunks, [](FPixelStreamingPlayerId DataPlayerId, const FPlayerContext& PlayerContext) { return !IsSFU(DataPlayerId); });
 			}
 			else
 			// PluginExt: END
@@ -1217,9 +1141,78 @@ namespace UE::PixelStreaming
 			{
 				if (PlayerContext->DataChannel)
 				{
-					PlayerContext->DataChannel->SendArbitraryData(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("FreezeFrame")->GetID(), CachedJpegBytes);
+					PlayerContext->DataChannel->SendArbitraryDataAsync(Chunks);
+				}
+			}
+		}
+	}
+
+	int32 FStreamer::BroadcastMessage(const rtc::CopyOnWriteBuffer& Buffer, FBroadcastFilter Filter) const
+	{
+		return BroadcastMessage(Buffer, Filter, nullptr);
+	}
+
+	int32 FStreamer::BroadcastMessage(const rtc::CopyOnWriteBuffer& Buffer, FBroadcastFilter Filter, FBroadcastFailed OnFailed) const
+	{
+		int32 NumQueued = 0;
+		Players.Apply([&Buffer, &Filter, &OnFailed, &NumQueued](FPixelStreamingPlayerId PlayerId, const FPlayerContext& PlayerContext) {
+			if (PlayerContext.DataChannel && Filter(PlayerId, PlayerContext))
+			{
+				if (SendBufferTo(*PlayerContext.DataChannel, PlayerId, Buffer, OnFailed))
+				{
+					NumQueued++;
 				}
 			}
+		});
+		return NumQueued;
+	}
+
+	int32 FStreamer::BroadcastArbitraryData(TSharedRef<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe> Chunks, FBroadcastFilter Filter) const
+	{
+		int32 NumQueued = 0;
+		Players.Apply([&Chunks, &Filter, &NumQueued](FPixelStreamingPlayerId PlayerId, const FPlayerContext& PlayerContext) {
+			if (PlayerContext.DataChannel && Filter(PlayerId, PlayerContext))
+			{
+				PlayerContext.DataChannel->SendArbitraryDataAsync(Chunks).Next([PlayerId](bool bSent) {
+					if (!bSent)
+					{
+						UE_LOG(LogPixelStreaming, Error, TEXT("Unable to send data over the data channel for player %s."), *PlayerId);
+					}
+				});
+				NumQueued++;
+			}
+		});
+		return NumQueued;
+	}
+
+	void FStreamer::SendOrFanOut(FPixelStreamingPlayerId PlayerId, const rtc::CopyOnWriteBuffer& Buffer) const
+	{
+		SendOrFanOut(PlayerId, Buffer, nullptr);
+	}
+
+	void FStreamer::SendOrFanOut(FPixelStreamingPlayerId PlayerId, const rtc::CopyOnWriteBuffer& Buffer, FBroadcastFailed OnFailed) const
+	{
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// PluginExt: START
+		// PlayerId が SFU の場合、Players 登録の全ての PlayerId に対して送信するようにします。
+		//
+		if (IsSFU(PlayerId))
+		{
+			BroadcastMessage(
+				Buffer,
+				[](FPixelStreamingPlayerId DataPlayerId, const FPlayerContext& PlayerContext) { return !IsSFU(DataPlayerId); },
+				OnFailed);
+			return;
+		}
+		// PluginExt: END
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		if (const FPlayerContext* PlayerContext = Players.Find(PlayerId))
+		{
+			if (PlayerContext->DataChannel)
+			{
+				SendBufferTo(*PlayerContext->DataChannel, PlayerId, Buffer, OnFailed);
+			}
 		}
 	}
 
@@ -1265,13 +1258,14 @@ namespace UE::PixelStreaming
 	void FStreamer::SetQualityController(FPixelStreamingPlayerId PlayerId)
 	{
 		QualityControllingId = PlayerId;
-		Players.Apply([this](FPixelStreamingPlayerId DataPlayerId, FPlayerContext& PlayerContext) {
-			if (PlayerContext.DataChannel)
-			{
-				const uint8 IsController = DataPlayerId == QualityControllingId ? 1 : 0;
-				PlayerContext.DataChannel->SendMessage(FPixelStreamingInputProtocol::FromStreamerProtocol.Find("QualityControlOwnership")->GetID(), IsController);
-			}
-		});
+
+		// Only the controller is told it has control, everyone else shares the message saying they do not
+		BroadcastMessage(
+			FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.QualityControlOwnership.GetID(), static_cast<uint8>(1)),
+			[this](FPixelStreamingPlayerId DataPlayerId, const FPlayerContext& PlayerContext) { return DataPlayerId == QualityControllingId; });
+		BroadcastMessage(
+			FPixelStreamingDataChannel::BuildMessage(FromStreamerMessages.QualityControlOwnership.GetID(), static_cast<uint8>(0)),
+			[this](FPixelStreamingPlayerId DataPlayerId, const FPlayerContext& PlayerContext) { return DataPlayerId != QualityControllingId; });
 		if (UPixelStreamingDelegates* Delegates = UPixelStreamingDelegates::GetPixelStreamingDelegates())
 		{
 			Delegates->OnQualityControllerChangedNative.Broadcast(StreamerId, QualityControllingId);
@@ -1288,7 +1282,7 @@ namespace UE::PixelStreaming
 			// Force a MouseLeave event. This prevents the PixelStreamingApplicationWrapper from
 			// still wrapping the base FSlateApplication after we stop streaming
 			TArray<uint8> EmptyArray;
-			TFunction<void(FString, FMemoryReader)> MouseLeaveHandler = InputHandler->FindMessageHandler("MouseLeave");
+			TFunction<void(const FString&, FMemoryReader)> MouseLeaveHandler = InputHandler->FindMessageHandler("MouseLeave");
 			// TFunction<void(FMemoryReader)> MouseLeaveHandler = InputHandler->FindMessageHandler("MouseLeave");
 			// MouseLeaveHandler(FMemoryReader(EmptyArray));
 			// PluginExt: END
@@ -1433,7 +1427,7 @@ namespace UE::PixelStreaming
 
 	void FStreamer::clearGamepadAnalog(FPixelStreamingPlayerId PlayerId, const uint8 AxisIndex)
 	{
-		const uint8 MsgType = FPixelStreamingInputProtocol::ToStreamerProtocol.Find("GamepadAnalog")->GetID();
+		const uint8 MsgType = ToStreamerMessages.GamepadAnalog.GetID();
 		const uint8 ControllerId = PlayerIdToInt(PlayerId) & 0xFF;
 		const char data[] = {
 			MsgType,							   // MsgType
@@ -1442,12 +1436,12 @@ namespace UE::PixelStreaming
 			0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0 // analogValue
 		};
 		const webrtc::DataBuffer Buffer(rtc::CopyOnWriteBuffer(data, sizeof(data)), true);
-		OnDataChannelMessage(PlayerId, MsgType, Buffer);
+		OnDataChannelMessage(MakeShared<const FString, ESPMode::ThreadSafe>(PlayerId), MsgType, Buffer);
 	}
 
 	void FStreamer::clearGamepadButton(FPixelStreamingPlayerId PlayerId, const uint8 ButtonIndex)
 	{
-		const uint8 MsgType = FPixelStreamingInputProtocol::ToStreamerProtocol.Find("GamepadButtonReleased")->GetID();
+		const uint8 MsgType = ToStreamerMessages.GamepadButtonReleased.GetID();
 		const uint8 ControllerId = PlayerIdToInt(PlayerId) & 0xFF;
 		const char data[] = {
 			MsgType,	  // MsgType
@@ -1455,7 +1449,7 @@ namespace UE::PixelStreaming
 			ButtonIndex,  // ButtonIndex
 		};
 		const webrtc::DataBuffer Buffer(rtc::CopyOnWriteBuffer(data, sizeof(data)), true);
-		OnDataChannelMessage(PlayerId, MsgType, Buffer);
+		OnDataChannelMessage(MakeShared<const FString, ESPMode::ThreadSafe>(PlayerId), MsgType, Buffer);
 	}
 
 	// -----------------------------------------------------------------------------------------------
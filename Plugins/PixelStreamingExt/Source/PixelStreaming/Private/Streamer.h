@@ -6,12 +6,13 @@
 #include "IPixelStreamingSignallingConnectionObserver.h"
 #include "PixelStreamingPeerConnection.h"
 #include "VideoSourceGroup.h"
-#include "ThreadSafeMap.h"
+#include "SnapshotMap.h"
 #include "Dom/JsonObject.h"
 #include "IPixelStreamingInputHandler.h"
 #include "PixelStreamingSignallingConnection.h"
 #include "Templates/SharedPointer.h"
 #include "PlayerContext.h"
+#include "PixelStreamingInputProtocol.h"
 
 class IPixelStreamingModule;
 
@@ -98,7 +99,7 @@ namespace UE::PixelStreaming
 		void AddNewDataChannel(FPixelStreamingPlayerId PlayerId, TSharedPtr<FPixelStreamingDataChannel> NewChannel);
 		void OnDataChannelOpen(FPixelStreamingPlayerId PlayerId);
 		void OnDataChannelClosed(FPixelStreamingPlayerId PlayerId);
-		void OnDataChannelMessage(FPixelStreamingPlayerId PlayerId, uint8 Type, const webrtc::DataBuffer& RawBuffer);
+		void OnDataChannelMessage(const IPixelStreamingInputHandler::FPlayerIdHandle& PlayerIdHandle, uint8 Type, const webrtc::DataBuffer& RawBuffer);
 		void SendInitialSettings(FPixelStreamingPlayerId PlayerId) const;
 		void SendProtocol(FPixelStreamingPlayerId PlayerId) const;
 		void SendPeerControllerMessages(FPixelStreamingPlayerId PlayerId) const;
@@ -107,6 +108,34 @@ namespace UE::PixelStreaming
 		void SendCachedFreezeFrameTo(FPixelStreamingPlayerId PlayerId) const;
 		bool ShouldPeerGenerateFrames(FPixelStreamingPlayerId PlayerId) const;
 
+		// Decides which players a broadcast goes to
+		using FBroadcastFilter = TFunctionRef<bool(FPixelStreamingPlayerId, const FPlayerContext&)>;
+		// Called for each player a message did not go out to, once its data channel finds out and on whichever thread that is
+		using FBroadcastFailed = TFunction<void(FPixelStreamingPlayerId)>;
+
+		/**
+		 * Sends an already serialized message to every player with a data channel that passes the filter.
+		 * Every channel is handed a reference to the same buffer, so the cost grows with the number of channels rather than with serializing per player.
+		 * Sends are only tracked when there is an OnFailed to hear about them, as that costs a promise per player.
+		 * @returns The number of players the message was queued to.
+		 */
+		int32 BroadcastMessage(const rtc::CopyOnWriteBuffer& Buffer, FBroadcastFilter Filter) const;
+		int32 BroadcastMessage(const rtc::CopyOnWriteBuffer& Buffer, FBroadcastFilter Filter, FBroadcastFailed OnFailed) const;
+
+		/**
+		 * Queues data split with FPixelStreamingDataChannel::BuildArbitraryData to every player with a data channel that passes the filter.
+		 * Returns without waiting for the data to go out, every channel shares the same chunks.
+		 * @returns The number of players the data was queued to.
+		 */
+		int32 BroadcastArbitraryData(TSharedRef<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe> Chunks, FBroadcastFilter Filter) const;
+
+		// Sends to the player, or when the player is the SFU to every player behind it
+		void SendOrFanOut(FPixelStreamingPlayerId PlayerId, const rtc::CopyOnWriteBuffer& Buffer) const;
+		void SendOrFanOut(FPixelStreamingPlayerId PlayerId, const rtc::CopyOnWriteBuffer& Buffer, FBroadcastFailed OnFailed) const;
+
+		// Serializes the protocol in both directions, ready to be sent to any player
+		TArray<rtc::CopyOnWriteBuffer> BuildProtocolMessages() const;
+
 		void SetQualityController(FPixelStreamingPlayerId PlayerId);
 		void TriggerMouseLeave(FString InStreamerId);
 
@@ -122,7 +151,7 @@ namespace UE::PixelStreaming
 
 		webrtc::PeerConnectionInterface::RTCConfiguration PeerConnectionConfig;
 
-		TThreadSafeMap<FPixelStreamingPlayerId, FPlayerContext> Players;
+		TSnapshotMap<FPixelStreamingPlayerId, FPlayerContext> Players;
 
 		FPixelStreamingPlayerId QualityControllingId = INVALID_PLAYER_ID;
 		FPixelStreamingPlayerId SFUPlayerId = INVALID_PLAYER_ID;
@@ -149,6 +178,37 @@ namespace UE::PixelStreaming
 
 		TMap<FName, FString> ConfigOptions;
 
+		// Messages this streamer sends to or handles from players, resolved to their ids once rather than looked up by name on every message.
+		struct FFromStreamerMessages
+		{
+			FInputProtocolMessageHandle FileContents{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("FileContents") };
+			FInputProtocolMessageHandle FileExtension{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("FileExtension") };
+			FInputProtocolMessageHandle FileMimeType{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("FileMimeType") };
+			FInputProtocolMessageHandle FreezeFrame{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("FreezeFrame") };
+			FInputProtocolMessageHandle InitialSettings{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("InitialSettings") };
+			FInputProtocolMessageHandle InputControlOwnership{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("InputControlOwnership") };
+			FInputProtocolMessageHandle LatencyTest{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("LatencyTest") };
+			FInputProtocolMessageHandle Protocol{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("Protocol") };
+			FInputProtocolMessageHandle QualityControlOwnership{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("QualityControlOwnership") };
+			FInputProtocolMessageHandle TestEcho{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("TestEcho") };
+			FInputProtocolMessageHandle UnfreezeFrame{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("UnfreezeFrame") };
+			FInputProtocolMessageHandle VideoEncoderAvgQP{ FPixelStreamingInputProtocol::FromStreamerProtocol, TEXT("VideoEncoderAvgQP") };
+		};
+
+		struct FToStreamerMessages
+		{
+			FInputProtocolMessageHandle GamepadAnalog{ FPixelStreamingInputProtocol::ToStreamerProtocol, TEXT("GamepadAnalog") };
+			FInputProtocolMessageHandle GamepadButtonReleased{ FPixelStreamingInputProtocol::ToStreamerProtocol, TEXT("GamepadButtonReleased") };
+			FInputProtocolMessageHandle IFrameRequest{ FPixelStreamingInputProtocol::ToStreamerProtocol, TEXT("IFrameRequest") };
+			FInputProtocolMessageHandle LatencyTest{ FPixelStreamingInputProtocol::ToStreamerProtocol, TEXT("LatencyTest") };
+			FInputProtocolMessageHandle RequestInitialSettings{ FPixelStreamingInputProtocol::ToStreamerProtocol, TEXT("RequestInitialSettings") };
+			FInputProtocolMessageHandle RequestQualityControl{ FPixelStreamingInputProtocol::ToStreamerProtocol, TEXT("RequestQualityControl") };
+			FInputProtocolMessageHandle TestEcho{ FPixelStreamingInputProtocol::ToStreamerProtocol, TEXT("TestEcho") };
+		};
+
+		FFromStreamerMessages FromStreamerMessages;
+		FToStreamerMessages ToStreamerMessages;
+
 	//////////////////////////////////////////////////////////////////////////////////////////////////
 	// PluginExt: START
 	public:
@@ -5,6 +5,7 @@
 #include "FrameBufferRHI.h"
 #include "PixelStreamingPrivate.h"
 #include "PixelStreamingTrace.h"
+#include "Stats.h"
 
 namespace UE::PixelStreaming
 {
@@ -62,6 +63,8 @@ namespace UE::PixelStreaming
 
 				Output->Decoded(Frame, rtc::TimeMillis() - TimestampDecodeStart, input_image.qp_);
 
+				ReportFrameTiming();
+
 				return WEBRTC_VIDEO_CODEC_OK;
 			}
 		}
@@ -77,6 +80,32 @@ namespace UE::PixelStreaming
 		return WEBRTC_VIDEO_CODEC_ERROR;
 	}
 
+	void VideoDecoderH265::ReportFrameTiming() const
+	{
+		// Decoders that parse the bitstream leave the SEI of the last access unit on the instance
+		FVideoDecoderConfigH265 const* const Config = Decoder->GetInstance()->TryEdit<FVideoDecoderConfigH265>();
+		if (Config == nullptr)
+		{
+			return;
+		}
+
+		for (TSharedPtr<UE::AVCodecCore::H265::FNaluSEI> const& SEI : Config->ParsedSEI)
+		{
+			UE::AVCodecCore::SEI::FFrameTiming FrameTiming;
+			if (FrameTiming.Deserialize(SEI->Messages))
+			{
+				// Only meaningful when the sender's clock is in sync with ours
+				double const LatencyMs = (rtc::TimeUTCMicros() - FrameTiming.CaptureTimeUs) / 1000.0;
+				double const EncodeMs = (FrameTiming.EncodeEndTimeUs - FrameTiming.EncodeStartTimeUs) / 1000.0;
+
+				FStats::Get()->StoreApplicationStat(FStatData(FName(TEXT("Decoder Capture To Decode Latency")), LatencyMs, 2, true));
+				FStats::Get()->StoreApplicationStat(FStatData(FName(TEXT("Decoder Remote Encode Time")), EncodeMs, 2, true));
+
+				return;
+			}
+		}
+	}
+
 	int32 VideoDecoderH265::RegisterDecodeCompleteCallback(webrtc::DecodedImageCallback* callback)
 	{
 		Output = callback;
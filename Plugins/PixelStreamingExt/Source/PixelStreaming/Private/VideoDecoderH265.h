@@ -22,6 +22,9 @@ namespace UE::PixelStreaming
 		virtual const char* ImplementationName() const { return "VideoDecoderH265"; }
 
 	private:
+		// Publish the latency of the last decoded frame if the sender embedded its capture time
+		void ReportFrameTiming() const;
+
 		TSharedPtr<TVideoDecoder<FVideoResourceRHI, FVideoDecoderConfigH265>> Decoder;
 
 		webrtc::DecodedImageCallback* Output = nullptr;
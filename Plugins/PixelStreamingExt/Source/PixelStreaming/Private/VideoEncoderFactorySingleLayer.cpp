@@ -218,6 +218,35 @@ namespace UE::PixelStreaming
 		ActiveEncoders.Remove(Encoder);
 	}
 
+	TSharedPtr<FVideoEncodeSession> FVideoEncoderFactorySingleLayer::GetOrCreateEncodeSession(uint32 StreamId)
+	{
+		FScopeLock InitLock(&InitEncoderGuard);
+
+		FreeUnusedEncoders();
+
+		if (TSharedPtr<FVideoEncodeSession>* ExistingSession = EncodeSessions.Find(StreamId))
+		{
+			return *ExistingSession;
+		}
+
+		FVideoKeyframeArbiter const KeyframeArbiter(
+			Settings::CVarPixelStreamingEncoderKeyframeCoalesceWindowMs.GetValueOnAnyThread() / 1000.0,
+			Settings::CVarPixelStreamingEncoderMinKeyframeSpacingMs.GetValueOnAnyThread() / 1000.0,
+			Settings::CVarPixelStreamingEncoderIntraRefreshPeriodFrames.GetValueOnAnyThread() > 0);
+
+		// Every peer on the stream queues frames on the one encoder, so frames in flight are bounded for it rather than for each peer
+		TUniquePtr<FVideoEncodeAdmission> Admission;
+		const int32 FramesInFlight = Settings::CVarPixelStreamingEncoderFramesInFlight.GetValueOnAnyThread();
+		if (FramesInFlight > 0 && Settings::CVarPixelStreamingEncoderDropLateFrames.GetValueOnAnyThread())
+		{
+			Admission = MakeUnique<FVideoEncodeAdmission>(FramesInFlight);
+		}
+
+		TSharedPtr<FVideoEncodeSession> EncodeSession = MakeShared<FVideoEncodeSession>(Settings::GetSharedRatePolicy(), KeyframeArbiter, MoveTemp(Admission));
+		EncodeSessions.Add(StreamId, EncodeSession);
+		return EncodeSession;
+	}
+
 	void FVideoEncoderFactorySingleLayer::FreeUnusedEncoders()
 	{
 		// first clear unused encoders.
@@ -233,6 +262,20 @@ namespace UE::PixelStreaming
 		{
 			HardwareEncoders.Remove(DeleteStreamId);
 		}
+
+		// then any sessions no peer is subscribed to anymore
+		DeleteStreamIds.Reset();
+		for (auto&& [SessionStreamId, SessionPtr] : EncodeSessions)
+		{
+			if (SessionPtr.IsUnique())
+			{
+				DeleteStreamIds.Add(SessionStreamId);
+			}
+		}
+		for (uint32 DeleteStreamId : DeleteStreamIds)
+		{
+			EncodeSessions.Remove(DeleteStreamId);
+		}
 	}
 
 	void FVideoEncoderFactorySingleLayer::ForceKeyFrame()
@@ -6,6 +6,7 @@
 #include "Video/VideoEncoder.h"
 #include "Video/Encoders/Configs/VideoEncoderConfigH264.h"
 #include "Video/Encoders/Configs/VideoEncoderConfigH265.h"
+#include "Video/Encoders/VideoEncodeSession.h"
 #include "Video/Resources/VideoResourceRHI.h"
 
 #include "PixelStreamingPrivate.h"
@@ -73,11 +74,17 @@ namespace UE::PixelStreaming
 			}
 		}
 
+		/**
+		 * Every peer encoding the same stream shares one session, so the stream is encoded once per frame at a rate that suits all of them.
+		 */
+		TSharedPtr<FVideoEncodeSession> GetOrCreateEncodeSession(uint32 StreamId);
+
 	private:
 		void FreeUnusedEncoders();
 		bool CheckEncoderSessionAvailable() const;
 
 		TMap<uint32, TSharedPtr<FVideoEncoderHardware>> HardwareEncoders;
+		TMap<uint32, TSharedPtr<FVideoEncodeSession>> EncodeSessions;
 
 		uint8 bForceNextKeyframe : 1;
 
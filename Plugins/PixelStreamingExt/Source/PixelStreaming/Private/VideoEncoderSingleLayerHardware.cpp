@@ -6,12 +6,17 @@
 #include "Settings.h"
 #include "HAL/PlatformFileManager.h"
 #include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
 #include "Stats.h"
 #include "PixelStreamingPeerConnection.h"
 #include "PixelCaptureOutputFrameRHI.h"
 #include "PixelCaptureBufferFormat.h"
 #include "PixelStreamingTrace.h"
 #include "FrameBufferRHI.h"
+#include "EncodedImageBufferPacket.h"
+#include "PixelStreamingStatNames.h"
+#include "Video/CodecUtils/CodecUtilsH264.h"
+#include "Video/CodecUtils/CodecUtilsH265.h"
 
 namespace UE::PixelStreaming
 {
@@ -23,9 +28,23 @@ namespace UE::PixelStreaming
 
 	FVideoEncoderSingleLayerHardware::~FVideoEncoderSingleLayerHardware()
 	{
+		// Deliver anything still in flight while this encoder can still be found by the factory
+		Pipeline.Reset();
+
+		if (EncodeSession.IsValid())
+		{
+			EncodeSession->Unsubscribe(this);
+		}
+
 		Factory.ReleaseVideoEncoder(this);
 	}
 
+	// Frame metadata is stamped with FPlatformTime cycles, which only mean something on this machine
+	int64 CyclesToUnixMicroseconds(uint64 Cycles, uint64 NowCycles, int64 NowUnixUs)
+	{
+		return NowUnixUs - static_cast<int64>(FPlatformTime::ToSeconds64(NowCycles - FMath::Min(Cycles, NowCycles)) * 1000000.0);
+	}
+
 	void SetInitialSettings(webrtc::VideoCodec const* InCodecSettings, FVideoEncoderConfig& VideoConfig)
 	{
 		VideoConfig.Preset = PixelStreaming::Settings::GetEncoderPreset();
@@ -45,7 +64,11 @@ namespace UE::PixelStreaming
 
 	int FVideoEncoderSingleLayerHardware::InitEncode(webrtc::VideoCodec const* InCodecSettings, VideoEncoder::Settings const& Settings)
 	{
-		WebRtcProposedTargetBitrate = InCodecSettings->startBitrate;
+		const int32 FramesInFlight = PixelStreaming::Settings::CVarPixelStreamingEncoderFramesInFlight.GetValueOnAnyThread();
+		if (FramesInFlight > 0 && !Pipeline.IsValid())
+		{
+			Pipeline = MakeUnique<FVideoEncodePipeline>(FramesInFlight, TEXT("PixelStreaming Hardware Encoder"));
+		}
 
 		switch (Codec)
 		{
@@ -90,6 +113,11 @@ namespace UE::PixelStreaming
 
 	int32 FVideoEncoderSingleLayerHardware::Release()
 	{
+		if (Pipeline.IsValid())
+		{
+			Pipeline->Flush();
+		}
+
 		OnEncodedImageCallback = nullptr;
 		return WEBRTC_VIDEO_CODEC_OK;
 	}
@@ -162,6 +190,18 @@ namespace UE::PixelStreaming
 				break;
 			}
 		}
+
+		EncodeSession = Factory.GetOrCreateEncodeSession(StreamId);
+		EncodeSession->Subscribe(this);
+
+		// Only counts for whoever created the encoder, later peers find it already running at whatever has been applied since
+		EncodeSession->SeedAppliedRate({ InitialVideoConfig->TargetBitrate, static_cast<double>(InitialVideoConfig->TargetFramerate) });
+
+		if (PendingRateChange.IsSet())
+		{
+			EncodeSession->SetRate(this, PendingRateChange.GetValue());
+			PendingRateChange.Reset();
+		}
 	}
 
 	int32 FVideoEncoderSingleLayerHardware::Encode(webrtc::VideoFrame const& frame, std::vector<webrtc::VideoFrameType> const* frame_types)
@@ -188,9 +228,44 @@ namespace UE::PixelStreaming
 				return WEBRTC_VIDEO_CODEC_OK;
 			}
 
-			UpdateConfig(AdaptedLayer->GetWidth(), AdaptedLayer->GetHeight());
+			// Whoever encodes the next frame for the stream honours the request, which may not be us, once the session's arbiter lets it through
+			if (frame_types && (*frame_types)[0] == webrtc::VideoFrameType::kVideoFrameKey)
+			{
+				EncodeSession->RequestKeyframe(this);
+			}
+
+			// Forced from the application rather than asked for by a peer, so nobody can make do with intra refresh
+			if (Factory.ShouldForceKeyframe())
+			{
+				EncodeSession->RequestKeyframe();
+				Factory.UnforceKeyFrame();
+			}
+
+			// The next frame is assumed to follow as soon after this one as this one did after the last
+			double const FrameIntervalSeconds = LastFrameTimestampUs > 0 ? (frame.timestamp_us() - LastFrameTimestampUs) / 1000000.0 : 0.0;
+			LastFrameTimestampUs = frame.timestamp_us();
+
+			// Capture outputs are pooled, so the capture time tells a reused output apart from the frame it last held
+			uint64 const FrameKey = static_cast<uint64>(reinterpret_cast<UPTRINT>(AdaptedLayer)) ^ (static_cast<uint64>(AdaptedLayer->Metadata.CaptureTime) * 0x9E3779B97F4A7C15ull);
+
+			// Another peer has already encoded this frame, and the factory hands its packets to us as well
+			if (!EncodeSession->ClaimFrame(FrameKey))
+			{
+				return WEBRTC_VIDEO_CODEC_OK;
+			}
+
+			bool const bKeyframe = EncodeSession->IsKeyframeRequested();
+
+			// Shared with every peer on the stream, as their frames all queue on the one encoder.
+			// Decide before anything is taken for the frame, so a skipped frame leaves keyframe requests and rate changes for the next one
+			FVideoEncodeAdmission* const Admission = EncodeSession->GetAdmission();
+			if (Admission != nullptr && !Admission->Admit(bKeyframe, FrameIntervalSeconds))
+			{
+				FStats::Get()->StoreApplicationStat(FStatData(PixelStreamingStatNames::EncoderFramesSkipped, static_cast<double>(Admission->NumDropped()), 0));
+
+				return WEBRTC_VIDEO_CODEC_OK;
+			}
 
-			UpdateFrameMetadataPreEncode(*AdaptedLayer);
 			const FPixelCaptureOutputFrameRHI& RHILayer = StaticCast<const FPixelCaptureOutputFrameRHI&>(*AdaptedLayer);
 			rtc::scoped_refptr<FFrameBufferRHI> RHIBuffer;
 
@@ -216,63 +291,66 @@ namespace UE::PixelStreaming
 					FVideoResourceRHI::FRawData{ RHILayer.GetFrameTexture(), nullptr, 0 }));
 			}
 
-			const bool bKeyframe = (frame_types && (*frame_types)[0] == webrtc::VideoFrameType::kVideoFrameKey) || Factory.ShouldForceKeyframe();
-
-			PinnedHardwareEncoder->SendFrame(RHIBuffer->GetVideoResource(), frame.timestamp_us(), bKeyframe);
+			// Keyframe requests and rate changes come in on this thread, so take them now rather than when the frame is encoded
+			TOptional<FVideoEncodeSession::FRate> RateChange = EncodeSession->TakeRateChange();
 
-			Factory.UnforceKeyFrame();
+			// Intra refresh is already running on the encoder, so a request it can answer needs nothing more from us
+			EVideoKeyframeDecision const KeyframeDecision = EncodeSession->TakeKeyframeRequest();
 
-			UpdateFrameMetadataPostEncode(*AdaptedLayer);
+			TSharedPtr<FEncodeContext> Context = MakeShared<FEncodeContext>(FEncodeContext{
+				frame,
+				AdaptedLayer,
+				RHIBuffer,
+				PinnedHardwareEncoder,
+				MoveTemp(RateChange),
+				KeyframeDecision == EVideoKeyframeDecision::Keyframe });
 
-			FVideoPacket Packet;
-			while (PinnedHardwareEncoder->ReceivePacket(Packet))
+			if (Pipeline.IsValid())
 			{
-				// TODO (Andrew) This works fine for 1:1 synchronous encoding, but will need to relate frames to packets for async or gop
-				webrtc::EncodedImage Image;
-
-				Image.timing_.packetization_finish_ms = FTimespan::FromSeconds(FPlatformTime::Seconds()).GetTotalMilliseconds();
-				Image.timing_.encode_start_ms = AdaptedLayer->Metadata.LastEncodeStartTime;
-				Image.timing_.encode_finish_ms = AdaptedLayer->Metadata.LastEncodeEndTime;
-				Image.timing_.flags = webrtc::VideoSendTiming::kTriggeredByTimer;
-				Image.SetEncodedData(webrtc::EncodedImageBuffer::Create(Packet.DataPtr.Get(), Packet.DataSize));
-				Image._encodedWidth = RHIBuffer->width();
-				Image._encodedHeight = RHIBuffer->height();
-				Image._frameType = Packet.bIsKeyframe ? webrtc::VideoFrameType::kVideoFrameKey : webrtc::VideoFrameType::kVideoFrameDelta;
-				Image.content_type_ = webrtc::VideoContentType::UNSPECIFIED;
-				Image.qp_ = Packet.QP;
-				Image.SetSpatialIndex(0);
-				Image.rotation_ = webrtc::VideoRotation::kVideoRotation_0;
-				Image.SetTimestamp(frame.timestamp());
-				Image.capture_time_ms_ = Packet.Timestamp / 1000.0;
-
-				webrtc::CodecSpecificInfo CodecInfo;
-				switch (Codec)
+				bool const bSubmitted = Pipeline->Submit([this, Context]() -> FVideoEncodePipeline::FCompleteFunc {
+					TArray<FVideoPacket> Packets;
+					EncodeFrame(*Context, Packets);
+
+					return [this, Context, Packets = MoveTemp(Packets)]() mutable {
+						for (FVideoPacket& Packet : Packets)
+						{
+							DeliverPacket(Packet, *Context);
+						}
+					};
+				});
+
+				if (!bSubmitted)
 				{
-					case EPixelStreamingCodec::H264:
-						CodecInfo.codecType = webrtc::VideoCodecType::kVideoCodecH264;
-						CodecInfo.codecSpecific.H264.packetization_mode = webrtc::H264PacketizationMode::NonInterleaved;
-						CodecInfo.codecSpecific.H264.temporal_idx = webrtc::kNoTemporalIdx;
-						CodecInfo.codecSpecific.H264.idr_frame = Packet.bIsKeyframe;
-						CodecInfo.codecSpecific.H264.base_layer_sync = false;
-
-						break;
-					case EPixelStreamingCodec::H265:
-						CodecInfo.codecType = webrtc::VideoCodecType::kVideoCodecH265;
-						CodecInfo.codecSpecific.H265.packetization_mode = webrtc::H265PacketizationMode::NonInterleaved;
-						CodecInfo.codecSpecific.H265.idr_frame = Packet.bIsKeyframe;
-
-						break;
-				}
+					// The frame will never be encoded, so give back everything taken for it for the next frame to pick up
+					if (Admission != nullptr)
+					{
+						Admission->OnEncodeAbandoned();
+					}
 
-#if PIXELSTREAMING_DUMP_ENCODING
-				Packet.WriteToFile(TEXT("SingleLayerHardware.h265"));
-#endif
+					if (Context->RateChange.IsSet())
+					{
+						EncodeSession->RestoreRateChange(Context->RateChange.GetValue());
+					}
 
-				UpdateFrameMetadataPrePacketization(*AdaptedLayer);
+					if (Context->bKeyframe)
+					{
+						EncodeSession->RequestKeyframe();
+					}
 
-				Factory.OnEncodedImage(Image, &CodecInfo, EncodingStreamId);
+					UE_LOG(LogPixelStreaming, Warning, TEXT("Failed to submit frame to the encode pipeline"));
 
-				UpdateFrameMetadataPostPacketization(*AdaptedLayer);
+					return WEBRTC_VIDEO_CODEC_ERROR;
+				}
+			}
+			else
+			{
+				TArray<FVideoPacket> Packets;
+				EncodeFrame(*Context, Packets);
+
+				for (FVideoPacket& Packet : Packets)
+				{
+					DeliverPacket(Packet, *Context);
+				}
 			}
 
 			return WEBRTC_VIDEO_CODEC_OK;
@@ -283,11 +361,150 @@ namespace UE::PixelStreaming
 		}
 	}
 
+	void FVideoEncoderSingleLayerHardware::EncodeFrame(FEncodeContext const& Context, TArray<FVideoPacket>& OutPackets)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("PixelStreaming Hardware Encode Frame", PixelStreamingChannel);
+
+		// Every peer on the stream encodes on its own thread but shares the one encoder, so only one of them may drive it at a time
+		FScopeLock const EncodeLock(&EncodeSession->GetEncodeGuard());
+
+		UpdateConfig(Context.AdaptedLayer->GetWidth(), Context.AdaptedLayer->GetHeight(), Context.RateChange);
+
+		UpdateFrameMetadataPreEncode(*Context.AdaptedLayer);
+
+		double const EncodeStartTime = FPlatformTime::Seconds();
+
+		// The RTP timestamp rides along as user data, so each packet carries both times it is delivered with
+		Context.Encoder->SendFrame(Context.RHIBuffer->GetVideoResource(), Context.Frame.timestamp_us(), Context.bKeyframe, Context.Frame.timestamp());
+
+		UpdateFrameMetadataPostEncode(*Context.AdaptedLayer);
+
+		// NVENC and AMF both finish a frame inside SendFrame and the encode guard keeps other peers out until we are done,
+		// so everything waiting here belongs to the frame just sent and the context can travel with its packets to be delivered
+		FVideoPacket Packet;
+		while (Context.Encoder->ReceivePacket(Packet))
+		{
+			// Asked for or not, every peer on the stream can decode from here and the next forced keyframe is spaced out from it
+			if (Packet.bIsKeyframe)
+			{
+				EncodeSession->OnKeyframeEncoded();
+			}
+
+			OutPackets.Add(MoveTemp(Packet));
+		}
+
+		if (FVideoEncodeAdmission* const Admission = EncodeSession->GetAdmission())
+		{
+			Admission->OnEncodeFinished(FPlatformTime::Seconds() - EncodeStartTime);
+		}
+	}
+
+	void FVideoEncoderSingleLayerHardware::DeliverPacket(FVideoPacket& Packet, FEncodeContext const& Context)
+	{
+		IPixelCaptureOutputFrame* AdaptedLayer = Context.AdaptedLayer;
+
+		webrtc::EncodedImage Image;
+
+		Image.timing_.packetization_finish_ms = FTimespan::FromSeconds(FPlatformTime::Seconds()).GetTotalMilliseconds();
+		Image.timing_.encode_start_ms = AdaptedLayer->Metadata.LastEncodeStartTime;
+		Image.timing_.encode_finish_ms = AdaptedLayer->Metadata.LastEncodeEndTime;
+		Image.timing_.flags = webrtc::VideoSendTiming::kTriggeredByTimer;
+
+		if (PixelStreaming::Settings::CVarPixelStreamingEncoderEmbedFrameTiming.GetValueOnAnyThread())
+		{
+			int64 const NowUnixUs = rtc::TimeUTCMicros();
+			uint64 const NowCycles = FPlatformTime::Cycles64();
+
+			// The frame timestamp comes from the monotonic WebRTC clock
+			UE::AVCodecCore::SEI::FFrameTiming FrameTiming;
+			FrameTiming.CaptureTimeUs = NowUnixUs - (rtc::TimeMicros() - static_cast<int64>(Packet.Timestamp));
+			FrameTiming.EncodeStartTimeUs = CyclesToUnixMicroseconds(AdaptedLayer->Metadata.LastEncodeStartTime, NowCycles, NowUnixUs);
+			FrameTiming.EncodeEndTimeUs = CyclesToUnixMicroseconds(AdaptedLayer->Metadata.LastEncodeEndTime, NowCycles, NowUnixUs);
+
+			TArray<uint8> Payload;
+			FrameTiming.Serialize(Payload);
+
+			FAVResult const Result = Codec == EPixelStreamingCodec::H264
+				? UE::AVCodecCore::H264::InsertSEI(Packet, UE::AVCodecCore::SEI::EPayloadType::UserDataUnregistered, Payload)
+				: UE::AVCodecCore::H265::InsertSEI(Packet, UE::AVCodecCore::SEI::EPayloadType::UserDataUnregistered, Payload);
+
+			if (Result.IsNotSuccess())
+			{
+				UE_LOG(LogPixelStreaming, Verbose, TEXT("Failed to embed frame timing: %s"), *Result.ToString());
+			}
+		}
+
+		// Hardware encoders tend to leave bitstream_restriction out of the VUI, which makes decoders assume the worst case reorder depth and hold frames back
+		if (Codec == EPixelStreamingCodec::H264 && Packet.bIsKeyframe && !PixelStreaming::Settings::CVarPixelStreamingEncoderDisableVUIRewrite.GetValueOnAnyThread())
+		{
+			FAVResult const Result = UE::AVCodecCore::H264::RewriteSPS(Packet, UE::AVCodecCore::H264::FVUIRewrite());
+			if (Result.IsNotSuccess())
+			{
+				UE_LOG(LogPixelStreaming, Verbose, TEXT("Failed to rewrite SPS: %s"), *Result.ToString());
+			}
+		}
+
+		// Shares the packet data rather than copying it, this has to come after anything above that rewrites the packet
+#if WEBRTC_5414
+		Image.SetEncodedData(rtc::make_ref_counted<FEncodedImageBufferPacket>(Packet));
+#else
+		Image.SetEncodedData(new rtc::RefCountedObject<FEncodedImageBufferPacket>(Packet));
+#endif
+		Image._encodedWidth = Context.RHIBuffer->width();
+		Image._encodedHeight = Context.RHIBuffer->height();
+		Image._frameType = Packet.bIsKeyframe ? webrtc::VideoFrameType::kVideoFrameKey : webrtc::VideoFrameType::kVideoFrameDelta;
+		Image.content_type_ = webrtc::VideoContentType::UNSPECIFIED;
+		Image.qp_ = Packet.QP;
+		Image.SetSpatialIndex(0);
+		Image.rotation_ = webrtc::VideoRotation::kVideoRotation_0;
+		Image.SetTimestamp(static_cast<uint32>(Packet.UserData));
+		Image.capture_time_ms_ = Packet.Timestamp / 1000;
+
+		webrtc::CodecSpecificInfo CodecInfo;
+		switch (Codec)
+		{
+			case EPixelStreamingCodec::H264:
+				CodecInfo.codecType = webrtc::VideoCodecType::kVideoCodecH264;
+				CodecInfo.codecSpecific.H264.packetization_mode = webrtc::H264PacketizationMode::NonInterleaved;
+				CodecInfo.codecSpecific.H264.temporal_idx = webrtc::kNoTemporalIdx;
+				CodecInfo.codecSpecific.H264.idr_frame = Packet.bIsKeyframe;
+				CodecInfo.codecSpecific.H264.base_layer_sync = false;
+
+				break;
+			case EPixelStreamingCodec::H265:
+				CodecInfo.codecType = webrtc::VideoCodecType::kVideoCodecH265;
+				CodecInfo.codecSpecific.H265.packetization_mode = webrtc::H265PacketizationMode::NonInterleaved;
+				CodecInfo.codecSpecific.H265.idr_frame = Packet.bIsKeyframe;
+
+				break;
+		}
+
+#if PIXELSTREAMING_DUMP_ENCODING
+		Packet.WriteToFile(TEXT("SingleLayerHardware.h265"));
+#endif
+
+		UpdateFrameMetadataPrePacketization(*AdaptedLayer);
+
+		Factory.OnEncodedImage(Image, &CodecInfo, EncodingStreamId);
+
+		UpdateFrameMetadataPostPacketization(*AdaptedLayer);
+	}
+
 	// Pass rate control parameters from WebRTC to our encoder
 	// This is how WebRTC can control the bitrate/framerate of the encoder.
 	void FVideoEncoderSingleLayerHardware::SetRates(RateControlParameters const& parameters)
 	{
-		PendingRateChange.Emplace(parameters);
+		FVideoEncodeSession::FRate const Rate{ static_cast<int32>(parameters.bitrate.get_sum_bps()), parameters.framerate_fps };
+
+		// The encoder is shared with every other peer on the stream, so what it runs at is settled between all of us
+		if (EncodeSession.IsValid())
+		{
+			EncodeSession->SetRate(this, Rate);
+		}
+		else
+		{
+			PendingRateChange.Emplace(Rate);
+		}
 	}
 
 	webrtc::VideoEncoder::EncoderInfo FVideoEncoderSingleLayerHardware::GetEncoderInfo() const
@@ -311,7 +528,7 @@ namespace UE::PixelStreaming
 		return info;
 	}
 
-	void FVideoEncoderSingleLayerHardware::UpdateConfig(uint32 width, uint32 height)
+	void FVideoEncoderSingleLayerHardware::UpdateConfig(uint32 width, uint32 height, TOptional<FVideoEncodeSession::FRate> const& RateChange)
 	{
 		if (TSharedPtr<FVideoEncoderHardware> const& PinnedHardwareEncoder = HardwareEncoder.Pin())
 		{
@@ -342,19 +559,19 @@ namespace UE::PixelStreaming
 					break;
 			}
 
-			if (PendingRateChange.IsSet())
+			if (RateChange.IsSet())
 			{
-				const RateControlParameters& RateChangeParams = PendingRateChange.GetValue();
-
-				VideoConfig->TargetFramerate = RateChangeParams.framerate_fps;
+				const FVideoEncodeSession::FRate& RateChangeParams = RateChange.GetValue();
 
-				// We store what WebRTC wants as the bitrate, even if we are overriding it, so we can restore back to it when user stops using CVar.
-				WebRtcProposedTargetBitrate = RateChangeParams.bitrate.get_sum_kbps() * 1000;
+				VideoConfig->TargetFramerate = RateChangeParams.Framerate;
 
-				// Clear the rate change request
-				PendingRateChange.Reset();
+				// Stored with the session even if the CVar overrides it, so whoever encodes next can restore back to it when the user stops using the CVar.
+				EncodeSession->SetAppliedRate(RateChangeParams);
 			}
 
+			// The encoder is shared with every peer on the stream, so it runs at the rate settled between all of us rather than at any one peer's
+			TOptional<FVideoEncodeSession::FRate> const AppliedRate = EncodeSession->GetAppliedRate();
+
 			// Change encoder settings through CVars
 			const int32 MaxBitrateCVar = UE::PixelStreaming::Settings::CVarPixelStreamingEncoderMaxBitrate.GetValueOnAnyThread();
 			const int32 TargetBitrateCVar = UE::PixelStreaming::Settings::CVarPixelStreamingEncoderTargetBitrate.GetValueOnAnyThread();
@@ -366,7 +583,7 @@ namespace UE::PixelStreaming
 			const EH264Profile H265Profile = UE::PixelStreaming::Settings::GetH264Profile();
 
 			VideoConfig->MaxBitrate = MaxBitrateCVar > -1 ? MaxBitrateCVar : VideoConfig->MaxBitrate;
-			VideoConfig->TargetBitrate = TargetBitrateCVar > -1 ? TargetBitrateCVar : WebRtcProposedTargetBitrate;
+			VideoConfig->TargetBitrate = TargetBitrateCVar > -1 ? TargetBitrateCVar : (AppliedRate.IsSet() ? AppliedRate->Bitrate : VideoConfig->TargetBitrate);
 			VideoConfig->MinQP = MinQPCVar;
 			VideoConfig->MaxQP = MaxQPCVar;
 			VideoConfig->RateControlMode = RateControlCVar;
@@ -5,6 +5,9 @@
 #include "IPixelCaptureOutputFrame.h"
 #include "PixelStreamingCodec.h"
 #include "VideoEncoderFactorySingleLayer.h"
+#include "FrameBufferRHI.h"
+#include "Video/Encoders/VideoEncodePipeline.h"
+#include "Video/Encoders/VideoEncodeSession.h"
 
 namespace UE::PixelStreaming
 {
@@ -37,8 +40,24 @@ namespace UE::PixelStreaming
 		void SendEncodedImage(webrtc::EncodedImage const& encoded_image, webrtc::CodecSpecificInfo const* codec_specific_info, uint32 StreamId);
 
 	private:
+		/**
+		 * Everything needed to encode a frame and deliver its packets, kept alive until they have been delivered.
+		 */
+		struct FEncodeContext
+		{
+			// Holds on to the multi format buffer, which in turn keeps AdaptedLayer alive
+			webrtc::VideoFrame Frame;
+			IPixelCaptureOutputFrame* AdaptedLayer;
+			rtc::scoped_refptr<FFrameBufferRHI> RHIBuffer;
+			TSharedPtr<FVideoEncoderHardware> Encoder;
+			TOptional<FVideoEncodeSession::FRate> RateChange;
+			bool bKeyframe;
+		};
+
 		void LateInitHardwareEncoder(uint32 StreamId);
-		void UpdateConfig(uint32 width, uint32 height);
+		void UpdateConfig(uint32 width, uint32 height, TOptional<FVideoEncodeSession::FRate> const& RateChange);
+		void EncodeFrame(FEncodeContext const& Context, TArray<FVideoPacket>& OutPackets);
+		void DeliverPacket(FVideoPacket& Packet, FEncodeContext const& Context);
 		void MaybeDumpFrame(webrtc::EncodedImage const& encoded_image);
 
 		void UpdateFrameMetadataPreEncode(IPixelCaptureOutputFrame& Frame);
@@ -53,16 +72,22 @@ namespace UE::PixelStreaming
 		TUniquePtr<FVideoEncoderConfig> InitialVideoConfig;
 		TWeakPtr<FVideoEncoderHardware> HardwareEncoder;
 
-		// We store this so we can restore back to it if the user decides to use then stop using the PixelStreaming.Encoder.TargetBitrate CVar.
-		int32 WebRtcProposedTargetBitrate = 5000000;
-
 		webrtc::EncodedImageCallback* OnEncodedImageCallback = nullptr;
 
-		// WebRTC may request a bitrate/framerate change using SetRates(), we only respect this if this encoder is actually encoding
-		// so we use this optional object to store a rate change and act upon it when this encoder does its next call to Encode().
-		TOptional<RateControlParameters> PendingRateChange;
+		// WebRTC may request a bitrate/framerate change using SetRates() before the first frame tells us which stream we are encoding,
+		// so we hold on to it until we have joined the stream's session.
+		TOptional<FVideoEncodeSession::FRate> PendingRateChange;
 
 		// used to key into active hardware encoders and pull the correct encoder for the stream.
 		uint32 EncodingStreamId;
+
+		// Shared with every other peer encoding the same stream, so that whichever of us sees a frame first encodes it for all of us.
+		TSharedPtr<FVideoEncodeSession> EncodeSession;
+
+		// Only set when PixelStreaming.Encoder.FramesInFlight asks for frames to be encoded off the WebRTC encoder thread.
+		TUniquePtr<FVideoEncodePipeline> Pipeline;
+
+		// Capture time of the last frame passed to Encode, to tell how soon the next one is due.
+		int64 LastFrameTimestampUs = 0;
 	};
 } // namespace UE::PixelStreaming
@@ -138,7 +138,7 @@ public:
 	UE_DEPRECATED(5.2, "RegisterMessage(...) is no longer needed. Just add your message to the protocol using FPixelStreamingInputProtocol::Direction.Add(XXX);, and then add the handler to the Streamer's input handler")
 	// PluginExt: START
 	// Handler に PlayerId を追加しました。
-	virtual void RegisterMessage(EPixelStreamingMessageDirection MessageDirection, const FString& MessageType, FPixelStreamingInputMessage Message, const TFunction<void(FString, FMemoryReader)>& Handler) = 0;
+	virtual void RegisterMessage(EPixelStreamingMessageDirection MessageDirection, const FString& MessageType, FPixelStreamingInputMessage Message, const TFunction<void(const FString&, FMemoryReader)>& Handler) = 0;
 	// PluginExt: END
 
 	/**
@@ -150,7 +150,7 @@ public:
 	UE_DEPRECATED(5.2, "FindMessageHandler(...) has been moved from the PixelStreaming module to IPixelStreamingInputHandler. This object can be obtained from an (IPixelStreamingStreamer)->GetInputHandler()")
 	// PluginExt: START
 	// Handler に PlayerId を追加しました。
-	virtual TFunction<void(FString, FMemoryReader)> FindMessageHandler(const FString& MessageType) = 0;
+	virtual TFunction<void(const FString&, FMemoryReader)> FindMessageHandler(const FString& MessageType) = 0;
 	// PluginExt: END
 
 	/**
@@ -4,6 +4,10 @@
 
 #include "PixelStreamingBufferBuilder.h"
 #include "PixelStreamingWebRTCIncludes.h"
+#include "Async/Future.h"
+#include "Containers/Deque.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
 
 class FPixelStreamingPeerConnection;
 
@@ -20,7 +24,7 @@ public:
 	/**
 	 * Sends a series of arguments to the data channel with the given type.
 	 * @param Type Should be the ID from a registered PixelStreamingProtocol message
-	 * @returns True of the message was successfully sent.
+	 * @returns True if the message was queued to be sent. It can still fail to go out after that, use SendBufferAsync to find out.
 	 */
 	template <typename... Args>
 	bool SendMessage(uint8 Type, Args... VarArgs)
@@ -30,20 +34,75 @@ public:
 			return false;
 		}
 
+		return SendBuffer(BuildMessage(Type, Forward<Args>(VarArgs)...));
+	}
+
+	/**
+	 * Serializes a series of arguments into a message with the given type, without sending it.
+	 * The buffer is reference counted, so it can be sent to any number of data channels with SendBuffer without being copied.
+	 * @param Type Should be the ID from a registered PixelStreamingProtocol message
+	 * @returns The serialized message.
+	 */
+	template <typename... Args>
+	static rtc::CopyOnWriteBuffer BuildMessage(uint8 Type, Args... VarArgs)
+	{
 		UE::PixelStreaming::BufferBuilder Builder(sizeof(Type) + (0 + ... + UE::PixelStreaming::ValueSize(Forward<Args>(VarArgs))));
 		Builder.Insert(Type);
 		(Builder.Insert(Forward<Args>(VarArgs)), ...);
-		return SendChannel->Send(webrtc::DataBuffer(Builder.Buffer, true));
+		return MoveTemp(Builder.Buffer);
 	}
 
 	/**
-	 * Sends a large buffer of data to the data channel.
+	 * Sends a message serialized with BuildMessage to the data channel.
+	 * Messages queue behind any data still waiting to be sent, so they arrive in the order they were sent.
+	 * @param Buffer The serialized message.
+	 * @returns True if the message was queued to be sent. It can still fail to go out after that, use SendBufferAsync to find out.
+	 */
+	bool SendBuffer(const rtc::CopyOnWriteBuffer& Buffer) const;
+
+	/**
+	 * Sends a message serialized with BuildMessage to the data channel, for callers that need to know whether it went out.
+	 * Each message costs a promise that SendBuffer does without, so keep it for messages whose failure is acted upon.
+	 * @param Buffer The serialized message.
+	 * @returns A future set to true once the message has been handed to the channel, or to false if it could not be.
+	 */
+	TFuture<bool> SendBufferAsync(const rtc::CopyOnWriteBuffer& Buffer) const;
+
+	/**
+	 * Sends a large buffer of data to the data channel, waiting until it has all been handed to the channel.
+	 * Prefer SendArbitraryDataAsync, this blocks the caller for as long as the channel takes to drain and must not be called on the WebRTC signalling thread.
 	 * @param Type See SendMessage. The type of the message.
 	 * @param DataBytes The raw byte buffer to send.
 	 * @returns True when all data was successfully sent.
 	 */
 	bool SendArbitraryData(uint8 Type, const TArray64<uint8>& DataBytes) const;
 
+	/**
+	 * Queues a large buffer of data to be sent to the data channel and returns straight away.
+	 * The data goes out as quickly as the channel drains, resuming whenever the channel reports its buffer has room rather than polling it.
+	 * @param Type See SendMessage. The type of the message.
+	 * @param DataBytes The raw byte buffer to send.
+	 * @returns A future set to true once all the data has been handed to the channel, or to false if it could not be.
+	 */
+	TFuture<bool> SendArbitraryDataAsync(uint8 Type, const TArray64<uint8>& DataBytes) const;
+
+	/**
+	 * Queues data split with BuildArbitraryData to be sent to the data channel and returns straight away.
+	 * The chunks are shared rather than copied, so the same chunks can be queued to any number of data channels.
+	 * @param Chunks The serialized messages.
+	 * @returns A future set to true once all the data has been handed to the channel, or to false if it could not be.
+	 */
+	TFuture<bool> SendArbitraryDataAsync(TSharedRef<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe> Chunks) const;
+
+	/**
+	 * Splits a large buffer of data into the messages SendArbitraryData would send, without sending them.
+	 * @param Type See SendMessage. The type of the message.
+	 * @param DataBytes The raw byte buffer to split.
+	 * @returns The serialized messages, each within the size of a single data channel transmission.
+	 */
+	static TArray<rtc::CopyOnWriteBuffer> BuildArbitraryData(uint8 Type, const TArray64<uint8>& DataBytes);
+
+
 	/**
 	 * Broadcast when the data channel state changes to open
 	 */
@@ -66,11 +125,36 @@ protected:
 	// webrtc::DataChannelObserver implementation.
 	virtual void OnStateChange() override;
 	virtual void OnMessage(const webrtc::DataBuffer& Buffer) override;
+	virtual void OnBufferedAmountChange(uint64_t SentDataSize) override;
 
 private:
 	rtc::scoped_refptr<webrtc::DataChannelInterface> SendChannel;
 	rtc::scoped_refptr<webrtc::DataChannelInterface> RecvChannel;
 
+	// Watches the send channel when it is not also the receive channel, so the send queue still hears when it drains
+	class FSendChannelObserver;
+	TUniquePtr<FSendChannelObserver> SendChannelObserver;
+
+	// A message or a run of chunks waiting for room in the send channel
+	struct FPendingSend
+	{
+		rtc::CopyOnWriteBuffer Message;
+		TSharedPtr<const TArray<rtc::CopyOnWriteBuffer>, ESPMode::ThreadSafe> Chunks;
+		int32 NextChunk = 0;
+		TSharedPtr<TPromise<bool>, ESPMode::ThreadSafe> Promise;
+	};
+
+	// Guards the queue only, it is never held while calling into the channel
+	mutable FCriticalSection SendQueueCS;
+	mutable TDeque<FPendingSend> SendQueue;
+
+	// Number of times the queue was asked to pump while it was already pumping, so only one thread ever sends
+	mutable std::atomic<int32> PumpRequests = 0;
+
+	void EnqueueSend(FPendingSend&& PendingSend) const;
+	void PumpSendQueue() const;
+	void FailPendingSends() const;
+
 	FPixelStreamingDataChannel(rtc::scoped_refptr<webrtc::DataChannelInterface> InChannel);
 	FPixelStreamingDataChannel(FPixelStreamingPeerConnection& Connection, int32 SendStreamId, int32 RecvStreamId);
 };
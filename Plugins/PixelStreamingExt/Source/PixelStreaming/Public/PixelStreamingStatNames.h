@@ -55,5 +55,6 @@ namespace PixelStreamingStatNames
 	const FName MeanSendDelay			= FName(TEXT("captureToSend"));
 	const FName SourceFps				= FName(TEXT("captureFps"));
 	const FName Fps						= FName(TEXT("captureFps"));
+	const FName EncoderFramesSkipped	= FName(TEXT("encoderFramesSkipped"));
 
 } // namespace PixelStreamingStatNames
@@ -64,17 +64,17 @@ void FStreamerExt::CreateStreamer()
 		// DataChannel のイベントを受信するための設定を行います。
 		// イベントタイプの定義は、PixelStreamingExtModule::StartModule で行っています。
 		TSharedPtr<IPixelStreamingInputHandler> InputHandler = Streamer->GetInputHandler().Pin();
-		InputHandler->RegisterMessageHandler("UIInteraction", [this](FString PlayerId, FMemoryReader Ar) { HandleUIInteraction(PlayerId, Ar); });
-		InputHandler->RegisterMessageHandler("CameraSwitchResponse", [this](FString PlayerId, FMemoryReader Ar) { HandleCameraSwitchResponse(Ar); });
-		InputHandler->RegisterMessageHandler("CameraSetRes", [this](FString PlayerId, FMemoryReader Ar) { HandleCameraSetRes(PlayerId, Ar); });
-		InputHandler->RegisterMessageHandler("MouseUp", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseUp(PlayerId, Ar); });
-		InputHandler->RegisterMessageHandler("MouseDown", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseDown(PlayerId, Ar); });
-		InputHandler->RegisterMessageHandler("MouseMove", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseMove(PlayerId, Ar); });
-		InputHandler->RegisterMessageHandler("TouchStart", [this](FString PlayerId, FMemoryReader Ar) { HandleOnTouchStarted(PlayerId, Ar); });
-		InputHandler->RegisterMessageHandler("TouchMove", [this](FString PlayerId, FMemoryReader Ar) { HandleOnTouchMoved(PlayerId, Ar); });
-		InputHandler->RegisterMessageHandler("TouchEnd", [this](FString PlayerId, FMemoryReader Ar) { HandleOnTouchEnded(PlayerId, Ar); });
-		InputHandler->RegisterMessageHandler("ResetBroadcastTouchMoveList", [this](FString PlayerId, FMemoryReader Ar) { HandleResetBroadcastTouchMoveList(); });
-		InputHandler->RegisterMessageHandler("BroadcastTouchMoveList", [this](FString PlayerId, FMemoryReader Ar) { HandleBroadcastTouchMoveList(); });
+		InputHandler->RegisterMessageHandler("UIInteraction", [this](const FString& PlayerId, FMemoryReader Ar) { HandleUIInteraction(PlayerId, Ar); });
+		InputHandler->RegisterMessageHandler("CameraSwitchResponse", [this](const FString& PlayerId, FMemoryReader Ar) { HandleCameraSwitchResponse(Ar); });
+		InputHandler->RegisterMessageHandler("CameraSetRes", [this](const FString& PlayerId, FMemoryReader Ar) { HandleCameraSetRes(PlayerId, Ar); });
+		InputHandler->RegisterMessageHandler("MouseUp", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseUp(PlayerId, Ar); });
+		InputHandler->RegisterMessageHandler("MouseDown", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseDown(PlayerId, Ar); });
+		InputHandler->RegisterMessageHandler("MouseMove", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseMove(PlayerId, Ar); });
+		InputHandler->RegisterMessageHandler("TouchStart", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnTouchStarted(PlayerId, Ar); });
+		InputHandler->RegisterMessageHandler("TouchMove", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnTouchMoved(PlayerId, Ar); });
+		InputHandler->RegisterMessageHandler("TouchEnd", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnTouchEnded(PlayerId, Ar); });
+		InputHandler->RegisterMessageHandler("ResetBroadcastTouchMoveList", [this](const FString& PlayerId, FMemoryReader Ar) { HandleResetBroadcastTouchMoveList(); });
+		InputHandler->RegisterMessageHandler("BroadcastTouchMoveList", [this](const FString& PlayerId, FMemoryReader Ar) { HandleBroadcastTouchMoveList(); });
 
 		Streamer->SetInputHandlerType(EPixelStreamingInputType::RouteToWidget);
 	}
@@ -167,7 +167,7 @@ void FStreamerExt::SendPlayerMessage(FPixelStreamingPlayerId PlayerId, uint8 Typ
 	}
 }
 
-void FStreamerExt::HandleUIInteraction(FString PlayerId, FMemoryReader Ar)
+void FStreamerExt::HandleUIInteraction(const FString& PlayerId, FMemoryReader Ar)
 {
 	FString Res;
 	Res.GetCharArray().SetNumUninitialized(Ar.TotalSize() / 2 + 1);
@@ -183,7 +183,7 @@ void FStreamerExt::HandleUIInteraction(FString PlayerId, FMemoryReader Ar)
 	}
 }
 
-void FStreamerExt::HandleCameraSetRes(FString PlayerId, FMemoryReader Ar)
+void FStreamerExt::HandleCameraSetRes(const FString& PlayerId, FMemoryReader Ar)
 {
 	FString Res;
 	Res.GetCharArray().SetNumUninitialized(Ar.TotalSize() / 2 + 1);
@@ -334,7 +334,7 @@ void FStreamerExt::ProcessCameraSelectRequest(TSharedPtr<FJsonObject> JsonRootOb
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-void FStreamerExt::HandleOnMouseUp(FString PlayerId, FMemoryReader Ar)
+void FStreamerExt::HandleOnMouseUp(const FString& PlayerId, FMemoryReader Ar)
 {
 	TPayloadThreeParam<uint8, uint16, uint16> Payload(Ar);
 	UE_LOG(LogPixelStreamingExtStreamer, Verbose, TEXT("HandleOnMouseUp() PlayerId: %s, Payload Param2: %d Param3: %d"), *PlayerId, Payload.Param2, Payload.Param3);
@@ -383,7 +383,7 @@ void FStreamerExt::HandleOnMouseUp(FString PlayerId, FMemoryReader Ar)
 	}
 }
 
-void FStreamerExt::HandleOnMouseDown(FString PlayerId, FMemoryReader Ar)
+void FStreamerExt::HandleOnMouseDown(const FString& PlayerId, FMemoryReader Ar)
 {
 	TPayloadThreeParam<uint8, uint16, uint16> Payload(Ar);
 	UE_LOG(LogPixelStreamingExtStreamer, Verbose, TEXT("HandleOnMouseDown() PlayerId: %s, Payload Param2: %d Param3: %d"), *PlayerId, Payload.Param2, Payload.Param3);
@@ -433,7 +433,7 @@ void FStreamerExt::HandleOnMouseDown(FString PlayerId, FMemoryReader Ar)
 	}
 }
 
-void FStreamerExt::HandleOnMouseMove(FString PlayerId, FMemoryReader Ar)
+void FStreamerExt::HandleOnMouseMove(const FString& PlayerId, FMemoryReader Ar)
 {
 	TPayloadFourParam<uint16, uint16, int16, int16> Payload(Ar);
 	UE_LOG(LogPixelStreamingExtStreamer, Verbose, TEXT("HandleOnMouseMove() PlayerId: %s, Payload Param1: %d Param2: %d Param3: %d Param4: %d"), *PlayerId, Payload.Param1, Payload.Param2, Payload.Param3, Payload.Param4);
@@ -484,7 +484,7 @@ void FStreamerExt::HandleOnMouseMove(FString PlayerId, FMemoryReader Ar)
 	}
 }
 
-void FStreamerExt::HandleOnTouchStarted(FString PlayerId, FMemoryReader Ar)
+void FStreamerExt::HandleOnTouchStarted(const FString& PlayerId, FMemoryReader Ar)
 {
 	TPayloadOneParam<uint8> Payload(Ar);
 
@@ -520,7 +520,7 @@ void FStreamerExt::HandleOnTouchStarted(FString PlayerId, FMemoryReader Ar)
 	}
 }
 
-void FStreamerExt::HandleOnTouchMoved(FString PlayerId, FMemoryReader Ar)
+void FStreamerExt::HandleOnTouchMoved(const FString& PlayerId, FMemoryReader Ar)
 {
 	TPayloadOneParam<uint8> Payload(Ar);
 	FCachedTouchMoveEvent& CachedTouchMoveEvent = CachedTouchMoveEvents.FindOrAdd(PlayerId);	// PlayerId の TouchMoveEvent キャッシュ情報を取得
@@ -562,7 +562,7 @@ void FStreamerExt::HandleOnTouchMoved(FString PlayerId, FMemoryReader Ar)
 	}
 }
 
-void FStreamerExt::HandleOnTouchEnded(FString PlayerId, FMemoryReader Ar)
+void FStreamerExt::HandleOnTouchEnded(const FString& PlayerId, FMemoryReader Ar)
 {
 	TPayloadOneParam<uint8> Payload(Ar);
 	uint8 NumTouches = Payload.Param1;
@@ -36,20 +36,20 @@ public:
 	TSharedPtr<IPixelStreamingStreamer> Streamer;
 
 private:
-	void HandleUIInteraction(FString PlayerId, FMemoryReader Ar);
-	void HandleCameraSetRes(FString PlayerId, FMemoryReader Ar);
+	void HandleUIInteraction(const FString& PlayerId, FMemoryReader Ar);
+	void HandleCameraSetRes(const FString& PlayerId, FMemoryReader Ar);
 	void HandleCameraSwitchResponse(FMemoryReader Ar);
 	void ProcessCameraSwitchResponse(const FString& InDescriptor);
 	void ProcessCameraSwitchPrepareResponse(TSharedPtr<FJsonObject> JsonRootObject);
 	void ProcessCameraSwitchResponse(TSharedPtr<FJsonObject> JsonRootObject);
 	void ProcessCameraSwitchCancelResponse(TSharedPtr<FJsonObject> JsonRootObject);
 	void ProcessCameraSelectRequest(TSharedPtr<FJsonObject> JsonRootObject);
-	void HandleOnMouseUp(FString PlayerId, FMemoryReader Ar);
-	void HandleOnMouseDown(FString PlayerId, FMemoryReader Ar);
-	void HandleOnMouseMove(FString PlayerId, FMemoryReader Ar);
-	void HandleOnTouchStarted(FString PlayerId, FMemoryReader Ar);
-	void HandleOnTouchMoved(FString PlayerId, FMemoryReader Ar);
-	void HandleOnTouchEnded(FString PlayerId, FMemoryReader Ar);
+	void HandleOnMouseUp(const FString& PlayerId, FMemoryReader Ar);
+	void HandleOnMouseDown(const FString& PlayerId, FMemoryReader Ar);
+	void HandleOnMouseMove(const FString& PlayerId, FMemoryReader Ar);
+	void HandleOnTouchStarted(const FString& PlayerId, FMemoryReader Ar);
+	void HandleOnTouchMoved(const FString& PlayerId, FMemoryReader Ar);
+	void HandleOnTouchEnded(const FString& PlayerId, FMemoryReader Ar);
 	void HandleResetBroadcastTouchMoveList();
 	void HandleBroadcastTouchMoveList();
 	FIntPoint ConvertFromNormalizedScreenLocation(const FVector2D& ScreenLocation, bool bIncludeOffset = false);
@@ -0,0 +1,105 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/PlatformTime.h"
+
+#include <PixelStreamingInputProtocolMap.h>
+
+DEFINE_SPEC(InputProtocolMessageHandleSpec, "PixelStreamingExt.InputProtocolMessageHandle", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+
+namespace InputProtocolMessageHandleSpecPrivate
+{
+	// A second's worth of control messages at 10k messages per second
+	constexpr int32 NumMessages = 10000;
+
+	void AddMessages(FInputProtocolMap& Protocol)
+	{
+		Protocol.Add(TEXT("QualityControlOwnership"), FPixelStreamingInputMessage(0));
+		Protocol.Add(TEXT("Response"), FPixelStreamingInputMessage(1));
+		Protocol.Add(TEXT("LatencyTest"), FPixelStreamingInputMessage(6));
+		Protocol.Add(TEXT("InitialSettings"), FPixelStreamingInputMessage(7));
+		Protocol.Add(TEXT("TestEcho"), FPixelStreamingInputMessage(11));
+		Protocol.Add(TEXT("Protocol"), FPixelStreamingInputMessage(255));
+	}
+
+	// Stand in for writing the message type into an outgoing buffer, so neither path can be optimised away
+	template <typename FGetIDFunc>
+	double Send(TArray<uint8>& Buffer, FGetIDFunc&& GetID)
+	{
+		Buffer.Reset(NumMessages);
+
+		double const StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumMessages; ++i)
+		{
+			Buffer.Add(GetID());
+		}
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+} // namespace InputProtocolMessageHandleSpecPrivate
+
+void InputProtocolMessageHandleSpec::Define()
+{
+	using namespace InputProtocolMessageHandleSpecPrivate;
+
+	Describe("Resolve", [this]() {
+		It("should resolve to the id of the message", [this]() {
+			FInputProtocolMap Protocol;
+			AddMessages(Protocol);
+
+			FInputProtocolMessageHandle const LatencyTest(Protocol, TEXT("LatencyTest"));
+
+			TestTrue("should", LatencyTest.IsValid());
+			TestEqual("should", LatencyTest.GetID(), Protocol.Find(TEXT("LatencyTest"))->GetID());
+		});
+
+		It("should not resolve a message missing from the protocol", [this]() {
+			FInputProtocolMap Protocol;
+			AddMessages(Protocol);
+
+			FInputProtocolMessageHandle const Missing(Protocol, TEXT("NotAMessage"));
+
+			TestFalse("should", Missing.IsValid());
+		});
+
+		It("should resolve again when the protocol changes", [this]() {
+			FInputProtocolMap Protocol;
+			AddMessages(Protocol);
+
+			FInputProtocolMessageHandle const Custom(Protocol, TEXT("Custom"));
+			TestFalse("should", Custom.IsValid());
+
+			uint32 const Version = Protocol.GetVersion();
+			Protocol.Add(TEXT("Custom"), FPixelStreamingInputMessage(128));
+			TestTrue("should", Protocol.GetVersion() != Version);
+
+			TestTrue("should", Custom.IsValid());
+			TestEqual("should", Custom.GetID(), static_cast<uint8>(128));
+
+			Protocol.Add(TEXT("Custom"), FPixelStreamingInputMessage(130));
+			TestEqual("should", Custom.GetID(), static_cast<uint8>(130));
+
+			Protocol.Remove(TEXT("Custom"));
+			TestFalse("should", Custom.IsValid());
+		});
+	});
+
+	Describe("Benchmark", [this]() {
+		It("should send what looking messages up by name sends", [this]() {
+			FInputProtocolMap Protocol;
+			AddMessages(Protocol);
+
+			FInputProtocolMessageHandle const LatencyTest(Protocol, TEXT("LatencyTest"));
+
+			TArray<uint8> ByName;
+			double const ByNameSeconds = Send(ByName, [&Protocol]() { return Protocol.Find("LatencyTest")->GetID(); });
+
+			TArray<uint8> ByHandle;
+			double const ByHandleSeconds = Send(ByHandle, [&LatencyTest]() { return LatencyTest.GetID(); });
+
+			// Timings vary too much between machines and runs to assert on, so they are only reported
+			AddInfo(FString::Printf(TEXT("%d messages looked up by name in %.3fms, by handle in %.3fms"), NumMessages, ByNameSeconds * 1000.0, ByHandleSeconds * 1000.0));
+
+			TestTrue("should", ByName == ByHandle);
+		});
+	});
+}
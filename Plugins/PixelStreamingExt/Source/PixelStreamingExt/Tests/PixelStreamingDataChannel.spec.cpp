@@ -0,0 +1,156 @@
+#include "Misc/AutomationTest.h"
+
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+
+#include <PixelStreamingDataChannel.h>
+#include <PixelStreamingPeerConnection.h>
+
+namespace PixelStreamingDataChannelSpecPrivate
+{
+	// Any type will do, the receiving end only counts bytes
+	constexpr uint8 FileContentsType = 200;
+	constexpr int32 StreamId = 1000;
+
+	// Well past the 16MB a channel buffers, so sending it in one go used to hold up the caller until most of it had gone out
+	constexpr int32 PayloadBytes = 64 * 1024 * 1024;
+
+	// Message type and payload size ahead of every chunk
+	constexpr int32 ChunkHeaderBytes = sizeof(uint8) + sizeof(int32);
+
+	// Two peer connections in this process joined to each other, with a negotiated data channel between them
+	struct FLoopback
+	{
+		TUniquePtr<FPixelStreamingPeerConnection> Sender;
+		TUniquePtr<FPixelStreamingPeerConnection> Receiver;
+		TSharedPtr<FPixelStreamingDataChannel> SendChannel;
+		TSharedPtr<FPixelStreamingDataChannel> RecvChannel;
+
+		int32 NumOpen = 0;
+		int64 BytesReceived = 0;
+		TFuture<bool> Sent;
+
+		~FLoopback()
+		{
+			SendChannel.Reset();
+			RecvChannel.Reset();
+			Sender.Reset();
+			Receiver.Reset();
+		}
+	};
+
+	FString ToString(const webrtc::SessionDescriptionInterface* Description)
+	{
+		std::string Sdp;
+		Description->ToString(&Sdp);
+		return FString(Sdp.c_str());
+	}
+
+	void ForwardIceCandidates(FPixelStreamingPeerConnection& From, FPixelStreamingPeerConnection& To)
+	{
+		From.OnEmitIceCandidate.AddLambda([&To](const webrtc::IceCandidateInterface* Candidate) {
+			std::string Sdp;
+			Candidate->ToString(&Sdp);
+			To.AddRemoteIceCandidate(FString(Candidate->sdp_mid().c_str()), Candidate->sdp_mline_index(), FString(Sdp.c_str()));
+		});
+	}
+} // namespace PixelStreamingDataChannelSpecPrivate
+
+BEGIN_DEFINE_SPEC(PixelStreamingDataChannelSpec, "PixelStreamingExt.PixelStreamingDataChannel", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+	TSharedPtr<PixelStreamingDataChannelSpecPrivate::FLoopback> Loopback;
+END_DEFINE_SPEC(PixelStreamingDataChannelSpec)
+
+void PixelStreamingDataChannelSpec::Define()
+{
+	using namespace PixelStreamingDataChannelSpecPrivate;
+
+	AfterEach([this]() {
+		Loopback.Reset();
+	});
+
+	Describe("SendArbitraryDataAsync", [this]() {
+		LatentIt("should send a large file over loopback without blocking the caller", FTimespan::FromSeconds(60), [this](const FDoneDelegate& Done) {
+			Loopback = MakeShared<FLoopback>();
+			FLoopback& Connection = *Loopback;
+
+			Connection.Sender = FPixelStreamingPeerConnection::Create(FPixelStreamingPeerConnection::FRTCConfig());
+			Connection.Receiver = FPixelStreamingPeerConnection::Create(FPixelStreamingPeerConnection::FRTCConfig());
+			ForwardIceCandidates(*Connection.Sender, *Connection.Receiver);
+			ForwardIceCandidates(*Connection.Receiver, *Connection.Sender);
+
+			Connection.SendChannel = FPixelStreamingDataChannel::Create(*Connection.Sender, StreamId, StreamId);
+			Connection.RecvChannel = FPixelStreamingDataChannel::Create(*Connection.Receiver, StreamId, StreamId);
+
+			// Both ends report open on the game thread, once they have the file goes out
+			auto OnOpen = [this, &Connection](FPixelStreamingDataChannel&) {
+				if (++Connection.NumOpen < 2)
+				{
+					return;
+				}
+
+				TArray64<uint8> Payload;
+				Payload.SetNumUninitialized(PayloadBytes);
+				FMemory::Memset(Payload.GetData(), 0xAB, PayloadBytes);
+
+				double const StartTime = FPlatformTime::Seconds();
+				Connection.Sent = Connection.SendChannel->SendArbitraryDataAsync(FileContentsType, Payload);
+				double const CallSeconds = FPlatformTime::Seconds() - StartTime;
+
+				AddInfo(FString::Printf(TEXT("Queued %d bytes in %.3fms"), PayloadBytes, CallSeconds * 1000.0));
+
+				// No more than the channel's buffer can have gone out yet, so a caller that waited could not be here
+				TestFalse("should", Connection.Sent.IsReady());
+			};
+			Connection.SendChannel->OnOpen.AddLambda(OnOpen);
+			Connection.RecvChannel->OnOpen.AddLambda(OnOpen);
+
+			Connection.RecvChannel->OnMessageReceived.AddLambda([this, &Connection, Done](uint8 Type, const webrtc::DataBuffer& Buffer) {
+				if (Type != FileContentsType)
+				{
+					return;
+				}
+
+				Connection.BytesReceived += Buffer.data.size() - ChunkHeaderBytes;
+				if (Connection.BytesReceived >= PayloadBytes)
+				{
+					TestEqual("should", Connection.BytesReceived, static_cast<int64>(PayloadBytes));
+					TestTrue("should", Connection.Sent.Get());
+					Done.Execute();
+				}
+			});
+
+			auto OnError = [this, Done](const FString& Error) {
+				AsyncTask(ENamedThreads::GameThread, [this, Done, Error]() {
+					AddError(FString::Printf(TEXT("Failed to connect loopback: %s"), *Error));
+					Done.Execute();
+				});
+			};
+
+			FPixelStreamingPeerConnection* Sender = Connection.Sender.Get();
+			FPixelStreamingPeerConnection* Receiver = Connection.Receiver.Get();
+			Sender->CreateOffer(FPixelStreamingPeerConnection::EReceiveMediaOption::Nothing, [Sender, Receiver, OnError](const webrtc::SessionDescriptionInterface* Offer) {
+				Receiver->ReceiveOffer(ToString(Offer), [Sender, Receiver, OnError]() {
+					Receiver->CreateAnswer(FPixelStreamingPeerConnection::EReceiveMediaOption::Nothing, [Sender, OnError](const webrtc::SessionDescriptionInterface* Answer) {
+						Sender->ReceiveAnswer(ToString(Answer), []() {}, OnError);
+					}, OnError);
+				}, OnError);
+			}, OnError);
+		});
+	});
+
+	Describe("SendBufferAsync", [this]() {
+		It("should answer false when the channel is not open", [this]() {
+			TUniquePtr<FPixelStreamingPeerConnection> Connection = FPixelStreamingPeerConnection::Create(FPixelStreamingPeerConnection::FRTCConfig());
+			TSharedPtr<FPixelStreamingDataChannel> Channel = FPixelStreamingDataChannel::Create(*Connection, StreamId, StreamId);
+
+			// Never negotiated, so nothing can go out and the caller hears so straight away
+			TFuture<bool> Sent = Channel->SendBufferAsync(FPixelStreamingDataChannel::BuildMessage(FileContentsType, static_cast<uint8>(1)));
+
+			TestTrue("should", Sent.IsReady());
+			TestFalse("should", Sent.Get());
+
+			Channel.Reset();
+			Connection.Reset();
+		});
+	});
+}
@@ -56,39 +56,39 @@ namespace UE::PixelStreamingInput
 		/////////////////////////////////////////////////////////////////////////////
 		// PluginExt: START
 		// Handler の引数に PlayerId を追加しています。
-		RegisterMessageHandler("KeyPress", [this](FString PlayerId, FMemoryReader Ar) { HandleOnKeyChar(Ar); });
-		RegisterMessageHandler("KeyUp", [this](FString PlayerId, FMemoryReader Ar) { HandleOnKeyUp(Ar); });
-		RegisterMessageHandler("KeyDown", [this](FString PlayerId, FMemoryReader Ar) { HandleOnKeyDown(Ar); });
-
-		RegisterMessageHandler("TouchStart", [this](FString PlayerId, FMemoryReader Ar) { HandleOnTouchStarted(Ar); });
-		RegisterMessageHandler("TouchMove", [this](FString PlayerId, FMemoryReader Ar) { HandleOnTouchMoved(Ar); });
-		RegisterMessageHandler("TouchEnd", [this](FString PlayerId, FMemoryReader Ar) { HandleOnTouchEnded(Ar); });
-
-		RegisterMessageHandler("GamepadConnected", [this](FString PlayerId, FMemoryReader Ar) { HandleOnControllerConnected(Ar); });
-		RegisterMessageHandler("GamepadAnalog", [this](FString PlayerId, FMemoryReader Ar) { HandleOnControllerAnalog(PlayerId, Ar); });
-		RegisterMessageHandler("GamepadButtonPressed", [this](FString PlayerId, FMemoryReader Ar) { HandleOnControllerButtonPressed(PlayerId, Ar); });
-		RegisterMessageHandler("GamepadButtonReleased", [this](FString PlayerId, FMemoryReader Ar) { HandleOnControllerButtonReleased(PlayerId, Ar); });
-		RegisterMessageHandler("GamepadDisconnected", [this](FString PlayerId, FMemoryReader Ar) { HandleOnControllerDisconnected(Ar); });
-
-		RegisterMessageHandler("MouseEnter", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseEnter(Ar); });
-		RegisterMessageHandler("MouseLeave", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseLeave(Ar); });
-		RegisterMessageHandler("MouseUp", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseUp(Ar); });
-		RegisterMessageHandler("MouseDown", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseDown(Ar); });
-		RegisterMessageHandler("MouseMove", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseMove(Ar); });
-		RegisterMessageHandler("MouseWheel", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseWheel(Ar); });
-		RegisterMessageHandler("MouseDouble", [this](FString PlayerId, FMemoryReader Ar) { HandleOnMouseDoubleClick(Ar); });
-
-		RegisterMessageHandler("XRHMDTransform", [this](FString PlayerId, FMemoryReader Ar) { HandleOnXRHMDTransform(Ar); });
-		RegisterMessageHandler("XRControllerTransform", [this](FString PlayerId, FMemoryReader Ar) { HandleOnXRControllerTransform(Ar); });
-		RegisterMessageHandler("XRButtonPressed", [this](FString PlayerId, FMemoryReader Ar) { HandleOnXRButtonPressed(Ar); });
-		RegisterMessageHandler("XRButtonTouched", [this](FString PlayerId, FMemoryReader Ar) { HandleOnXRButtonTouched(Ar); });
-		RegisterMessageHandler("XRButtonReleased", [this](FString PlayerId, FMemoryReader Ar) { HandleOnXRButtonReleased(Ar); });
-		RegisterMessageHandler("XRAnalog", [this](FString PlayerId, FMemoryReader Ar) { HandleOnXRAnalog(Ar); });
-		RegisterMessageHandler("XRSystem", [this](FString PlayerId, FMemoryReader Ar) { HandleOnXRSystem(Ar); });
-
-		RegisterMessageHandler("Command", [this](FString PlayerId, FMemoryReader Ar) { HandleOnCommand(Ar); });
-		RegisterMessageHandler("UIInteraction", [this](FString PlayerId, FMemoryReader Ar) { HandleUIInteraction(Ar); });
-		RegisterMessageHandler("TextboxEntry", [this](FString PlayerId, FMemoryReader Ar) { HandleOnTextboxEntry(Ar); });
+		RegisterMessageHandler("KeyPress", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnKeyChar(Ar); });
+		RegisterMessageHandler("KeyUp", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnKeyUp(Ar); });
+		RegisterMessageHandler("KeyDown", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnKeyDown(Ar); });
+
+		RegisterMessageHandler("TouchStart", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnTouchStarted(Ar); });
+		RegisterMessageHandler("TouchMove", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnTouchMoved(Ar); });
+		RegisterMessageHandler("TouchEnd", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnTouchEnded(Ar); });
+
+		RegisterMessageHandler("GamepadConnected", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnControllerConnected(Ar); });
+		RegisterMessageHandler("GamepadAnalog", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnControllerAnalog(PlayerId, Ar); });
+		RegisterMessageHandler("GamepadButtonPressed", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnControllerButtonPressed(PlayerId, Ar); });
+		RegisterMessageHandler("GamepadButtonReleased", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnControllerButtonReleased(PlayerId, Ar); });
+		RegisterMessageHandler("GamepadDisconnected", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnControllerDisconnected(Ar); });
+
+		RegisterMessageHandler("MouseEnter", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseEnter(Ar); });
+		RegisterMessageHandler("MouseLeave", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseLeave(Ar); });
+		RegisterMessageHandler("MouseUp", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseUp(Ar); });
+		RegisterMessageHandler("MouseDown", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseDown(Ar); });
+		RegisterMessageHandler("MouseMove", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseMove(Ar); });
+		RegisterMessageHandler("MouseWheel", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseWheel(Ar); });
+		RegisterMessageHandler("MouseDouble", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnMouseDoubleClick(Ar); });
+
+		RegisterMessageHandler("XRHMDTransform", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnXRHMDTransform(Ar); });
+		RegisterMessageHandler("XRControllerTransform", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnXRControllerTransform(Ar); });
+		RegisterMessageHandler("XRButtonPressed", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnXRButtonPressed(Ar); });
+		RegisterMessageHandler("XRButtonTouched", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnXRButtonTouched(Ar); });
+		RegisterMessageHandler("XRButtonReleased", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnXRButtonReleased(Ar); });
+		RegisterMessageHandler("XRAnalog", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnXRAnalog(Ar); });
+		RegisterMessageHandler("XRSystem", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnXRSystem(Ar); });
+
+		RegisterMessageHandler("Command", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnCommand(Ar); });
+		RegisterMessageHandler("UIInteraction", [this](const FString& PlayerId, FMemoryReader Ar) { HandleUIInteraction(Ar); });
+		RegisterMessageHandler("TextboxEntry", [this](const FString& PlayerId, FMemoryReader Ar) { HandleOnTextboxEntry(Ar); });
 		// PluginExt: END
 		/////////////////////////////////////////////////////////////////////////////
 
@@ -194,12 +194,12 @@ namespace UE::PixelStreamingInput
 	/////////////////////////////////////////////////////////////////////////////
 	// PluginExt: START
 	// 引数に PlayerId を追加しました。
-	void FPixelStreamingInputHandler::RegisterMessageHandler(const FString& MessageType, const TFunction<void(FString, FMemoryReader)>& Handler)
+	void FPixelStreamingInputHandler::RegisterMessageHandler(const FString& MessageType, const TFunction<void(const FString&, FMemoryReader)>& Handler)
 	{
 		DispatchTable.Add(FPixelStreamingInputProtocol::ToStreamerProtocol.Find(MessageType)->GetID(), Handler);
 	}
 
-    TFunction<void(FString, FMemoryReader)> FPixelStreamingInputHandler::FindMessageHandler(const FString& MessageType)
+    TFunction<void(const FString&, FMemoryReader)> FPixelStreamingInputHandler::FindMessageHandler(const FString& MessageType)
 	{
 		return DispatchTable.FindRef(FPixelStreamingInputProtocol::ToStreamerProtocol.Find(MessageType)->GetID());
 	}
@@ -289,9 +289,15 @@ namespace UE::PixelStreamingInput
 		// 引数に PlayerId を追加しました。
 		while (Messages.Dequeue(Message))
 		{
-			FMemoryReader Ar(Message.Data);
-			(*Message.Handler)(Message.PlayerId, Ar);
+			// Handlers size what they read by the archive, so it has to hold just the payload. Copying it into
+			// a reused array leaves the message itself untouched and costs no allocation once the array has grown.
+			MessagePayload.Reset();
+			MessagePayload.Append(static_cast<const uint8*>(Message.Data.GetData()) + 1, Message.Data.GetSize() - 1);
+			FMemoryReader Ar(MessagePayload);
+			(*Message.Handler)(*Message.PlayerId, Ar);
 		}
+		// Let go of the last message rather than holding its buffer until the next tick
+		Message = FMessage();
 		// PluginExt: END
 		/////////////////////////////////////////////////////////////////////////////
 		
@@ -310,28 +316,36 @@ namespace UE::PixelStreamingInput
 	// void FPixelStreamingInputHandler::OnMessage(TArray<uint8> Buffer)
 	void FPixelStreamingInputHandler::OnMessage(FString PlayerId, TArray<uint8> Buffer)
 	{
-		uint8 MessageType = Buffer[0];
-		// Remove the message type. The remaining data in the buffer is now purely
-		// the message data
-		Buffer.RemoveAt(0);
+		OnMessage(MakeShared<const FString, ESPMode::ThreadSafe>(MoveTemp(PlayerId)), MakeSharedBufferFromArray(MoveTemp(Buffer)));
+	}
+	// PluginExt: END
+	/////////////////////////////////////////////////////////////////////////////
 
-        TFunction<void(FString, FMemoryReader)>* Handler = DispatchTable.Find(MessageType);
+	void FPixelStreamingInputHandler::OnMessage(const FPlayerIdHandle& PlayerId, FSharedBuffer Buffer)
+	{
+		if (Buffer.GetSize() == 0)
+		{
+			return;
+		}
+
+		// The type stays at the front of the buffer, Tick skips over it when handing the payload out
+		const uint8 MessageType = static_cast<const uint8*>(Buffer.GetData())[0];
+
+		TFunction<void(const FString&, FMemoryReader)>* Handler = DispatchTable.Find(MessageType);
 		if (Handler != nullptr)
 		{
 			FMessage Message = {
-				Handler, // The function to call
-				Buffer,  // The message data
-				PlayerId	// The PlayerId
+				Handler,          // The function to call
+				MoveTemp(Buffer), // The message
+				PlayerId          // The PlayerId
 			};
-			Messages.Enqueue(Message);
+			Messages.Enqueue(MoveTemp(Message));
 		}
 		else
 		{
 			UE_LOG(LogPixelStreamingInputHandler, Warning, TEXT("No handler registered for message with id %d"), MessageType);
 		}
 	}
-	// PluginExt: END
-	/////////////////////////////////////////////////////////////////////////////
 
 	void FPixelStreamingInputHandler::SetTargetWindow(TWeakPtr<SWindow> InWindow)
 	{
@@ -618,7 +632,7 @@ namespace UE::PixelStreamingInput
 	/////////////////////////////////////////////////////////////////////////////
 	// PluginExt: START
 	// 引数に PlayerId を追加しました。
-	void FPixelStreamingInputHandler::HandleOnControllerAnalog(FString PlayerId, FMemoryReader Ar)
+	void FPixelStreamingInputHandler::HandleOnControllerAnalog(const FString& PlayerId, FMemoryReader Ar)
 	{
 		const TPayloadThreeParam<uint8, uint8, double> Payload(Ar);
 		const FInputDeviceId ControllerId = FInputDeviceId::CreateFromInternalId((int32)FCString::Atoi(*PlayerId));
@@ -627,7 +641,7 @@ namespace UE::PixelStreamingInput
 		AnalogEventsReceivedThisTick.FindOrAdd(ControllerId).FindOrAdd(Payload.Param2) = Payload.Param3;
 	}
 
-	void FPixelStreamingInputHandler::HandleOnControllerButtonPressed(FString PlayerId, FMemoryReader Ar)
+	void FPixelStreamingInputHandler::HandleOnControllerButtonPressed(const FString& PlayerId, FMemoryReader Ar)
 	{
 		TPayloadThreeParam<uint8, uint8, uint8> Payload(Ar);
 		FKey* ButtonPtr = FPixelStreamingInputConverter::GamepadInputToFKey.Find(MakeTuple(Payload.Param2, Action::Click));
@@ -656,7 +670,7 @@ namespace UE::PixelStreamingInput
 		UE_LOG(LogPixelStreamingInputHandler, Verbose, TEXT("GAMEPAD_PRESSED: ControllerId = %d; KeyName = %s; IsRepeat = %s;"), ControllerId.GetId(), *ButtonPtr->ToString(), bIsRepeat ? TEXT("True") : TEXT("False"));
 	}
 
-	void FPixelStreamingInputHandler::HandleOnControllerButtonReleased(FString PlayerId, FMemoryReader Ar)
+	void FPixelStreamingInputHandler::HandleOnControllerButtonReleased(const FString& PlayerId, FMemoryReader Ar)
 	{
 		TPayloadTwoParam<uint8, uint8> Payload(Ar);
 		FKey* ButtonPtr = FPixelStreamingInputConverter::GamepadInputToFKey.Find(MakeTuple(Payload.Param2, Action::Click));
@@ -1502,7 +1516,7 @@ namespace UE::PixelStreamingInput
 	// PluginExt: START
 	void FPixelStreamingInputHandler::ResetBroadcastTouchMoveList()
 	{
-		TFunction<void(FString, FMemoryReader)>* Handler = DispatchTable.Find(FPixelStreamingInputProtocol::ToStreamerProtocol.Find("ResetBroadcastTouchMoveList")->GetID());
+		TFunction<void(const FString&, FMemoryReader)>* Handler = DispatchTable.Find(FPixelStreamingInputProtocol::ToStreamerProtocol.Find("ResetBroadcastTouchMoveList")->GetID());
 		if (Handler != nullptr)
 		{
 			TArray<uint8> Buffer = {0};
@@ -1513,7 +1527,7 @@ namespace UE::PixelStreamingInput
 
 	void FPixelStreamingInputHandler::BroadcastTouchMoveList()
 	{
-		TFunction<void(FString, FMemoryReader)>* Handler = DispatchTable.Find(FPixelStreamingInputProtocol::ToStreamerProtocol.Find("BroadcastTouchMoveList")->GetID());
+		TFunction<void(const FString&, FMemoryReader)>* Handler = DispatchTable.Find(FPixelStreamingInputProtocol::ToStreamerProtocol.Find("BroadcastTouchMoveList")->GetID());
 		if (Handler != nullptr)
 		{
 			TArray<uint8> Buffer = {0};
@@ -47,6 +47,7 @@ namespace UE::PixelStreamingInput
 		// virtual void OnMessage(TArray<uint8> Buffer) override;
 		// PluginExt: END
 		/////////////////////////////////////////////////////////////////////////////
+		virtual void OnMessage(const FPlayerIdHandle& PlayerId, FSharedBuffer Buffer) override;
 		virtual void SetTargetWindow(TWeakPtr<SWindow> InWindow) override;
 		virtual TWeakPtr<SWindow> GetTargetWindow() override;
 		virtual void SetTargetViewport(TWeakPtr<SViewport> InViewport) override;
@@ -60,8 +61,8 @@ namespace UE::PixelStreamingInput
 		/////////////////////////////////////////////////////////////////////////////
 		// PluginExt: START
 		// 引数に PlayerId を追加しました。
-		virtual void RegisterMessageHandler(const FString& MessageType, const TFunction<void(FString, FMemoryReader)>& Handler) override;
-		virtual TFunction<void(FString, FMemoryReader)> FindMessageHandler(const FString& MessageType) override;
+		virtual void RegisterMessageHandler(const FString& MessageType, const TFunction<void(const FString&, FMemoryReader)>& Handler) override;
+		virtual TFunction<void(const FString&, FMemoryReader)> FindMessageHandler(const FString& MessageType) override;
 		// PluginExt: END
 		/////////////////////////////////////////////////////////////////////////////
 		virtual void SetInputType(EPixelStreamingInputType InInputType) override { InputType = InInputType; };
@@ -93,9 +94,9 @@ namespace UE::PixelStreamingInput
 		/////////////////////////////////////////////////////////////////////////////
 		// PluginExt: START
 		// 引数に PlayerId を追加しました。
-		virtual void HandleOnControllerAnalog(FString PlayerId, FMemoryReader Ar);
-		virtual void HandleOnControllerButtonPressed(FString PlayerId, FMemoryReader Ar);
-		virtual void HandleOnControllerButtonReleased(FString PlayerId, FMemoryReader Ar);
+		virtual void HandleOnControllerAnalog(const FString& PlayerId, FMemoryReader Ar);
+		virtual void HandleOnControllerButtonPressed(const FString& PlayerId, FMemoryReader Ar);
+		virtual void HandleOnControllerButtonReleased(const FString& PlayerId, FMemoryReader Ar);
 		// virtual void HandleOnControllerAnalog(FMemoryReader Ar);
 		// virtual void HandleOnControllerButtonPressed(FMemoryReader Ar);
 		// virtual void HandleOnControllerButtonReleased(FMemoryReader Ar);
@@ -197,9 +198,9 @@ namespace UE::PixelStreamingInput
 		// PlayerID をメッセージに追加しました。
 		struct FMessage
 		{
-			TFunction<void(FString, FMemoryReader)>* Handler;
-			TArray<uint8> Data;
-			FString PlayerId;
+			TFunction<void(const FString&, FMemoryReader)>* Handler;
+			FSharedBuffer Data; // The whole message, type included
+			TSharedPtr<const FString, ESPMode::ThreadSafe> PlayerId;
 		};
 		// PluginExt: END
 		/////////////////////////////////////////////////////////////////////////////
@@ -211,12 +212,13 @@ namespace UE::PixelStreamingInput
 		uint8 NumActiveTouches;
 		bool bIsMouseActive;
 		TQueue<FMessage> Messages;
+		TArray<uint8> MessagePayload; // Reused by Tick to give each handler the payload of its message
 		EPixelStreamingInputType InputType = EPixelStreamingInputType::RouteToWindow;
 		FVector2D LastTouchLocation = FVector2D(EForceInit::ForceInitToZero);
 		/////////////////////////////////////////////////////////////////////////////
 		// PluginExt: START
 		// Handler に PlayerId に追加しました。
-		TMap<uint8, TFunction<void(FString, FMemoryReader)>> DispatchTable;
+		TMap<uint8, TFunction<void(const FString&, FMemoryReader)>> DispatchTable;
 		// PluginExt: END
 		/////////////////////////////////////////////////////////////////////////////
 
@@ -10,7 +10,7 @@ FInputProtocolMap FPixelStreamingInputProtocol::FromStreamerProtocol;
 TSharedPtr<FJsonObject> FPixelStreamingInputProtocol::ToJson(EPixelStreamingMessageDirection Direction)
 {
 	TSharedPtr<FJsonObject> ProtocolJson = MakeShareable(new FJsonObject());
-	FInputProtocolMap MessageProtocol =
+	FInputProtocolMap& MessageProtocol =
 		(Direction == EPixelStreamingMessageDirection::ToStreamer)
 		? FPixelStreamingInputProtocol::ToStreamerProtocol
 		: FPixelStreamingInputProtocol::FromStreamerProtocol;
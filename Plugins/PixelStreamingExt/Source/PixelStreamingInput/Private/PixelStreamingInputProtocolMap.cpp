@@ -6,13 +6,17 @@
 FPixelStreamingInputMessage& FInputProtocolMap::Add(FString Key, const FPixelStreamingInputMessage& Value)
 {
 	IPixelStreamingInputModule::Get().OnProtocolUpdated.Broadcast();
-	return InnerMap.Add(Key, Value);
+	FPixelStreamingInputMessage& Message = InnerMap.Add(Key, Value);
+	BumpVersion();
+	return Message;
 }
 
 int FInputProtocolMap::Remove(FString Key)
 {
 	IPixelStreamingInputModule::Get().OnProtocolUpdated.Broadcast();
-	return InnerMap.Remove(Key);
+	const int NumRemoved = InnerMap.Remove(Key);
+	BumpVersion();
+	return NumRemoved;
 }
 
 FPixelStreamingInputMessage& FInputProtocolMap::GetOrAdd(FString Key)
@@ -23,7 +27,9 @@ FPixelStreamingInputMessage& FInputProtocolMap::GetOrAdd(FString Key)
 	}
 
 	IPixelStreamingInputModule::Get().OnProtocolUpdated.Broadcast();
-	return InnerMap.Add(Key);
+	FPixelStreamingInputMessage& Message = InnerMap.Add(Key);
+	BumpVersion();
+	return Message;
 }
 
 FPixelStreamingInputMessage* FInputProtocolMap::Find(FString Key)
@@ -40,6 +46,7 @@ void FInputProtocolMap::Clear()
 {
 	IPixelStreamingInputModule::Get().OnProtocolUpdated.Broadcast();
 	InnerMap.Empty();
+	BumpVersion();
 }
 
 bool FInputProtocolMap::IsEmpty() const
@@ -54,3 +61,39 @@ void FInputProtocolMap::Apply(const TFunction<void(FString, FPixelStreamingInput
 		Visitor(Key, Value);
 	}
 }
+
+FInputProtocolMessageHandle::FInputProtocolMessageHandle(const FInputProtocolMap& InProtocol, FString InKey)
+	: Protocol(InProtocol)
+	, Key(MoveTemp(InKey))
+{
+}
+
+bool FInputProtocolMessageHandle::IsValid() const
+{
+	return (Resolve() & FoundFlag) != 0;
+}
+
+uint8 FInputProtocolMessageHandle::GetID() const
+{
+	const uint64 Value = Resolve();
+	checkf((Value & FoundFlag) != 0, TEXT("Message %s is not in the protocol"), *Key);
+	return static_cast<uint8>(Value);
+}
+
+uint64 FInputProtocolMessageHandle::Resolve() const
+{
+	// Read the version before looking anything up, so a change made meanwhile leaves this stale rather than wrong
+	const uint32 Version = Protocol.GetVersion();
+
+	uint64 Value = Resolved.load(std::memory_order_acquire);
+	if (static_cast<uint32>(Value >> 32) == Version)
+	{
+		return Value;
+	}
+
+	const FPixelStreamingInputMessage* Message = Protocol.Find(Key);
+	Value = (static_cast<uint64>(Version) << 32) | (Message != nullptr ? FoundFlag | Message->GetID() : 0);
+	Resolved.store(Value, std::memory_order_release);
+
+	return Value;
+}
@@ -8,6 +8,7 @@
 #include "Widgets/SWindow.h"
 #include "Templates/SharedPointer.h"
 #include "Serialization/MemoryReader.h"
+#include "Memory/SharedBuffer.h"
 #include "PixelStreamingInputEnums.h"
 
 /**
@@ -18,6 +19,9 @@
 class PIXELSTREAMINGINPUT_API IPixelStreamingInputHandler : public IInputDevice
 {
 public:
+	/** A player id made once per player and shared by every message from them, so queueing a message never copies the id. */
+	using FPlayerIdHandle = TSharedRef<const FString, ESPMode::ThreadSafe>;
+
 	//////////////////////////////////////////////////////////////////////////////
 	// PluginExt: START
 	// 引数に PlayerId を引数に追加しました。
@@ -30,6 +34,17 @@ public:
 	// PluginExt: END
 	//////////////////////////////////////////////////////////////////////////////
 
+	/**
+	 * @brief Handle the message from the WebRTC data channel without copying it.
+	 * @param PlayerId The player the message came from
+	 * @param Buffer The data channel message, starting with its message type. Handlers may hold on to it until the message is dispatched.
+	 */
+	virtual void OnMessage(const FPlayerIdHandle& PlayerId, FSharedBuffer Buffer)
+	{
+		const uint8* Data = static_cast<const uint8*>(Buffer.GetData());
+		OnMessage(*PlayerId, TArray<uint8>(Data, Buffer.GetSize()));
+	}
+
 	/**
 	 * @brief Set the viewport this input device is associated with.
 	 * @param InTargetViewport The viewport to set
@@ -98,7 +113,7 @@ public:
 	 * @param MessageType The human readable identifier for the message
 	 * @param Handler The function called when this message type is received. This handler must take a single parameter (an FMemoryReader) and have a return type of void
 	 */
-	virtual void RegisterMessageHandler(const FString& MessageType, const TFunction<void(FString, FMemoryReader)>& Handler) = 0;
+	virtual void RegisterMessageHandler(const FString& MessageType, const TFunction<void(const FString&, FMemoryReader)>& Handler) = 0;
 	// virtual void RegisterMessageHandler(const FString& MessageType, const TFunction<void(FMemoryReader)>& Handler) = 0;
 	// PluginExt: END
 	//////////////////////////////////////////////////////////////////////////////
@@ -118,7 +133,7 @@ public:
 	//////////////////////////////////////////////////////////////////////////////
 	// PluginExt: START
 	// Handler の引数に PlayerId を引数に追加しました。
-	virtual TFunction<void(FString, FMemoryReader)> FindMessageHandler(const FString& MessageType) = 0;
+	virtual TFunction<void(const FString&, FMemoryReader)> FindMessageHandler(const FString& MessageType) = 0;
 	// virtual TFunction<void(FMemoryReader)> FindMessageHandler(const FString& MessageType) = 0;
 	// PluginExt: END
 	//////////////////////////////////////////////////////////////////////////////
@@ -6,6 +6,8 @@
 #include "Misc/ScopeLock.h"
 #include "PixelStreamingInputMessage.h"
 
+#include <atomic>
+
 /**
  * @brief An map type that broadcasts the OnProtocolUpdated whenever
  * it's inner map is updated
@@ -24,6 +26,51 @@ public:
 
 	void Apply(const TFunction<void(FString, FPixelStreamingInputMessage)>& Visitor);
 
+	/**
+	 * @brief Bumped whenever the map is changed, so anything that has looked
+	 * a message up can tell when it needs to look it up again
+	 */
+	uint32 GetVersion() const { return Version.load(std::memory_order_acquire); }
+
 private:
+	void BumpVersion() { Version.fetch_add(1, std::memory_order_acq_rel); }
+
 	TMap<FString, FPixelStreamingInputMessage> InnerMap;
+
+	// Starts at 1 so a handle that has never resolved can never match
+	std::atomic<uint32> Version = 1;
+};
+
+/**
+ * @brief A message in a protocol map registered once by name and resolved to
+ * its id, so sending it costs no string allocation or hashing. The id is only
+ * looked up again when the protocol has changed since it was last resolved.
+ */
+class PIXELSTREAMINGINPUT_API FInputProtocolMessageHandle
+{
+public:
+	FInputProtocolMessageHandle(const FInputProtocolMap& InProtocol, FString InKey);
+
+	/**
+	 * @return Whether the message is currently in the protocol
+	 */
+	bool IsValid() const;
+
+	/**
+	 * @return The id of the message, which must currently be in the protocol
+	 */
+	uint8 GetID() const;
+
+	const FString& GetKey() const { return Key; }
+
+private:
+	// The version the id was resolved at in the upper half, whether the message was found and its id in the lower
+	uint64 Resolve() const;
+
+	static constexpr uint64 FoundFlag = 1 << 8;
+
+	const FInputProtocolMap& Protocol;
+	const FString Key;
+
+	mutable std::atomic<uint64> Resolved = 0;
 };